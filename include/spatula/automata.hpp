@@ -0,0 +1,258 @@
+#pragma once
+
+// type constraints
+#include <type_traits>
+#include <concepts>
+#include "spatula/directions.hpp"
+#include "spatula/execution.hpp"
+
+// data types and algorithms
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <bit>
+#include <utility>
+#include <string_view>
+#include <algorithm>
+#include <execution>
+#include "spatula/bit_grids.hpp"
+
+namespace sp {
+
+/** An outer totalistic cellular automaton rule, such as Conway's B3/S23.
+ *
+ * Bit k of birth is set when a dead cell with k live neighbours comes alive,
+ * and bit k of survive is set when a live cell with k live neighbours lives on.
+ */
+struct life_rule {
+    std::uint16_t birth = 0;
+    std::uint16_t survive = 0;
+    friend constexpr bool operator==(life_rule const &,
+                                     life_rule const &) = default;
+};
+
+/** Read a rule written in B/S notation, like "B3/S23" for Conway's life.
+ *
+ * Digits after a B are birth counts and digits after an S are survival counts.
+ * Letters are case-insensitive, and any other characters are ignored.
+ */
+constexpr life_rule life_like_rule(std::string_view notation)
+{
+    life_rule rule;
+    std::uint16_t * counts = nullptr;
+    for (char const c : notation) {
+        if (c == 'B' or c == 'b') { counts = &rule.birth; }
+        else if (c == 'S' or c == 's') { counts = &rule.survive; }
+        else if (counts and c >= '0' and c <= '8') {
+            *counts = static_cast<std::uint16_t>(*counts | (1u << (c - '0')));
+        }
+    }
+    return rule;
+}
+
+/** A totalistic rule, which only looks at the live cells in a neighbourhood.
+ *
+ * Bit k of sums is set when a cell is alive in the next generation whenever k
+ * cells are alive among itself and its neighbours.
+ */
+constexpr life_rule totalistic_rule(std::uint16_t sums)
+{
+    return life_rule{static_cast<std::uint16_t>(sums & 0x1ff),
+                     static_cast<std::uint16_t>((sums >> 1) & 0x1ff)};
+}
+
+namespace detail {
+using automaton_word = bit_grid::word_type;
+
+/** Live neighbour counts of 64 cells at once, as bit planes.
+ *
+ * Bit i of plane p is binary digit p of the count for cell i, so adding a word
+ * of neighbours ripples through a chain of bitwise half adders.
+ */
+template<std::size_t Planes>
+struct bit_counter {
+    std::array<automaton_word, Planes> planes{};
+
+    void add(automaton_word bits)
+    {
+        for (std::size_t p = 0; p < planes.size(); ++p) {
+            auto const carry = planes[p] & bits;
+            planes[p] ^= bits;
+            bits = carry;
+        }
+    }
+
+    /** The cells whose count is exactly k. */
+    automaton_word equals(unsigned k) const
+    {
+        auto match = ~automaton_word{0};
+        for (std::size_t p = 0; p < planes.size(); ++p) {
+            auto const digit = automaton_word{0} - ((k >> p) & 1u);
+            match &= ~(planes[p] ^ digit);
+        }
+        return match;
+    }
+};
+
+/** The words either side of the current word in one row. */
+struct word_window {
+    automaton_word previous, current, next;
+
+    /** The row shifted so that each bit holds its neighbour at dx. */
+    template<int dx>
+    automaton_word shifted() const
+    {
+        if constexpr (dx < 0) { return (current << 1) | (previous >> 63); }
+        else if constexpr (dx > 0) { return (current >> 1) | (next << 63); }
+        else { return current; }
+    }
+};
+
+/** Advance the words [first_word, last_word) of rows [first_row, last_row)
+ * by one generation. */
+template<adjacent_direction Enum>
+void step_automaton_tile(bit_grid const & from, bit_grid & to,
+                         life_rule const & rule, bool outside,
+                         std::size_t first_row, std::size_t last_row,
+                         std::size_t first_word, std::size_t last_word)
+{
+    constexpr auto const & offsets = direction_table<Enum>::offsets;
+    constexpr unsigned max_count = enum_size_v<Enum>;
+    constexpr std::size_t planes = std::bit_width(max_count);
+
+    std::array<automaton_word, max_count + 1> born, kept;
+    for (unsigned k = 0; k <= max_count; ++k) {
+        born[k] = automaton_word{0} - ((rule.birth >> k) & 1u);
+        kept[k] = automaton_word{0} - ((rule.survive >> k) & 1u);
+    }
+
+    // the next generation of one word, from the rows around it
+    auto const next_word = [&](word_window const & above,
+                               word_window const & middle,
+                               word_window const & below) {
+        std::array<word_window const *, 3> const rows{&above, &middle, &below};
+        bit_counter<planes> counter;
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            (counter.add(rows[offsets[I][1] + 1]
+                             ->template shifted<offsets[I][0]>()), ...);
+        }(std::make_index_sequence<offsets.size()>{});
+
+        // every count is tested so the loop unrolls without branches
+        auto const alive = middle.current;
+        automaton_word next = 0;
+        for (unsigned k = 0; k <= max_count; ++k) {
+            next |= counter.equals(k) &
+                    ((alive & kept[k]) | (~alive & born[k]));
+        }
+        return next;
+    };
+
+    auto const words = static_cast<std::ptrdiff_t>(from.words_per_row());
+    auto const height = static_cast<std::ptrdiff_t>(from.height());
+    auto const last_mask = from.last_word_mask();
+    auto const fill = outside ? ~automaton_word{0} : automaton_word{0};
+    auto const padding = fill & ~last_mask;
+    auto const first = static_cast<std::ptrdiff_t>(first_word);
+    auto const last = static_cast<std::ptrdiff_t>(last_word);
+
+    for (auto y = static_cast<std::ptrdiff_t>(first_row);
+              y < static_cast<std::ptrdiff_t>(last_row); ++y) {
+        std::array<automaton_word const *, 3> rows{};
+        for (std::ptrdiff_t dy = -1; dy <= 1; ++dy) {
+            if (y + dy >= 0 and y + dy < height) {
+                rows[dy + 1] = from.data() + (y + dy) * words;
+            }
+        }
+        auto * const out = to.data() + y * words;
+
+        // words on the edges of the grid read the outside fill past them
+        auto const load = [&](std::size_t r, std::ptrdiff_t w) {
+            if (not rows[r] or w < 0 or w >= words) { return fill; }
+            return w == words - 1 ? rows[r][w] | padding : rows[r][w];
+        };
+        auto const window = [&](std::size_t r, std::ptrdiff_t w) {
+            return word_window{load(r, w - 1), load(r, w), load(r, w + 1)};
+        };
+        auto const step_edge = [&](std::ptrdiff_t w) {
+            auto const next = next_word(window(0, w), window(1, w),
+                                        window(2, w));
+            out[w] = w == words - 1 ? next & last_mask : next;
+        };
+
+        // words inside the grid read their neighbours without edge checks
+        bool const inner_row = rows[0] and rows[2];
+        auto const inner_first =
+            inner_row ? std::max<std::ptrdiff_t>(first, 1) : last;
+        auto const inner_last =
+            std::max(inner_first, std::min<std::ptrdiff_t>(last, words - 1));
+
+        for (auto w = first; w < inner_first; ++w) { step_edge(w); }
+        auto const * above = rows[0];
+        auto const * middle = rows[1];
+        auto const * below = rows[2];
+        for (auto w = inner_first; w < inner_last; ++w) {
+            out[w] = next_word(
+                word_window{above[w - 1], above[w], above[w + 1]},
+                word_window{middle[w - 1], middle[w], middle[w + 1]},
+                word_window{below[w - 1], below[w], below[w + 1]});
+        }
+        for (auto w = inner_last; w < last; ++w) { step_edge(w); }
+    }
+}
+}
+
+/** Advance a cellular automaton on a bit-packed grid.
+ *
+ * A cell's neighbourhood is given by a direction set, so cardinal directions
+ * give the von Neumann neighbourhood, octile directions the Moore neighbourhood
+ * and hex directions the six neighbours of an axial (q, r) hex, with r stored
+ * as the row. Neighbour counts are summed 64 cells at a time with bitwise
+ * adders over shifted words, so no cell is visited on its own.
+ *
+ * Each generation is split into tiles of rows and words that run under the
+ * execution policy. Tiles read the previous generation, including the halo of
+ * cells around them, from a separate buffer, so they never wait on each other.
+ *
+ * Parameters
+ *   policy - the execution policy to schedule tiles with
+ *   cells - the live cells, which are advanced in place
+ *   rule - which cells are born and which survive
+ *   generations - the number of generations to advance
+ *   outside - whether cells past the edge of the grid count as alive
+ */
+template<adjacent_direction Enum, execution_policy Policy>
+void step_automaton(Policy && policy, bit_grid & cells,
+                    life_rule const & rule, std::size_t generations = 1,
+                    bool outside = false)
+{
+    constexpr std::size_t tile_rows = 64;
+    constexpr std::size_t tile_words = 16;
+    if (cells.empty() or generations == 0) { return; }
+
+    auto const row_tiles = (cells.height() + tile_rows - 1) / tile_rows;
+    auto const word_tiles =
+        (cells.words_per_row() + tile_words - 1) / tile_words;
+    bit_grid next(cells.width(), cells.height());
+
+    for (std::size_t generation = 0; generation < generations; ++generation) {
+        for_each_index(policy, row_tiles * word_tiles, [&](std::size_t tile) {
+            auto const first_row = (tile / word_tiles) * tile_rows;
+            auto const first_word = (tile % word_tiles) * tile_words;
+            detail::step_automaton_tile<Enum>(
+                cells, next, rule, outside,
+                first_row, std::min(cells.height(), first_row + tile_rows),
+                first_word,
+                std::min(cells.words_per_row(), first_word + tile_words));
+        });
+        std::swap(cells, next);
+    }
+}
+
+template<adjacent_direction Enum>
+void step_automaton(bit_grid & cells, life_rule const & rule,
+                    std::size_t generations = 1, bool outside = false)
+{
+    step_automaton<Enum>(std::execution::seq, cells, rule, generations,
+                         outside);
+}
+}
@@ -0,0 +1,190 @@
+#pragma once
+
+// type constraints
+#include <type_traits>
+#include <concepts>
+#include "spatula/directions.hpp"
+#include "spatula/execution.hpp"
+
+// data types and algorithms
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <execution>
+#include "spatula/grids.hpp"
+#include "spatula/direction_sets.hpp"
+
+namespace sp {
+
+/** Find which neighbours of every cell on a grid are occupied.
+ *
+ * Bit i of a cell's mask is set when the neighbour in direction i is occupied,
+ * meaning it holds a value other than T{}. Neighbours follow the direction
+ * tables, so cardinal::north is the cell at y + 1, and hex grids are indexed by
+ * their axial (q, r) coordinates.
+ *
+ * Rows are processed in parallel bands. Each band copies its occupancy, and a
+ * row either side, into padded rows of 0 or 1 bytes. Every mask in a row is
+ * then gathered in a single pass that ORs in the byte for each direction at a
+ * constant offset from the cell.
+ *
+ * Parameters
+ *   policy - the execution policy to schedule bands of rows with
+ *   occupancy - the grid to find neighbours on
+ *   outside - whether cells past the edge of the grid count as occupied
+ */
+template<adjacent_direction Enum, execution_policy Policy, class T>
+grid<direction_set<Enum>> neighbour_masks(Policy && policy,
+                                          grid<T> const & occupancy,
+                                          bool outside = false)
+{
+    using bits_type = typename direction_set<Enum>::bits_type;
+    constexpr auto const & offsets = direction_table<Enum>::offsets;
+    constexpr std::size_t band_height = 64;
+
+    auto const width = occupancy.width();
+    auto const height = occupancy.height();
+    grid<direction_set<Enum>> masks(width, height);
+    auto const bands = (height + band_height - 1) / band_height;
+
+    for_each_index(std::forward<Policy>(policy), bands, [&](std::size_t band) {
+        // byte stores may alias anything, so keep the loop bounds local
+        std::size_t const columns = width;
+        auto const first = band * band_height;
+        auto const last = std::min(height, first + band_height);
+
+        // the band's rows and the rows either side of it, as 0 or 1, with a
+        // cell of padding around the edges
+        auto const stride = columns + 2;
+        std::vector<bits_type> padded((last - first + 2) * stride,
+                                      static_cast<bits_type>(outside));
+        for (std::size_t y = first; y < last + 2; ++y) {
+            auto const ny = static_cast<std::ptrdiff_t>(y) - 1;
+            if (ny < 0 or ny >= static_cast<std::ptrdiff_t>(height)) {
+                continue;
+            }
+            auto const cells = occupancy.row(static_cast<std::size_t>(ny));
+            bits_type * row = padded.data() + (y - first) * stride + 1;
+            for (std::size_t x = 0; x < columns; ++x) {
+                row[x] = static_cast<bits_type>(cells[x] != T{});
+            }
+        }
+
+        std::vector<bits_type> bits(columns);
+        for (std::size_t y = first; y < last; ++y) {
+            auto const row = static_cast<std::ptrdiff_t>(y - first + 1);
+            auto const pitch = static_cast<std::ptrdiff_t>(stride);
+            bits_type const * center = padded.data() + row * pitch + 1;
+            bits_type * out = bits.data();
+
+            // every direction is unrolled, so each shift is a constant
+            auto const gather = [=]<std::size_t... I>(
+                std::index_sequence<I...>) {
+                for (std::size_t x = 0; x < columns; ++x) {
+                    auto const i = static_cast<std::ptrdiff_t>(x);
+                    out[x] = static_cast<bits_type>(
+                        ((center[i + offsets[I][1] * pitch + offsets[I][0]]
+                          << I) | ...));
+                }
+            };
+            gather(std::make_index_sequence<offsets.size()>{});
+            std::ranges::transform(bits, masks.row(y).begin(),
+                                   direction_set<Enum>::from_bits);
+        }
+    });
+    return masks;
+}
+
+template<adjacent_direction Enum, class T>
+grid<direction_set<Enum>> neighbour_masks(grid<T> const & occupancy,
+                                          bool outside = false)
+{
+    return neighbour_masks<Enum>(std::execution::seq, occupancy, outside);
+}
+
+namespace detail {
+/** Drop the diagonal bits of an octile mask that aren't backed by both of
+ * their cardinal neighbours. */
+constexpr std::uint8_t reduce_blob_mask(std::uint8_t mask)
+{
+    using enum octile::direction_name;
+    auto const has = [mask](octile::direction_name dir) {
+        return (mask >> dir) & 1u;
+    };
+    std::uint8_t reduced = mask;
+    auto const drop_unless = [&](octile::direction_name corner,
+                                 octile::direction_name a,
+                                 octile::direction_name b) {
+        if (not (has(a) and has(b))) {
+            reduced = static_cast<std::uint8_t>(reduced & ~(1u << corner));
+        }
+    };
+    drop_unless(northeast, north, east);
+    drop_unless(southeast, south, east);
+    drop_unless(southwest, south, west);
+    drop_unless(northwest, north, west);
+    return reduced;
+}
+}
+
+/** The 47 distinct octile masks of a blob tileset, in ascending order.
+ *
+ * A diagonal neighbour only changes how a blob tile looks when both of the
+ * cardinal neighbours beside it are also occupied, which leaves 47 tiles.
+ */
+inline constexpr auto blob_tile_masks = [] {
+    std::array<std::uint8_t, 47> masks{};
+    std::size_t count = 0;
+    for (unsigned mask = 0; mask < 256; ++mask) {
+        auto const byte = static_cast<std::uint8_t>(mask);
+        if (detail::reduce_blob_mask(byte) == byte) { masks[count++] = byte; }
+    }
+    return masks;
+}();
+
+/** The blob tile index, from 0 to 46, of every octile neighbour mask. */
+inline constexpr auto blob_tile_table = [] {
+    std::array<std::uint8_t, 256> table{};
+    for (unsigned mask = 0; mask < 256; ++mask) {
+        auto const reduced =
+            detail::reduce_blob_mask(static_cast<std::uint8_t>(mask));
+        auto const found = std::ranges::find(blob_tile_masks, reduced);
+        table[mask] =
+            static_cast<std::uint8_t>(found - blob_tile_masks.begin());
+    }
+    return table;
+}();
+
+/** The blob tile index of an octile neighbour mask. */
+constexpr std::uint8_t blob_tile(direction_set<octile::direction_name> mask)
+{
+    return blob_tile_table[mask.bits()];
+}
+
+/** Look up the tile of every cell's neighbour mask in a table.
+ *
+ * Parameters
+ *   policy - the execution policy to map cells with
+ *   masks - the neighbour masks of each cell
+ *   table - the tile of every possible mask, such as blob_tile_table
+ */
+template<execution_policy Policy, ranged_enum Enum, class Tile,
+         std::size_t N>
+    requires (N >= (std::size_t{1} << enum_size_v<Enum>)) and
+             (not std::same_as<Tile, bool>)
+grid<Tile> map_tiles(Policy && policy,
+                     grid<direction_set<Enum>> const & masks,
+                     std::array<Tile, N> const & table)
+{
+    grid<Tile> tiles(masks.width(), masks.height());
+    std::transform(std::forward<Policy>(policy),
+                   masks.begin(), masks.end(), tiles.begin(),
+                   [&table](direction_set<Enum> mask) {
+                       return table[mask.bits()];
+                   });
+    return tiles;
+}
+}
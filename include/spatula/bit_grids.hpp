@@ -0,0 +1,186 @@
+#pragma once
+
+// type constraints
+#include <type_traits>
+#include <concepts>
+#include "spatula/vectors.hpp"
+
+// data types and data structures
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <span>
+#include <bit>
+#include <algorithm>
+#include <numeric>
+#include <functional>
+#include "spatula/grids.hpp"
+
+namespace sp {
+
+/** A dense two-dimensional array of bits, packed 64 cells to a word.
+ *
+ * Each row starts on a fresh word, and bit i of word w in a row holds the cell
+ * at x = 64 * w + i. Bits past the width of the grid in the last word of each
+ * row are always clear, so rows can be combined and counted word by word.
+ */
+class bit_grid {
+public:
+    using word_type = std::uint64_t;
+    using size_type = std::size_t;
+    static constexpr size_type word_bits = 64;
+
+    bit_grid() = default;
+    bit_grid(size_type width, size_type height, bool value = false)
+        : _width{width}, _height{height},
+          _words_per_row{(width + word_bits - 1) / word_bits},
+          _words(_words_per_row * height, value ? ~word_type{0} : 0)
+    {
+        if (value) { clear_padding(); }
+    }
+
+    /** Pack a grid, setting the cells that hold anything other than T{}. */
+    template<class T>
+    explicit bit_grid(grid<T> const & cells)
+        : bit_grid(cells, [](T const & cell) { return cell != T{}; })
+    {
+    }
+
+    /** Pack a grid, setting the cells that satisfy a predicate.
+     *
+     * Packing a grid once, such as the opaque cells of a map each tick, lets
+     * many queries read 64 cells to a word rather than the grid itself.
+     */
+    template<class T, std::predicate<T const &> Predicate>
+    bit_grid(grid<T> const & cells, Predicate predicate)
+        : bit_grid(cells.width(), cells.height())
+    {
+        for (size_type y = 0; y < _height; ++y) {
+            auto const cell_row = cells.row(y);
+            auto const words = row(y);
+            for (size_type x = 0; x < _width; ++x) {
+                auto const bit = predicate(cell_row[x]) ? word_type{1} : 0;
+                words[x / word_bits] |= bit << (x % word_bits);
+            }
+        }
+    }
+
+    size_type width() const { return _width; }
+    size_type height() const { return _height; }
+    size_type size() const { return _width * _height; }
+    bool empty() const { return size() == 0; }
+    size_type words_per_row() const { return _words_per_row; }
+
+    word_type * data() { return _words.data(); }
+    word_type const * data() const { return _words.data(); }
+
+    /** Determine if a coordinate lies within the grid. */
+    bool contains(int x, int y) const
+    {
+        return x >= 0 and y >= 0 and
+               static_cast<size_type>(x) < _width and
+               static_cast<size_type>(y) < _height;
+    }
+    template<grid_coordinate Vector>
+    bool contains(Vector const & cell) const
+    {
+        return contains(static_cast<int>(get_x(cell)),
+                        static_cast<int>(get_y(cell)));
+    }
+
+    /** Determine if the cell at (x, y) is set. */
+    bool test(int x, int y) const
+    {
+        return (word_at(x, y) >> bit_of(x)) & 1u;
+    }
+    template<grid_coordinate Vector>
+    bool test(Vector const & cell) const
+    {
+        return test(static_cast<int>(get_x(cell)),
+                    static_cast<int>(get_y(cell)));
+    }
+
+    /** Set or clear the cell at (x, y). */
+    void set(int x, int y, bool value = true)
+    {
+        auto const bit = word_type{1} << bit_of(x);
+        auto & word = word_at(x, y);
+        word = value ? word | bit : word & ~bit;
+    }
+    template<grid_coordinate Vector>
+    void set(Vector const & cell, bool value = true)
+    {
+        set(static_cast<int>(get_x(cell)), static_cast<int>(get_y(cell)),
+            value);
+    }
+    void reset(int x, int y) { set(x, y, false); }
+
+    /** The words of a single row. */
+    std::span<word_type> row(size_type y)
+    {
+        return std::span<word_type>{_words.data() + y * _words_per_row,
+                                    _words_per_row};
+    }
+    std::span<word_type const> row(size_type y) const
+    {
+        return std::span<word_type const>{_words.data() + y * _words_per_row,
+                                          _words_per_row};
+    }
+
+    /** The mask of bits in the last word of a row that lie within the grid. */
+    word_type last_word_mask() const
+    {
+        auto const used = _width % word_bits;
+        return used == 0 ? ~word_type{0} : (word_type{1} << used) - 1;
+    }
+
+    /** The number of set cells. */
+    size_type count() const
+    {
+        return std::transform_reduce(
+            _words.begin(), _words.end(), size_type{0}, std::plus<>{},
+            [](word_type word) {
+                return static_cast<size_type>(std::popcount(word));
+            });
+    }
+
+    void fill(bool value)
+    {
+        std::ranges::fill(_words, value ? ~word_type{0} : 0);
+        if (value) { clear_padding(); }
+    }
+
+    friend bool operator==(bit_grid const & lhs, bit_grid const & rhs)
+    {
+        return lhs._width == rhs._width and lhs._height == rhs._height and
+               lhs._words == rhs._words;
+    }
+private:
+    static size_type bit_of(int x)
+    {
+        return static_cast<size_type>(x) % word_bits;
+    }
+    size_type word_index(int x, int y) const
+    {
+        return static_cast<size_type>(y) * _words_per_row +
+               static_cast<size_type>(x) / word_bits;
+    }
+    word_type & word_at(int x, int y) { return _words[word_index(x, y)]; }
+    word_type const & word_at(int x, int y) const
+    {
+        return _words[word_index(x, y)];
+    }
+
+    void clear_padding()
+    {
+        if (_words_per_row == 0) { return; }
+        auto const mask = last_word_mask();
+        for (size_type y = 0; y < _height; ++y) { row(y).back() &= mask; }
+    }
+
+    size_type _width = 0;
+    size_type _height = 0;
+    size_type _words_per_row = 0;
+    std::vector<word_type> _words;
+};
+}
@@ -0,0 +1,325 @@
+#pragma once
+
+// type constraints
+#include <type_traits>
+#include <concepts>
+#include "spatula/directions.hpp"
+#include "spatula/execution.hpp"
+
+// data types and algorithms
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <span>
+#include <algorithm>
+#include <execution>
+#include "spatula/grids.hpp"
+
+namespace sp {
+
+namespace detail {
+/** Determine if a direction set holds both neighbours within a row. */
+template<adjacent_direction Enum>
+constexpr bool has_row_neighbours()
+{
+    bool left = false;
+    bool right = false;
+    for (auto const & offset : direction_table<Enum>::offsets) {
+        left = left or (offset[0] == -1 and offset[1] == 0);
+        right = right or (offset[0] == 1 and offset[1] == 0);
+    }
+    return left and right;
+}
+}
+
+/** A direction set whose regions can be found a row at a time: square grids
+ * with cardinal or octile directions, and hex grids indexed by axial (q, r).
+ */
+template<class Enum>
+concept region_direction = adjacent_direction<Enum> and
+                           detail::has_row_neighbours<Enum>();
+
+/** The connected regions of a grid. */
+struct grid_components {
+    /** The region of each cell, numbered from 0 in the order each region is
+     * first met reading the grid row by row. */
+    grid<std::uint32_t> labels;
+    /** The number of regions. */
+    std::size_t count = 0;
+};
+
+namespace detail {
+/** The cells from x_begin up to but not including x_end in a row, which all
+ * hold the same value. */
+struct cell_run {
+    int x_begin;
+    int x_end;
+};
+
+/** How far to either side the neighbours in the next row or the row before
+ * reach from a cell. */
+template<region_direction Enum>
+constexpr std::array<int, 2> row_reach(int dy)
+{
+    std::array<int, 2> reach{1, -1};
+    for (auto const & offset : direction_table<Enum>::offsets) {
+        if (offset[1] != dy) { continue; }
+        reach[0] = std::min(reach[0], offset[0]);
+        reach[1] = std::max(reach[1], offset[0]);
+    }
+    return reach;
+}
+
+/** A union-find forest over runs, where each root is the earliest run of its
+ * region. */
+class run_forest {
+public:
+    explicit run_forest(std::size_t size) : _parents(size) {}
+
+    void reset(std::size_t first, std::size_t last)
+    {
+        for (auto i = first; i < last; ++i) {
+            _parents[i] = static_cast<std::uint32_t>(i);
+        }
+    }
+
+    std::uint32_t find(std::uint32_t run)
+    {
+        while (_parents[run] != run) {
+            // halve the path on the way up
+            _parents[run] = _parents[_parents[run]];
+            run = _parents[run];
+        }
+        return run;
+    }
+
+    void join(std::uint32_t a, std::uint32_t b)
+    {
+        a = find(a);
+        b = find(b);
+        if (a == b) { return; }
+        if (a < b) { _parents[b] = a; }
+        else { _parents[a] = b; }
+    }
+private:
+    std::vector<std::uint32_t> _parents;
+};
+
+/** Split a row into runs of equal cells. */
+template<class T>
+void find_runs(std::span<T const> row, std::vector<cell_run> & runs)
+{
+    auto const width = static_cast<int>(row.size());
+    int x = 0;
+    while (x < width) {
+        auto end = x + 1;
+        while (end < width and row[end] == row[x]) { ++end; }
+        runs.push_back(cell_run{x, end});
+        x = end;
+    }
+}
+
+/** Join every run of a row to the runs of the row before it that neighbour
+ * it and hold the same value.
+ *
+ * Parameters
+ *   above, below - the cells of the row before and of the row itself
+ *   above_runs, below_runs - the runs of each row, in order
+ *   above_first, below_first - the index of the first run of each row
+ */
+template<region_direction Enum, class T>
+void join_rows(std::span<T const> above, std::span<T const> below,
+               std::span<cell_run const> above_runs,
+               std::span<cell_run const> below_runs,
+               std::uint32_t above_first, std::uint32_t below_first,
+               run_forest & forest)
+{
+    constexpr auto reach = row_reach<Enum>(-1);
+    std::size_t start = 0;
+    for (std::size_t j = 0; j < below_runs.size(); ++j) {
+        auto const & run = below_runs[j];
+        auto const low = run.x_begin + reach[0];
+        auto const high = run.x_end - 1 + reach[1];
+        // runs reach further right as j grows, so earlier runs above that
+        // end before this one's reach never meet a later run either
+        while (start < above_runs.size() and
+               above_runs[start].x_end - 1 < low) {
+            ++start;
+        }
+        for (auto i = start; i < above_runs.size() and
+                             above_runs[i].x_begin <= high; ++i) {
+            if (above[above_runs[i].x_begin] == below[run.x_begin]) {
+                forest.join(above_first + static_cast<std::uint32_t>(i),
+                            below_first + static_cast<std::uint32_t>(j));
+            }
+        }
+    }
+}
+
+/** The runs of a band of rows, with the index of the first run of each row.
+ */
+struct run_band {
+    std::vector<cell_run> runs;
+    std::vector<std::size_t> row_starts;
+    std::size_t offset = 0;
+
+    std::span<cell_run const> row(std::size_t i) const
+    {
+        return std::span<cell_run const>{runs}.subspan(
+            row_starts[i], row_starts[i + 1] - row_starts[i]);
+    }
+};
+}
+
+/** Label the connected regions of a grid.
+ *
+ * Two neighbouring cells, by the direction set, lie in the same region when
+ * they hold equal values. Each row is first split into runs of equal cells,
+ * and runs are joined to the runs they touch in the row before by union-find.
+ * Bands of rows are split and joined in parallel under the execution policy,
+ * then joined to each other along their edges, and the labels written back a
+ * run at a time. Hex grids are indexed by axial (q, r).
+ *
+ * Parameters
+ *   policy - the execution policy to schedule bands of rows with
+ *   cells - the grid to find the regions of
+ */
+template<region_direction Enum, execution_policy Policy, class T>
+grid_components label_components(Policy && policy, grid<T> const & cells)
+{
+    constexpr std::size_t band_height = 64;
+    auto const height = cells.height();
+    auto const bands = (height + band_height - 1) / band_height;
+    std::vector<detail::run_band> runs(bands);
+
+    for_each_index(policy, bands, [&](std::size_t b) {
+        auto & band = runs[b];
+        auto const first = b * band_height;
+        auto const last = std::min(height, first + band_height);
+        band.row_starts.push_back(0);
+        for (auto y = first; y < last; ++y) {
+            detail::find_runs(cells.row(y), band.runs);
+            band.row_starts.push_back(band.runs.size());
+        }
+    });
+    std::size_t total = 0;
+    for (auto & band : runs) {
+        band.offset = total;
+        total += band.runs.size();
+    }
+
+    // each band only joins its own runs, so bands can't disturb each other
+    detail::run_forest forest(total);
+    auto const join_band = [&](std::size_t b, std::size_t row) {
+        auto const & band = runs[b];
+        auto const y = b * band_height + row;
+        auto const & upper = row == 0 ? runs[b - 1] : band;
+        auto const upper_row = row == 0 ? band_height - 1 : row - 1;
+        detail::join_rows<Enum, T>(
+            cells.row(y - 1), cells.row(y), upper.row(upper_row),
+            band.row(row),
+            static_cast<std::uint32_t>(upper.offset +
+                                       upper.row_starts[upper_row]),
+            static_cast<std::uint32_t>(band.offset + band.row_starts[row]),
+            forest);
+    };
+    for_each_index(policy, bands, [&](std::size_t b) {
+        auto const & band = runs[b];
+        forest.reset(band.offset, band.offset + band.runs.size());
+        for (std::size_t row = 1; row + 1 < band.row_starts.size(); ++row) {
+            join_band(b, row);
+        }
+    });
+    for (std::size_t b = 1; b < bands; ++b) { join_band(b, 0); }
+
+    // roots come first in reading order, so they are labelled before the
+    // rest of their region
+    std::vector<std::uint32_t> run_labels(total);
+    grid_components components{grid<std::uint32_t>(cells.width(), height), 0};
+    for (std::uint32_t i = 0; i < total; ++i) {
+        auto const root = forest.find(i);
+        run_labels[i] = root == i
+            ? static_cast<std::uint32_t>(components.count++)
+            : run_labels[root];
+    }
+
+    for_each_index(std::forward<Policy>(policy), bands, [&](std::size_t b) {
+        auto const & band = runs[b];
+        for (std::size_t row = 0; row + 1 < band.row_starts.size(); ++row) {
+            auto const labels = components.labels.row(b * band_height + row);
+            auto index = band.offset + band.row_starts[row];
+            for (auto const & run : band.row(row)) {
+                std::fill(labels.begin() + run.x_begin,
+                          labels.begin() + run.x_end, run_labels[index++]);
+            }
+        }
+    });
+    return components;
+}
+
+template<region_direction Enum, class T>
+grid_components label_components(grid<T> const & cells)
+{
+    return label_components<Enum>(std::execution::seq, cells);
+}
+
+/** Set every cell in the region of a seed cell to a value.
+ *
+ * The region holds the cells connected to the seed through neighbours, by the
+ * direction set, that hold the same value as the seed. The fill works a run
+ * of cells at a time with an explicit stack of seeds, so it never recurses.
+ * Hex grids are indexed by axial (q, r).
+ *
+ * Returns
+ *   the number of cells filled, which is 0 when the seed lies off the grid or
+ *   already holds the value
+ */
+template<region_direction Enum, class T>
+std::size_t flood_fill(grid<T> & cells, grid_point seed,
+                       std::type_identity_t<T> const & value)
+{
+    if (not cells.contains(seed) or cells[seed] == value) { return 0; }
+    T const old = cells[seed];
+    auto const width = static_cast<int>(cells.width());
+    auto const height = static_cast<int>(cells.height());
+
+    std::size_t filled = 0;
+    std::vector<grid_point> seeds{seed};
+    while (not seeds.empty()) {
+        auto const [x, y] = seeds.back();
+        seeds.pop_back();
+        auto const row = cells.row(static_cast<std::size_t>(y));
+        if (row[x] != old) { continue; }
+        auto left = x;
+        auto right = x + 1;
+        while (left > 0 and row[left - 1] == old) { --left; }
+        while (right < width and row[right] == old) { ++right; }
+        std::fill(row.begin() + left, row.begin() + right, value);
+        filled += static_cast<std::size_t>(right - left);
+
+        for (int const dy : {-1, 1}) {
+            auto const ny = y + dy;
+            if (ny < 0 or ny >= height) { continue; }
+            auto const reach = detail::row_reach<Enum>(dy);
+            auto const low = std::max(left + reach[0], 0);
+            auto const high = std::min(right - 1 + reach[1], width - 1);
+            auto const next = cells.row(static_cast<std::size_t>(ny));
+            // seed each run of the region the neighbouring row reaches once
+            for (auto nx = low; nx <= high; ++nx) {
+                if (next[nx] == old and (nx == low or next[nx - 1] != old)) {
+                    seeds.push_back(grid_point{nx, ny});
+                }
+            }
+        }
+    }
+    return filled;
+}
+
+template<region_direction Enum, class T, grid_coordinate Vector>
+std::size_t flood_fill(grid<T> & cells, Vector const & seed,
+                       std::type_identity_t<T> const & value)
+{
+    return flood_fill<Enum>(cells, to_grid_point(seed), value);
+}
+}
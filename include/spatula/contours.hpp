@@ -0,0 +1,473 @@
+#pragma once
+
+// type constraints
+#include <type_traits>
+#include <concepts>
+#include <ranges>
+#include "spatula/vectors.hpp"
+#include "spatula/execution.hpp"
+
+// data types and algorithms
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <span>
+#include <algorithm>
+#include <execution>
+#include "spatula/grids.hpp"
+
+namespace sp {
+
+/** A vertex of an isoline, placed between samples. */
+template<class Vector>
+concept isoline_vertex = field_2d_constructible<Vector> and
+                         std::floating_point<scalar_field_t<Vector>>;
+
+/** A vertex of an isosurface, placed between samples. */
+template<class Vector>
+concept isosurface_vertex = field_3d_constructible<Vector> and
+                            std::floating_point<scalar_field_t<Vector>>;
+
+/** A contiguous block of scalar samples, such as a density field. */
+template<class Samples>
+concept scalar_samples =
+    std::ranges::contiguous_range<Samples> and
+    std::ranges::sized_range<Samples> and
+    std::is_arithmetic_v<std::ranges::range_value_t<Samples>>;
+
+/** The isolines of a grid of samples, as segments between shared vertices. */
+template<isoline_vertex Vector>
+struct isoline_mesh {
+    std::vector<Vector> vertices;
+    std::vector<std::array<std::uint32_t, 2>> segments;
+};
+
+/** The isosurface of a volume of samples, as triangles between shared
+ * vertices. */
+template<isosurface_vertex Vector>
+struct isosurface_mesh {
+    std::vector<Vector> vertices;
+    std::vector<std::array<std::uint32_t, 3>> triangles;
+};
+
+namespace detail {
+/** The index of an edge that no vertex lies on. */
+inline constexpr std::uint32_t no_edge_vertex = ~std::uint32_t{0};
+
+/** The edges a contour crosses within a square face, as segments that each
+ * run from the edge where the contour leaves the solid corners to the edge
+ * where it enters them.
+ *
+ * Corners are given counter-clockwise, and edge i joins corner i to corner
+ * i + 1. Each run of solid corners around the face is cut off by its own
+ * segment, so solid corners that only meet across a diagonal are kept apart.
+ * Neighbouring cells see the same runs along the face they share, so the
+ * contours they trace always meet.
+ */
+struct face_segments {
+    std::size_t size = 0;
+    std::array<std::array<std::uint8_t, 2>, 2> segments{};
+};
+
+constexpr face_segments trace_face(std::array<bool, 4> const & solid)
+{
+    face_segments face;
+    for (std::size_t i = 0; i < 4; ++i) {
+        if (not solid[i] or solid[(i + 1) % 4]) { continue; }
+        // walk back around the run of solid corners to where it was entered
+        auto start = i;
+        while (solid[(start + 3) % 4]) { start = (start + 3) % 4; }
+        face.segments[face.size++] = {static_cast<std::uint8_t>(i),
+                                      static_cast<std::uint8_t>(
+                                          (start + 3) % 4)};
+    }
+    return face;
+}
+
+/** The segments of every case of a square cell.
+ *
+ * Corner i of the cell has bit i of the case set when it is solid, with the
+ * corners at (0, 0), (1, 0), (1, 1) and (0, 1) in order. Edge 0 runs along the
+ * bottom of the cell, edge 1 up the right, edge 2 along the top and edge 3 up
+ * the left.
+ */
+constexpr std::array<face_segments, 16> square_cases()
+{
+    std::array<face_segments, 16> cases{};
+    for (std::size_t c = 0; c < 16; ++c) {
+        cases[c] = trace_face({(c & 1) != 0, (c & 2) != 0,
+                               (c & 4) != 0, (c & 8) != 0});
+    }
+    return cases;
+}
+
+/** The triangles a surface crosses a cube with. */
+struct cube_triangles {
+    std::size_t size = 0;
+    std::array<std::uint8_t, 15> edges{};
+};
+
+/** The edge between two corners of a cube that differ along one axis.
+ *
+ * Corner c of a cube lies at (c & 1, c >> 1 & 1, c >> 2 & 1). Edge
+ * 4 * a + i + 2 * j runs along axis a from the corner at i along the next
+ * axis and j along the one after.
+ */
+constexpr std::size_t cube_edge(std::size_t a, std::size_t b)
+{
+    auto const bit = a ^ b;
+    auto const axis = bit == 1 ? 0 : bit == 2 ? 1 : 2;
+    auto const low = a & b;
+    return 4 * axis + (low >> (axis + 1) % 3 & 1) +
+           2 * (low >> (axis + 2) % 3 & 1);
+}
+
+/** The triangles of every case of a cube.
+ *
+ * Each face of the cube is traced like a square cell, seen from outside the
+ * cube, and the segments of every face are chained into loops around the
+ * cube. Each loop is then split into a fan of triangles, wound
+ * counter-clockwise when seen from the empty side.
+ */
+constexpr std::array<cube_triangles, 256> cube_cases()
+{
+    std::array<cube_triangles, 256> cases{};
+    for (std::size_t c = 0; c < 256; ++c) {
+        std::array<std::size_t, 12> next;
+        next.fill(12);
+        for (std::size_t axis = 0; axis < 3; ++axis) {
+            auto const u = std::size_t{1} << (axis + 1) % 3;
+            auto const v = std::size_t{1} << (axis + 2) % 3;
+            for (std::size_t side = 0; side < 2; ++side) {
+                auto const base = side << axis;
+                // counter-clockwise from outside, so the low face turns back
+                std::array<std::size_t, 4> corners{base, base | u,
+                                                   base | u | v, base | v};
+                if (side == 0) { std::swap(corners[1], corners[3]); }
+                std::array<bool, 4> solid{};
+                for (std::size_t i = 0; i < 4; ++i) {
+                    solid[i] = (c >> corners[i] & 1) != 0;
+                }
+                auto const face = trace_face(solid);
+                for (std::size_t s = 0; s < face.size; ++s) {
+                    auto const [from, to] = face.segments[s];
+                    next[cube_edge(corners[from], corners[(from + 1) % 4])] =
+                        cube_edge(corners[to], corners[(to + 1) % 4]);
+                }
+            }
+        }
+
+        auto & triangles = cases[c];
+        std::array<bool, 12> visited{};
+        for (std::size_t first = 0; first < 12; ++first) {
+            if (next[first] == 12 or visited[first]) { continue; }
+            std::array<std::size_t, 12> loop{};
+            std::size_t size = 0;
+            for (auto e = first; not visited[e]; e = next[e]) {
+                visited[e] = true;
+                loop[size++] = e;
+            }
+            for (std::size_t i = 1; i + 1 < size; ++i) {
+                triangles.edges[triangles.size++] =
+                    static_cast<std::uint8_t>(loop[0]);
+                triangles.edges[triangles.size++] =
+                    static_cast<std::uint8_t>(loop[i + 1]);
+                triangles.edges[triangles.size++] =
+                    static_cast<std::uint8_t>(loop[i]);
+            }
+        }
+    }
+    return cases;
+}
+
+inline constexpr auto square_table = square_cases();
+inline constexpr auto cube_table = cube_cases();
+
+/** Place a vertex where the samples a and b, a unit apart along one axis,
+ * cross the iso value. */
+template<class Scalar, class T>
+Scalar crossing(Scalar from, T a, T b, T iso)
+{
+    auto const t = (static_cast<double>(iso) - static_cast<double>(a)) /
+                   (static_cast<double>(b) - static_cast<double>(a));
+    return static_cast<Scalar>(static_cast<double>(from) + t);
+}
+
+/** Copy the parts built by each tile into one list. */
+template<class T>
+std::vector<T> concatenate(std::vector<std::vector<T>> const & parts)
+{
+    std::size_t size = 0;
+    for (auto const & part : parts) { size += part.size(); }
+    std::vector<T> all;
+    all.reserve(size);
+    for (auto const & part : parts) {
+        all.insert(all.end(), part.begin(), part.end());
+    }
+    return all;
+}
+
+/** The index of the first vertex of each tile in the whole mesh. */
+template<class Vector>
+std::vector<std::uint32_t>
+vertex_offsets(std::vector<std::vector<Vector>> const & parts)
+{
+    std::vector<std::uint32_t> offsets(parts.size());
+    std::uint32_t total = 0;
+    for (std::size_t i = 0; i < parts.size(); ++i) {
+        offsets[i] = total;
+        total += static_cast<std::uint32_t>(parts[i].size());
+    }
+    return offsets;
+}
+}
+
+/** Trace the lines where a grid of samples crosses an iso value, by marching
+ * squares.
+ *
+ * Samples at or above the iso value are solid. Each cell between four
+ * samples is traced by the solid corners it holds, and a vertex is placed
+ * along each edge the line crosses by interpolating the samples at its ends,
+ * with sample (x, y) at (x, y). Each segment runs with the solid side on its
+ * left when y points up. Solid corners that only meet across a diagonal are
+ * kept apart.
+ *
+ * Work is split into bands of rows under the execution policy. Every edge
+ * belongs to the band holding its lower end, which places its vertex once in
+ * a shared edge cache, so cells on either side of an edge, or of a band
+ * boundary, share a single vertex.
+ *
+ * Parameters
+ *   policy - the execution policy to schedule bands of rows with
+ *   samples - the values to trace, at the corners of each cell
+ *   iso - the value to trace the lines of
+ */
+template<isoline_vertex Vector, execution_policy Policy, class T>
+    requires std::is_arithmetic_v<T>
+isoline_mesh<Vector> isolines(Policy && policy, grid<T> const & samples,
+                              std::type_identity_t<T> iso)
+{
+    using scalar = scalar_field_t<Vector>;
+    constexpr std::size_t band_height = 32;
+    isoline_mesh<Vector> mesh;
+    auto const width = samples.width();
+    auto const height = samples.height();
+    if (width < 2 or height < 2) { return mesh; }
+
+    auto const bands = (height + band_height - 1) / band_height;
+    // the vertex of each edge within its band, by the sample at its lower
+    // end and its axis
+    std::vector<std::uint32_t> edges(2 * width * height,
+                                     detail::no_edge_vertex);
+    std::vector<std::vector<Vector>> vertices(bands);
+    for_each_index(policy, bands, [&](std::size_t b) {
+        auto & out = vertices[b];
+        auto const last = std::min(height, (b + 1) * band_height);
+        for (auto y = b * band_height; y < last; ++y) {
+            auto const row = samples.row(y);
+            auto const above = y + 1 < height ? samples.row(y + 1) : row;
+            auto const fy = static_cast<scalar>(y);
+            for (std::size_t x = 0; x < width; ++x) {
+                auto const index = 2 * (y * width + x);
+                bool const solid = row[x] >= iso;
+                if (x + 1 < width and (row[x + 1] >= iso) != solid) {
+                    edges[index] = static_cast<std::uint32_t>(out.size());
+                    out.push_back(Vector{
+                        detail::crossing(static_cast<scalar>(x), row[x],
+                                         row[x + 1], iso), fy});
+                }
+                if (y + 1 < height and (above[x] >= iso) != solid) {
+                    edges[index + 1] = static_cast<std::uint32_t>(out.size());
+                    out.push_back(Vector{
+                        static_cast<scalar>(x),
+                        detail::crossing(fy, row[x], above[x], iso)});
+                }
+            }
+        }
+    });
+    auto const offsets = detail::vertex_offsets(vertices);
+
+    std::vector<std::vector<std::array<std::uint32_t, 2>>> segments(bands);
+    for_each_index(std::forward<Policy>(policy), bands, [&](std::size_t b) {
+        auto & out = segments[b];
+        auto const last = std::min(height - 1, (b + 1) * band_height);
+        for (auto y = b * band_height; y < last; ++y) {
+            auto const row = samples.row(y);
+            auto const above = samples.row(y + 1);
+            // the bottom, right, top and left edges of the cell
+            auto const vertex = [&](std::size_t x, std::size_t edge) {
+                auto const ey = edge == 2 ? y + 1 : y;
+                auto const ex = edge == 1 ? x + 1 : x;
+                auto const local = edges[2 * (ey * width + ex) + edge % 2];
+                return local + offsets[ey / band_height];
+            };
+            for (std::size_t x = 0; x + 1 < width; ++x) {
+                auto const c = std::size_t{row[x] >= iso} |
+                               std::size_t{row[x + 1] >= iso} << 1 |
+                               std::size_t{above[x + 1] >= iso} << 2 |
+                               std::size_t{above[x] >= iso} << 3;
+                auto const & cell = detail::square_table[c];
+                for (std::size_t s = 0; s < cell.size; ++s) {
+                    out.push_back({vertex(x, cell.segments[s][0]),
+                                   vertex(x, cell.segments[s][1])});
+                }
+            }
+        }
+    });
+    mesh.vertices = detail::concatenate(vertices);
+    mesh.segments = detail::concatenate(segments);
+    return mesh;
+}
+
+template<isoline_vertex Vector, class T>
+    requires std::is_arithmetic_v<T>
+isoline_mesh<Vector> isolines(grid<T> const & samples,
+                              std::type_identity_t<T> iso)
+{
+    return isolines<Vector>(std::execution::seq, samples, iso);
+}
+
+/** Extract the surface where a volume of samples crosses an iso value, by
+ * marching cubes.
+ *
+ * Samples are laid out x first, then y, then z, so sample (x, y, z) lies at
+ * index (z * extent.y + y) * extent.x + x and is placed at (x, y, z). Samples
+ * at or above the iso value are solid. Each cube between eight samples is
+ * split into triangles by the solid corners it holds, with a vertex placed
+ * along each edge the surface crosses by interpolating the samples at its
+ * ends. Triangles wind counter-clockwise seen from the empty side, so their
+ * normals point away from the solid. Solid corners that only meet across the
+ * diagonal of a face are kept apart, the same way by both cubes on the face,
+ * so the surface has no cracks.
+ *
+ * Work is split into tiles of a few layers along z under the execution
+ * policy. Every edge belongs to the tile holding its lower end, which places
+ * its vertex once in a shared edge cache, so cubes on either side of an edge,
+ * or of a tile boundary, share a single vertex.
+ *
+ * Parameters
+ *   policy - the execution policy to schedule tiles of layers with
+ *   samples - the values to extract the surface of, at the corners of each
+ *             cube
+ *   extent - the number of samples along each axis. The mesh is empty if
+ *            there are fewer samples than it covers.
+ *   iso - the value to extract the surface of
+ */
+template<isosurface_vertex Vector, execution_policy Policy,
+         scalar_samples Samples>
+isosurface_mesh<Vector>
+isosurface(Policy && policy, Samples const & samples,
+           voxel_point const & extent,
+           std::ranges::range_value_t<Samples> iso)
+{
+    using T = std::ranges::range_value_t<Samples>;
+    using scalar = scalar_field_t<Vector>;
+    constexpr std::size_t tile_depth = 4;
+    isosurface_mesh<Vector> mesh;
+    if (extent.x < 2 or extent.y < 2 or extent.z < 2) { return mesh; }
+    auto const nx = static_cast<std::size_t>(extent.x);
+    auto const ny = static_cast<std::size_t>(extent.y);
+    auto const nz = static_cast<std::size_t>(extent.z);
+    if (std::ranges::size(samples) < nx * ny * nz) { return mesh; }
+    std::span<T const> const values{std::ranges::data(samples),
+                                    nx * ny * nz};
+
+    auto const tiles = (nz + tile_depth - 1) / tile_depth;
+    // the vertex of each edge within its tile, by the sample at its lower
+    // end and its axis
+    std::vector<std::uint32_t> edges(3 * values.size(),
+                                     detail::no_edge_vertex);
+    std::vector<std::vector<Vector>> vertices(tiles);
+    for_each_index(policy, tiles, [&](std::size_t tile) {
+        auto & out = vertices[tile];
+        auto const last = std::min(nz, (tile + 1) * tile_depth);
+        for (auto z = tile * tile_depth; z < last; ++z) {
+            for (std::size_t y = 0; y < ny; ++y) {
+                auto const row = (z * ny + y) * nx;
+                auto const fy = static_cast<scalar>(y);
+                auto const fz = static_cast<scalar>(z);
+                for (std::size_t x = 0; x < nx; ++x) {
+                    auto const i = row + x;
+                    auto const fx = static_cast<scalar>(x);
+                    bool const solid = values[i] >= iso;
+                    auto const place = [&](std::size_t axis,
+                                           Vector const & vertex) {
+                        edges[3 * i + axis] =
+                            static_cast<std::uint32_t>(out.size());
+                        out.push_back(vertex);
+                    };
+                    if (x + 1 < nx and (values[i + 1] >= iso) != solid) {
+                        place(0, Vector{
+                            detail::crossing(fx, values[i], values[i + 1],
+                                             iso), fy, fz});
+                    }
+                    if (y + 1 < ny and (values[i + nx] >= iso) != solid) {
+                        place(1, Vector{
+                            fx, detail::crossing(fy, values[i],
+                                                 values[i + nx], iso), fz});
+                    }
+                    auto const k = i + nx * ny;
+                    if (z + 1 < nz and (values[k] >= iso) != solid) {
+                        place(2, Vector{
+                            fx, fy, detail::crossing(fz, values[i],
+                                                     values[k], iso)});
+                    }
+                }
+            }
+        }
+    });
+    auto const offsets = detail::vertex_offsets(vertices);
+
+    std::vector<std::vector<std::array<std::uint32_t, 3>>> triangles(tiles);
+    for_each_index(std::forward<Policy>(policy), tiles,
+                   [&](std::size_t tile) {
+        auto & out = triangles[tile];
+        auto const last = std::min(nz - 1, (tile + 1) * tile_depth);
+        // the offset of each corner of a cube from its lowest sample
+        std::array<std::size_t, 8> corners{};
+        for (std::size_t c = 0; c < 8; ++c) {
+            corners[c] = (c & 1) + (c >> 1 & 1) * nx + (c >> 2 & 1) * nx * ny;
+        }
+        for (auto z = tile * tile_depth; z < last; ++z) {
+            for (std::size_t y = 0; y + 1 < ny; ++y) {
+                for (std::size_t x = 0; x + 1 < nx; ++x) {
+                    auto const i = (z * ny + y) * nx + x;
+                    std::size_t c = 0;
+                    for (std::size_t k = 0; k < 8; ++k) {
+                        c |= std::size_t{values[i + corners[k]] >= iso} << k;
+                    }
+                    auto const & cube = detail::cube_table[c];
+                    auto const vertex = [&](std::size_t edge) {
+                        auto const axis = edge / 4;
+                        // the lowest corner of the edge, from its bits
+                        auto const low =
+                            (edge & 1) << (axis + 1) % 3 |
+                            (edge >> 1 & 1) << (axis + 2) % 3;
+                        auto const local = edges[3 * (i + corners[low]) +
+                                                 axis];
+                        auto const ez = z + (low >> 2 & 1);
+                        return local + offsets[ez / tile_depth];
+                    };
+                    for (std::size_t t = 0; t < cube.size; t += 3) {
+                        out.push_back({vertex(cube.edges[t]),
+                                       vertex(cube.edges[t + 1]),
+                                       vertex(cube.edges[t + 2])});
+                    }
+                }
+            }
+        }
+    });
+    mesh.vertices = detail::concatenate(vertices);
+    mesh.triangles = detail::concatenate(triangles);
+    return mesh;
+}
+
+template<isosurface_vertex Vector, scalar_samples Samples>
+isosurface_mesh<Vector>
+isosurface(Samples const & samples, voxel_point const & extent,
+           std::ranges::range_value_t<Samples> iso)
+{
+    return isosurface<Vector>(std::execution::seq, samples, extent, iso);
+}
+}
@@ -0,0 +1,251 @@
+#pragma once
+
+// type constraints
+#include <type_traits>
+#include <concepts>
+#include <iterator>
+#include "spatula/directions.hpp"
+
+// data types and data structures
+#include <cstdint>
+#include <cstddef>
+#include <bit>
+#include <initializer_list>
+
+namespace sp {
+
+namespace detail {
+/** The smallest unsigned integer with a bit for every value of an enum. */
+template<ranged_enum Enum>
+using direction_bits_t =
+    std::conditional_t<enum_size_v<Enum> <= 8, std::uint8_t,
+    std::conditional_t<enum_size_v<Enum> <= 16, std::uint16_t,
+    std::conditional_t<enum_size_v<Enum> <= 32, std::uint32_t,
+                       std::uint64_t>>>;
+
+/** Determine if one clockwise turn moves every direction to the next one. */
+template<tabled_direction Enum>
+constexpr bool turns_in_order()
+{
+    constexpr auto N = enum_size_v<Enum>;
+    for (std::size_t i = 0; i < N; ++i) {
+        if (direction_table<Enum>::clockwise[i] != (i + 1) % N) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** Determine if each direction is opposite the one halfway around. */
+template<tabled_direction Enum>
+constexpr bool opposite_halfway()
+{
+    constexpr auto N = enum_size_v<Enum>;
+    for (std::size_t i = 0; i < N; ++i) {
+        if (direction_table<Enum>::opposites[i] != (i + N / 2) % N) {
+            return false;
+        }
+    }
+    return N % 2 == 0;
+}
+
+/** Determine if opposite directions sit next to each other, as 2i and 2i+1. */
+template<tabled_direction Enum>
+constexpr bool opposite_paired()
+{
+    for (std::size_t i = 0; i < enum_size_v<Enum>; ++i) {
+        if (direction_table<Enum>::opposites[i] != (i ^ 1)) { return false; }
+    }
+    return true;
+}
+}
+
+/** A set of directions from a ranged_enum, stored as a bitmask.
+ *
+ * Direction i is stored in bit i of the smallest unsigned integer wide enough
+ * for every direction, so cardinal, hex and octile sets take a single byte.
+ * The type is trivially copyable and holds nothing but its bits, so grids of
+ * direction sets can be tested and combined with plain integer operations.
+ *
+ * Iterating a set visits its directions in enum order, skipping straight from
+ * one set bit to the next.
+ */
+template<ranged_enum Enum>
+class direction_set {
+public:
+    using bits_type = detail::direction_bits_t<Enum>;
+    static constexpr std::size_t capacity = enum_size_v<Enum>;
+    static constexpr bits_type mask = static_cast<bits_type>(
+        capacity == 64 ? ~std::uint64_t{0}
+                       : (std::uint64_t{1} << (capacity % 64)) - 1);
+
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Enum;
+        using difference_type = std::ptrdiff_t;
+        using reference = Enum;
+        using pointer = void;
+
+        constexpr iterator() = default;
+        constexpr explicit iterator(bits_type bits) : _bits{bits} {}
+
+        constexpr Enum operator*() const
+        {
+            return static_cast<Enum>(std::countr_zero(_bits));
+        }
+        constexpr iterator & operator++()
+        {
+            // clear the lowest set bit
+            _bits = static_cast<bits_type>(_bits & (_bits - 1));
+            return *this;
+        }
+        constexpr iterator operator++(int)
+        {
+            auto old = *this;
+            ++*this;
+            return old;
+        }
+        friend constexpr bool operator==(iterator const &,
+                                         iterator const &) = default;
+    private:
+        bits_type _bits = 0;
+    };
+
+    constexpr direction_set() = default;
+    constexpr direction_set(std::initializer_list<Enum> directions)
+    {
+        for (Enum const direction : directions) { insert(direction); }
+    }
+
+    /** A set with the given bits, ignoring bits past the last direction. */
+    static constexpr direction_set from_bits(bits_type bits)
+    {
+        direction_set set;
+        set._bits = static_cast<bits_type>(bits & mask);
+        return set;
+    }
+    /** The set of every direction. */
+    static constexpr direction_set all() { return from_bits(mask); }
+
+    constexpr bits_type bits() const { return _bits; }
+    constexpr std::size_t size() const
+    {
+        return static_cast<std::size_t>(std::popcount(_bits));
+    }
+    constexpr bool empty() const { return _bits == 0; }
+
+    constexpr iterator begin() const { return iterator{_bits}; }
+    constexpr iterator end() const { return iterator{}; }
+
+    constexpr bool contains(Enum direction) const
+    {
+        return (_bits >> direction) & 1u;
+    }
+    constexpr void insert(Enum direction)
+    {
+        _bits = static_cast<bits_type>(_bits | bit_of(direction));
+    }
+    constexpr void erase(Enum direction)
+    {
+        _bits = static_cast<bits_type>(_bits & ~bit_of(direction));
+    }
+    constexpr void clear() { _bits = 0; }
+
+    constexpr direction_set & operator|=(direction_set other)
+    {
+        _bits = static_cast<bits_type>(_bits | other._bits);
+        return *this;
+    }
+    constexpr direction_set & operator&=(direction_set other)
+    {
+        _bits = static_cast<bits_type>(_bits & other._bits);
+        return *this;
+    }
+    constexpr direction_set & operator^=(direction_set other)
+    {
+        _bits = static_cast<bits_type>(_bits ^ other._bits);
+        return *this;
+    }
+
+    friend constexpr direction_set operator|(direction_set a, direction_set b)
+    {
+        return a |= b;
+    }
+    friend constexpr direction_set operator&(direction_set a, direction_set b)
+    {
+        return a &= b;
+    }
+    friend constexpr direction_set operator^(direction_set a, direction_set b)
+    {
+        return a ^= b;
+    }
+    /** The directions missing from the set. */
+    friend constexpr direction_set operator~(direction_set set)
+    {
+        return from_bits(static_cast<bits_type>(~set._bits));
+    }
+
+    friend constexpr bool operator==(direction_set const &,
+                                     direction_set const &) = default;
+
+    /** Rotate every direction in the set by a number of clockwise turns.
+     *
+     * Sets whose directions turn in enum order rotate their bits directly.
+     * Other sets move each direction through rotate_direction.
+     */
+    constexpr direction_set rotated(int turns) const
+        requires tabled_direction<Enum>
+    {
+        if constexpr (detail::turns_in_order<Enum>()) {
+            constexpr int N = static_cast<int>(capacity);
+            int const k = ((turns % N) + N) % N;
+            return rotate_bits(k);
+        }
+        else {
+            direction_set result;
+            for (Enum const direction : *this) {
+                result.insert(rotate_direction(direction, turns));
+            }
+            return result;
+        }
+    }
+
+    /** The set of directions opposite to those in the set. */
+    constexpr direction_set opposite() const requires tabled_direction<Enum>
+    {
+        if constexpr (detail::opposite_halfway<Enum>()) {
+            return rotate_bits(static_cast<int>(capacity / 2));
+        }
+        else if constexpr (detail::opposite_paired<Enum>()) {
+            constexpr auto even = static_cast<bits_type>(
+                static_cast<std::uint64_t>(0x5555'5555'5555'5555) & mask);
+            return from_bits(static_cast<bits_type>(
+                ((_bits & even) << 1) | ((_bits >> 1) & even)));
+        }
+        else {
+            direction_set result;
+            for (Enum const direction : *this) {
+                result.insert(opposite_direction(direction));
+            }
+            return result;
+        }
+    }
+private:
+    static constexpr bits_type bit_of(Enum direction)
+    {
+        return static_cast<bits_type>(bits_type{1} << direction);
+    }
+
+    /** Rotate the bits left by k within the first capacity bits. */
+    constexpr direction_set rotate_bits(int k) const
+    {
+        if (k == 0) { return *this; }
+        auto const shift = static_cast<std::size_t>(k);
+        return from_bits(static_cast<bits_type>(
+            (_bits << shift) | (_bits >> (capacity - shift))));
+    }
+
+    bits_type _bits = 0;
+};
+}
@@ -17,6 +17,42 @@ enum direction_name { north, northeast, southeast, south, southwest, northwest }
 namespace sp::pointed_hex{
 enum direction_name{ northeast, east, southeast, southwest, west, northwest };
 }
+/** The cardinal and diagonal directions. */
+namespace sp::octile {
+enum direction_name {
+    north, northeast, east, southeast, south, southwest, west, northwest
+};
+}
+/** The edges of a triangle on a triangle grid. */
+namespace sp::triangular {
+enum direction_name {
+    north, northeast, southeast, south, southwest, northwest
+};
+}
+/** The faces of a voxel. */
+namespace sp::voxel6 {
+enum direction_name { east, west, north, south, up, down };
+}
+/** The faces and edges of a voxel. */
+namespace sp::voxel18 {
+enum direction_name {
+    east, west, north, south, up, down,
+    northeast, southwest, northwest, southeast,
+    up_east, down_west, up_west, down_east,
+    up_north, down_south, up_south, down_north
+};
+}
+/** The faces, edges and corners of a voxel. */
+namespace sp::voxel26 {
+enum direction_name {
+    east, west, north, south, up, down,
+    northeast, southwest, northwest, southeast,
+    up_east, down_west, up_west, down_east,
+    up_north, down_south, up_south, down_north,
+    up_northeast, down_southwest, up_northwest, down_southeast,
+    up_southeast, down_northwest, up_southwest, down_northeast
+};
+}
 
 namespace sp {
 
@@ -46,10 +82,307 @@ struct enum_size<flat_hex::direction_name> {
     static constexpr std::size_t value = 6;
 };
 
+template<>
+struct enum_size<octile::direction_name> {
+    static constexpr std::size_t value = 8;
+};
+
+template<>
+struct enum_size<triangular::direction_name> {
+    static constexpr std::size_t value = 6;
+};
+
+template<>
+struct enum_size<voxel6::direction_name> {
+    static constexpr std::size_t value = 6;
+};
+
+template<>
+struct enum_size<voxel18::direction_name> {
+    static constexpr std::size_t value = 18;
+};
+
+template<>
+struct enum_size<voxel26::direction_name> {
+    static constexpr std::size_t value = 26;
+};
+
 /** An enum with sequential values defined from [0, enum_size_v<Enum>). */
 template<class Enum>
 concept ranged_enum = std::is_enum_v<Enum> and requires { enum_size_v<Enum>; };
 
+/** The fewest steps needed to cover an offset, moving in a ranged_enum's
+ * directions.
+ *
+ * Pathfinding uses this as an admissible heuristic. The general template knows
+ * nothing about the directions, so it always answers zero.
+ */
+template<ranged_enum Enum>
+struct step_distance {
+    constexpr std::uint32_t operator()(int, int) const { return 0; }
+};
+
+template<>
+struct step_distance<cardinal::direction_name> {
+    constexpr std::uint32_t operator()(int dx, int dy) const
+    {
+        return static_cast<std::uint32_t>((dx < 0 ? -dx : dx) +
+                                          (dy < 0 ? -dy : dy));
+    }
+};
+
+/** Axial hex distance, shared by both hex orientations. */
+struct hex_step_distance {
+    constexpr std::uint32_t operator()(int dq, int dr) const
+    {
+        int const ds = dq + dr;
+        return static_cast<std::uint32_t>(((dq < 0 ? -dq : dq) +
+                                           (dr < 0 ? -dr : dr) +
+                                           (ds < 0 ? -ds : ds)) / 2);
+    }
+};
+
+template<>
+struct step_distance<octile::direction_name> {
+    constexpr std::uint32_t operator()(int dx, int dy) const
+    {
+        int const x = dx < 0 ? -dx : dx;
+        int const y = dy < 0 ? -dy : dy;
+        return static_cast<std::uint32_t>(x > y ? x : y);
+    }
+};
+
+template<>
+struct step_distance<flat_hex::direction_name> : hex_step_distance {};
+
+template<>
+struct step_distance<pointed_hex::direction_name> : hex_step_distance {};
+
+/** The constexpr offset, opposite and rotation tables of a direction set.
+ *
+ * Specializations define
+ *   dimensions - the number of components in each offset
+ *   rotation_period - the number of clockwise turns that make a full circle
+ *   offsets - the integer offset of each direction, in enum order
+ *   opposites - the direction pointing the other way, for each direction
+ *   clockwise - the direction one turn clockwise, for each direction
+ *
+ * Planar sets turn clockwise as seen on screen, in the handedness of their
+ * offsets. Voxel sets turn a quarter about the up axis, as seen from above.
+ */
+template<ranged_enum Enum>
+struct direction_table;
+
+/** A ranged_enum with constexpr direction tables. */
+template<class Enum>
+concept tabled_direction = ranged_enum<Enum> and requires {
+    direction_table<Enum>::dimensions;
+    direction_table<Enum>::rotation_period;
+    direction_table<Enum>::offsets;
+    direction_table<Enum>::opposites;
+    direction_table<Enum>::clockwise;
+};
+
+/** A planar direction set whose neighbours all lie within one cell. */
+template<class Enum>
+concept adjacent_direction = tabled_direction<Enum> and
+                             direction_table<Enum>::dimensions == 2 and
+                             enum_size_v<Enum> <= 8;
+
+template<>
+struct direction_table<cardinal::direction_name> {
+    using enum cardinal::direction_name;
+    static constexpr std::size_t dimensions = 2;
+    static constexpr std::size_t rotation_period = 4;
+    static constexpr std::array<std::array<int, 2>, 4> offsets{{
+        {0, 1}, {1, 0}, {0, -1}, {-1, 0}
+    }};
+    static constexpr std::array<cardinal::direction_name, 4> opposites{
+        south, west, north, east
+    };
+    static constexpr std::array<cardinal::direction_name, 4> clockwise{
+        east, south, west, north
+    };
+};
+
+template<>
+struct direction_table<octile::direction_name> {
+    using enum octile::direction_name;
+    static constexpr std::size_t dimensions = 2;
+    static constexpr std::size_t rotation_period = 8;
+    static constexpr std::array<std::array<int, 2>, 8> offsets{{
+        {0, 1}, {1, 1}, {1, 0}, {1, -1},
+        {0, -1}, {-1, -1}, {-1, 0}, {-1, 1}
+    }};
+    static constexpr std::array<octile::direction_name, 8> opposites{
+        south, southwest, west, northwest, north, northeast, east, southeast
+    };
+    static constexpr std::array<octile::direction_name, 8> clockwise{
+        northeast, east, southeast, south, southwest, west, northwest, north
+    };
+};
+
+/** Axial hex offsets, where r grows towards the south of the screen. */
+template<>
+struct direction_table<flat_hex::direction_name> {
+    using enum flat_hex::direction_name;
+    static constexpr std::size_t dimensions = 2;
+    static constexpr std::size_t rotation_period = 6;
+    static constexpr std::array<std::array<int, 2>, 6> offsets{{
+        {0, -1}, {1, -1}, {1, 0}, {0, 1}, {-1, 1}, {-1, 0}
+    }};
+    static constexpr std::array<flat_hex::direction_name, 6> opposites{
+        south, southwest, northwest, north, northeast, southeast
+    };
+    static constexpr std::array<flat_hex::direction_name, 6> clockwise{
+        northeast, southeast, south, southwest, northwest, north
+    };
+};
+
+/** Axial hex offsets, where r grows towards the south of the screen. */
+template<>
+struct direction_table<pointed_hex::direction_name> {
+    using enum pointed_hex::direction_name;
+    static constexpr std::size_t dimensions = 2;
+    static constexpr std::size_t rotation_period = 6;
+    static constexpr std::array<std::array<int, 2>, 6> offsets{{
+        {1, -1}, {1, 0}, {0, 1}, {-1, 1}, {-1, 0}, {0, -1}
+    }};
+    static constexpr std::array<pointed_hex::direction_name, 6> opposites{
+        southwest, west, northwest, northeast, east, southeast
+    };
+    static constexpr std::array<pointed_hex::direction_name, 6> clockwise{
+        east, southeast, southwest, west, northwest, northeast
+    };
+};
+
+/** Triangle coordinates (a, b, c).
+ *
+ * Each coordinate counts the lines crossed in one of the three families of
+ * grid lines: a grows to the north, b to the southeast and c to the southwest.
+ * Triangles pointing up only have northeast, south and northwest neighbours,
+ * while triangles pointing down only have north, southeast and southwest
+ * neighbours, so a + b + c is one higher on up triangles than on down ones.
+ */
+template<>
+struct direction_table<triangular::direction_name> {
+    using enum triangular::direction_name;
+    static constexpr std::size_t dimensions = 3;
+    static constexpr std::size_t rotation_period = 6;
+    static constexpr std::array<std::array<int, 3>, 6> offsets{{
+        {1, 0, 0}, {0, 0, -1}, {0, 1, 0}, {-1, 0, 0}, {0, 0, 1}, {0, -1, 0}
+    }};
+    static constexpr std::array<triangular::direction_name, 6> opposites{
+        south, southwest, northwest, north, northeast, southeast
+    };
+    static constexpr std::array<triangular::direction_name, 6> clockwise{
+        northeast, southeast, south, southwest, northwest, north
+    };
+};
+
+namespace detail {
+/** The voxel neighbourhood tables, with x to the east, y to the north and z
+ * up. Faces come first, then edges, then corners, so the 6- and 18-neighbour
+ * sets are prefixes of the 26-neighbour set. Opposite directions are paired,
+ * so the opposite of direction i is always i ^ 1.
+ */
+inline constexpr std::array<std::array<int, 3>, 26> voxel_offsets{{
+    {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1},
+    {1, 1, 0}, {-1, -1, 0}, {-1, 1, 0}, {1, -1, 0},
+    {1, 0, 1}, {-1, 0, -1}, {-1, 0, 1}, {1, 0, -1},
+    {0, 1, 1}, {0, -1, -1}, {0, -1, 1}, {0, 1, -1},
+    {1, 1, 1}, {-1, -1, -1}, {-1, 1, 1}, {1, -1, -1},
+    {1, -1, 1}, {-1, 1, -1}, {-1, -1, 1}, {1, 1, -1}
+}};
+
+/** A quarter turn clockwise about the up axis maps (x, y, z) to (y, -x, z). */
+inline constexpr std::array<std::size_t, 26> voxel_clockwise{
+    3, 2, 0, 1, 4, 5,
+    9, 8, 6, 7,
+    16, 17, 14, 15, 10, 11, 12, 13,
+    22, 23, 18, 19, 24, 25, 20, 21
+};
+
+template<ranged_enum Enum>
+struct voxel_direction_table {
+    static constexpr std::size_t N = enum_size_v<Enum>;
+    static constexpr std::size_t dimensions = 3;
+    static constexpr std::size_t rotation_period = 4;
+    static constexpr std::array<std::array<int, 3>, N> offsets = [] {
+        std::array<std::array<int, 3>, N> table{};
+        for (std::size_t i = 0; i < N; ++i) { table[i] = voxel_offsets[i]; }
+        return table;
+    }();
+    static constexpr std::array<Enum, N> opposites = [] {
+        std::array<Enum, N> table{};
+        for (std::size_t i = 0; i < N; ++i) {
+            table[i] = static_cast<Enum>(i ^ 1);
+        }
+        return table;
+    }();
+    static constexpr std::array<Enum, N> clockwise = [] {
+        std::array<Enum, N> table{};
+        for (std::size_t i = 0; i < N; ++i) {
+            table[i] = static_cast<Enum>(voxel_clockwise[i]);
+        }
+        return table;
+    }();
+};
+}
+
+template<>
+struct direction_table<voxel6::direction_name>
+    : detail::voxel_direction_table<voxel6::direction_name> {};
+
+template<>
+struct direction_table<voxel18::direction_name>
+    : detail::voxel_direction_table<voxel18::direction_name> {};
+
+template<>
+struct direction_table<voxel26::direction_name>
+    : detail::voxel_direction_table<voxel26::direction_name> {};
+
+namespace detail {
+/** Every clockwise rotation of every direction, indexed by turns, then by
+ * direction. */
+template<tabled_direction Enum>
+inline constexpr auto direction_rotations = [] {
+    using table = direction_table<Enum>;
+    constexpr std::size_t N = enum_size_v<Enum>;
+    std::array<std::array<Enum, N>, table::rotation_period> turns{};
+    for (std::size_t i = 0; i < N; ++i) {
+        turns[0][i] = static_cast<Enum>(i);
+    }
+    for (std::size_t k = 1; k < table::rotation_period; ++k) {
+        for (std::size_t i = 0; i < N; ++i) {
+            turns[k][i] = table::clockwise[turns[k - 1][i]];
+        }
+    }
+    return turns;
+}();
+}
+
+/** The direction pointing the opposite way. */
+template<tabled_direction Enum>
+constexpr Enum opposite_direction(Enum direction)
+{
+    return direction_table<Enum>::opposites[direction];
+}
+
+/** Rotate a direction by a number of clockwise turns.
+ *
+ * Negative turns rotate counter-clockwise.
+ */
+template<tabled_direction Enum>
+constexpr Enum rotate_direction(Enum direction, int turns)
+{
+    constexpr auto period =
+        static_cast<int>(direction_table<Enum>::rotation_period);
+    int const k = ((turns % period) + period) % period;
+    return detail::direction_rotations<Enum>[static_cast<std::size_t>(k)]
+                                            [direction];
+}
+
 /** Convert a ranged_enum to a unit-vector. */
 template<ranged_enum Enum, class Vector>
 struct enum_to_vector {
@@ -61,48 +394,43 @@ Vector direction_as(Enum direction)
     return enum_to_vector<Enum, Vector>{}(direction);
 }
 
-template<field_2d_constructible Vector>
-    requires std::constructible_from<scalar_field_t<Vector>, int>
-
-struct enum_to_vector<cardinal::direction_name, Vector>{
-    Vector operator()(cardinal::direction_name dir) const
-    {
-        std::uint32_t constexpr N = enum_size_v<cardinal::direction_name>;
-        static constexpr std::array<Vector, N> directions{
-            /* north */ Vector{0, 1}, /* east */ Vector{1, 0},
-            /* south */ Vector{0, -1}, /* west */ Vector{-1, 0}
-        };
-        return directions[dir];
+/** Convert every value of a ranged_enum to a unit-vector, in enum order. */
+template<class Vector, ranged_enum Enum>
+std::array<Vector, enum_size_v<Enum>> directions_as()
+{
+    std::array<Vector, enum_size_v<Enum>> directions{};
+    for (std::size_t i = 0; i < directions.size(); ++i) {
+        directions[i] = direction_as<Vector>(static_cast<Enum>(i));
     }
-};
+    return directions;
+}
 
-template<field_2d_constructible Vector>
-requires std::constructible_from<scalar_field_t<Vector>, int>
+template<tabled_direction Enum, field_2d_constructible Vector>
+    requires (direction_table<Enum>::dimensions == 2) and
+             std::constructible_from<scalar_field_t<Vector>, int>
 
-struct enum_to_vector<flat_hex::direction_name, Vector>{
-    Vector operator()(flat_hex::direction_name dir) const
+struct enum_to_vector<Enum, Vector>{
+    constexpr Vector operator()(Enum dir) const
     {
-        std::uint32_t constexpr N = enum_size_v<flat_hex::direction_name>;
-        static constexpr std::array<Vector, N> directions{
-                /* north */ Vector{0, -1}, /* northeast */ Vector{-1, 1}, /* southeast */ Vector{1 , 0},
-                /* south */ Vector{0, 1}, /* southwest */ Vector{-1, 1}, /* northwest */ Vector{-1, 0}
-        };
-        return directions[dir];
+        using Field = scalar_field_t<Vector>;
+        auto const & offset = direction_table<Enum>::offsets[dir];
+        return Vector{static_cast<Field>(offset[0]),
+                      static_cast<Field>(offset[1])};
     }
 };
 
-template<field_2d_constructible Vector>
-requires std::constructible_from<scalar_field_t<Vector>, int>
+template<tabled_direction Enum, field_3d_constructible Vector>
+    requires (direction_table<Enum>::dimensions == 3) and
+             std::constructible_from<scalar_field_t<Vector>, int>
 
-struct enum_to_vector<pointed_hex::direction_name, Vector>{
-    Vector operator()(pointed_hex::direction_name dir) const
+struct enum_to_vector<Enum, Vector>{
+    constexpr Vector operator()(Enum dir) const
     {
-        std::uint32_t constexpr N = enum_size_v<pointed_hex::direction_name>;
-        static constexpr std::array<Vector, N> directions{
-                /* northeast */ Vector{1, -1}, /* east */ Vector{1, 0}, /* southeast */ Vector{0 , 1},
-                /* southwest */ Vector{-1, 1}, /* west */ Vector{-1, 0}, /* northwest */ Vector{0, -1}
-        };
-        return directions[dir];
+        using Field = scalar_field_t<Vector>;
+        auto const & offset = direction_table<Enum>::offsets[dir];
+        return Vector{static_cast<Field>(offset[0]),
+                      static_cast<Field>(offset[1]),
+                      static_cast<Field>(offset[2])};
     }
 };
 }
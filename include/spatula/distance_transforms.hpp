@@ -0,0 +1,297 @@
+#pragma once
+
+// type constraints
+#include <type_traits>
+#include <concepts>
+#include "spatula/execution.hpp"
+
+// data types and algorithms
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <execution>
+#include "spatula/grids.hpp"
+
+namespace sp {
+
+/** The nearest site of a cell when no cell is occupied. */
+constexpr std::size_t no_nearest_site =
+    std::numeric_limits<std::size_t>::max();
+
+namespace detail {
+/** The lower envelope of the parabolas y = (x - site)^2 + f(site).
+ *
+ * Following Felzenszwalb and Huttenlocher, the parabolas of a line of cells
+ * are swept left to right, keeping only those that are lowest somewhere along
+ * with where each one takes over, and the envelope is then read back at every
+ * cell. Both sweeps take linear time.
+ */
+class lower_envelope {
+public:
+    static constexpr std::int64_t no_site =
+        std::numeric_limits<std::int64_t>::max();
+
+    explicit lower_envelope(std::size_t size)
+        : _sites(size), _bounds(size + 1)
+    {
+    }
+
+    /** Find the lowest parabola at every cell.
+     *
+     * Cells whose f is no_site hold no parabola. Where no cell holds one,
+     * every distance is no_site and every nearest site is -1.
+     *
+     * Parameters
+     *   f - the height of the parabola at each cell
+     *   distances - where to write the lowest height at each cell
+     *   nearest - where to write the site of the lowest parabola at each cell
+     */
+    void transform(std::span<std::int64_t const> f,
+                   std::span<std::int64_t> distances, std::span<int> nearest)
+    {
+        constexpr auto infinity = std::numeric_limits<double>::infinity();
+        auto const size = static_cast<int>(f.size());
+        int last = -1;
+        for (int q = 0; q < size; ++q) {
+            if (f[q] == no_site) { continue; }
+            if (last < 0) {
+                last = 0;
+                _sites[0] = q;
+                _bounds[0] = -infinity;
+                _bounds[1] = infinity;
+                continue;
+            }
+            // the integer parts are exact, so rounding the single division
+            // can only reorder parabolas that tie at a cell
+            double crossing;
+            while (true) {
+                auto const v = _sites[last];
+                auto const rise = (f[q] + std::int64_t{q} * q) -
+                                  (f[v] + std::int64_t{v} * v);
+                crossing = static_cast<double>(rise) / (2.0 * (q - v));
+                if (crossing > _bounds[last]) { break; }
+                --last;
+            }
+            ++last;
+            _sites[last] = q;
+            _bounds[last] = crossing;
+            _bounds[last + 1] = infinity;
+        }
+
+        if (last < 0) {
+            std::ranges::fill(distances, no_site);
+            std::ranges::fill(nearest, -1);
+            return;
+        }
+        int k = 0;
+        for (int q = 0; q < size; ++q) {
+            while (_bounds[k + 1] < q) { ++k; }
+            auto const v = _sites[k];
+            distances[q] = std::int64_t{q - v} * (q - v) + f[v];
+            if (not nearest.empty()) { nearest[q] = v; }
+        }
+    }
+private:
+    std::vector<int> _sites;
+    std::vector<double> _bounds;
+};
+
+/** The exact squared distance transform, with nearest sites if wanted.
+ *
+ * Rows are transformed first, giving the squared distance to the nearest site
+ * in the same row, and columns then take the lower envelope of the parabolas
+ * those distances raise. Columns are gathered a band at a time, so that each
+ * row of the band is read as one contiguous run of memory.
+ */
+template<execution_policy Policy, class T>
+grid<std::uint32_t> distance_transform(Policy && policy,
+                                       grid<T> const & occupied,
+                                       grid<std::size_t> * nearest)
+{
+    constexpr std::size_t band_size = 16;
+    constexpr auto no_site = lower_envelope::no_site;
+    auto const width = occupied.width();
+    auto const height = occupied.height();
+    grid<std::uint32_t> distances(width, height, unreachable_distance);
+    if (nearest) { *nearest = grid<std::size_t>(width, height); }
+    if (occupied.empty()) { return distances; }
+
+    // squared distances along each row, and which column they came from
+    grid<std::int64_t> across(width, height);
+    grid<int> site_columns(nearest ? width : 0, nearest ? height : 0);
+    auto const row_bands = (height + band_size - 1) / band_size;
+    for_each_index(policy, row_bands, [&](std::size_t band) {
+        auto const last = std::min(height, (band + 1) * band_size);
+        for (auto y = band * band_size; y < last; ++y) {
+            // with every site at height 0, the lowest parabola is simply the
+            // nearest site, found by a sweep each way along the row
+            auto const cells = occupied.row(y);
+            auto const out = across.row(y);
+            auto const sites = nearest ? site_columns.row(y)
+                                       : std::span<int>{};
+            int site = -1;
+            for (std::size_t x = 0; x < width; ++x) {
+                if (cells[x] != T{}) { site = static_cast<int>(x); }
+                auto const gap = static_cast<std::int64_t>(x) - site;
+                out[x] = site < 0 ? no_site : gap * gap;
+                if (nearest) { sites[x] = site; }
+            }
+            site = -1;
+            for (auto x = width; x-- > 0;) {
+                if (cells[x] != T{}) { site = static_cast<int>(x); }
+                if (site < 0) { continue; }
+                auto const gap = site - static_cast<std::int64_t>(x);
+                if (gap * gap < out[x]) {
+                    out[x] = gap * gap;
+                    if (nearest) { sites[x] = site; }
+                }
+            }
+        }
+    });
+
+    auto const column_bands = (width + band_size - 1) / band_size;
+    for_each_index(std::forward<Policy>(policy), column_bands,
+                   [&](std::size_t band) {
+        lower_envelope envelope(height);
+        auto const first = band * band_size;
+        auto const count = std::min(width, first + band_size) - first;
+        // each column of the band is laid out contiguously
+        std::vector<std::int64_t> f(count * height);
+        std::vector<std::int64_t> down(count * height);
+        std::vector<int> site_rows(nearest ? count * height : 0);
+        for (std::size_t y = 0; y < height; ++y) {
+            auto const row = across.row(y);
+            for (std::size_t i = 0; i < count; ++i) {
+                f[i * height + y] = row[first + i];
+            }
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            auto const column = std::span{f}.subspan(i * height, height);
+            auto const out = std::span{down}.subspan(i * height, height);
+            auto const sites = nearest
+                ? std::span{site_rows}.subspan(i * height, height)
+                : std::span<int>{};
+            envelope.transform(column, out, sites);
+        }
+        for (std::size_t y = 0; y < height; ++y) {
+            auto const row = distances.row(y);
+            for (std::size_t i = 0; i < count; ++i) {
+                auto const d = down[i * height + y];
+                if (d == no_site) { continue; }
+                row[first + i] = static_cast<std::uint32_t>(d);
+            }
+        }
+        if (not nearest) { return; }
+        for (std::size_t y = 0; y < height; ++y) {
+            auto const row = nearest->row(y);
+            for (std::size_t i = 0; i < count; ++i) {
+                auto const site_row = site_rows[i * height + y];
+                if (site_row < 0) {
+                    row[first + i] = no_nearest_site;
+                    continue;
+                }
+                auto const x = first + i;
+                auto const site_y = static_cast<std::size_t>(site_row);
+                auto const site_x = site_columns(static_cast<int>(x), site_row);
+                row[x] = site_y * width + static_cast<std::size_t>(site_x);
+            }
+        }
+    });
+    return distances;
+}
+}
+
+/** Find the exact squared Euclidean distance from every cell to the nearest
+ * occupied cell.
+ *
+ * Cells holding anything other than T{} are occupied, and are at distance 0.
+ * The transform is separable: a pass over rows runs under the execution
+ * policy, then a pass over bands of columns, each in linear time. When no cell
+ * is occupied, every cell is at unreachable_distance.
+ *
+ * Parameters
+ *   policy - the execution policy to schedule bands of rows and columns with
+ *   occupied - the cells to measure distance from
+ *   nearest - where to write the flat index of the occupied cell nearest to
+ *             each cell, or no_nearest_site when there is none
+ *
+ * Note
+ *   Squared distances must fit in 32 bits, so the squared length of the grid's
+ *   diagonal must be less than 2^32.
+ */
+template<execution_policy Policy, class T>
+grid<std::uint32_t> distance_transform(Policy && policy,
+                                       grid<T> const & occupied)
+{
+    return detail::distance_transform(std::forward<Policy>(policy), occupied,
+                                      nullptr);
+}
+
+template<execution_policy Policy, class T>
+grid<std::uint32_t> distance_transform(Policy && policy,
+                                       grid<T> const & occupied,
+                                       grid<std::size_t> & nearest)
+{
+    return detail::distance_transform(std::forward<Policy>(policy), occupied,
+                                      &nearest);
+}
+
+template<class T>
+grid<std::uint32_t> distance_transform(grid<T> const & occupied)
+{
+    return distance_transform(std::execution::seq, occupied);
+}
+
+template<class T>
+grid<std::uint32_t> distance_transform(grid<T> const & occupied,
+                                       grid<std::size_t> & nearest)
+{
+    return distance_transform(std::execution::seq, occupied, nearest);
+}
+
+/** Find the signed Euclidean distance from every cell to the edge between
+ * occupied and empty cells.
+ *
+ * Empty cells are positive and occupied cells negative. Each cell is half a
+ * cell closer to the edge than to the center of the nearest cell across it,
+ * so neighbours on either side of the edge are at 0.5 and -0.5. Where every
+ * cell is on the same side, the distance is infinite.
+ */
+template<execution_policy Policy, class T>
+grid<float> signed_distance_field(Policy && policy, grid<T> const & occupied)
+{
+    grid<std::uint8_t> empty(occupied.width(), occupied.height());
+    std::ranges::transform(occupied, empty.begin(), [](T const & cell) {
+        return static_cast<std::uint8_t>(cell == T{});
+    });
+    auto const outside = distance_transform(policy, occupied);
+    auto const inside = distance_transform(policy, empty);
+
+    grid<float> field(occupied.width(), occupied.height());
+    for_each_index(std::forward<Policy>(policy), field.height(),
+                   [&](std::size_t y) {
+        auto const out = field.row(y);
+        auto const from_occupied = outside.row(y);
+        auto const from_empty = inside.row(y);
+        for (std::size_t x = 0; x < out.size(); ++x) {
+            bool const filled = from_occupied[x] == 0;
+            auto const d = filled ? from_empty[x] : from_occupied[x];
+            auto const length = d == unreachable_distance
+                ? std::numeric_limits<float>::infinity()
+                : std::sqrt(static_cast<float>(d)) - 0.5f;
+            out[x] = filled ? -length : length;
+        }
+    });
+    return field;
+}
+
+template<class T>
+grid<float> signed_distance_field(grid<T> const & occupied)
+{
+    return signed_distance_field(std::execution::seq, occupied);
+}
+}
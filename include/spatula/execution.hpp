@@ -0,0 +1,61 @@
+#pragma once
+
+// type constraints
+#include <type_traits>
+#include <concepts>
+
+// data types and algorithms
+#include <cstddef>
+#include <execution>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+#include <thread>
+
+namespace sp {
+
+/** A standard execution policy, such as std::execution::par. */
+template<class Policy>
+concept execution_policy =
+    std::is_execution_policy_v<std::remove_cvref_t<Policy>>;
+
+/** The most tasks an execution policy may run at once.
+ *
+ * Sequenced and unsequenced policies run every task on the calling thread,
+ * while parallel policies may run one task per hardware thread.
+ */
+template<execution_policy Policy>
+std::size_t concurrency_of(Policy const &)
+{
+    using policy_type = std::remove_cvref_t<Policy>;
+    if constexpr (std::same_as<policy_type, std::execution::sequenced_policy> or
+                  std::same_as<policy_type,
+                               std::execution::unsequenced_policy>) {
+        return 1;
+    }
+    else {
+        return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    }
+}
+
+/** Call a function once for each index in [0, count).
+ *
+ * Parameters
+ *   policy - the execution policy to schedule the calls with
+ *   count - the number of indices to visit
+ *   fn - the function to call with each index
+ *
+ * Note
+ *   The standard parallel algorithms require forward iterators, so the indices
+ *   are materialized up front. Callers should pass a count of tiles or chunks
+ *   rather than a count of individual cells.
+ */
+template<execution_policy Policy, std::invocable<std::size_t> Function>
+void for_each_index(Policy && policy, std::size_t count, Function fn)
+{
+    std::vector<std::size_t> indices(count);
+    std::iota(indices.begin(), indices.end(), std::size_t{0});
+    std::for_each(std::forward<Policy>(policy),
+                  indices.begin(), indices.end(), fn);
+}
+}
@@ -0,0 +1,389 @@
+#pragma once
+
+// type constraints
+#include <type_traits>
+#include <concepts>
+#include <ranges>
+#include "spatula/vectors.hpp"
+#include "spatula/directions.hpp"
+#include "spatula/execution.hpp"
+
+// data types and data structures
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <atomic>
+#include <utility>
+#include <algorithm>
+#include <array>
+#include <vector>
+#include <map>
+#include "spatula/grids.hpp"
+#include "spatula/packed_enums.hpp"
+
+namespace sp {
+
+/** The cost of a cell that can't be entered.
+ *
+ * Cost grids give the cost of stepping into each cell. Every cost must be at
+ * least 1, and the maximum value of the cost type marks a wall.
+ */
+template<std::unsigned_integral Cost>
+constexpr Cost impassable_cost = std::numeric_limits<Cost>::max();
+
+/** The distance to the nearest goal and the direction to step towards it, for
+ * every cell of a grid.
+ *
+ * A single flow field answers "which way should I go?" for any number of
+ * agents heading to the same set of goals, so it's built once per destination
+ * instead of once per agent. Directions are stored in enum_bits_v<Enum> bits
+ * per cell and converted to vectors with sp::direction_as.
+ */
+template<ranged_enum Enum>
+class flow_field {
+public:
+    using direction_type = Enum;
+    using distance_type = std::uint32_t;
+
+    flow_field() = default;
+
+    std::size_t width() const { return _distances.width(); }
+    std::size_t height() const { return _distances.height(); }
+    bool contains(int x, int y) const { return _distances.contains(x, y); }
+
+    /** The total cost of the cheapest path from a cell to any goal.
+     *
+     * Like a Dijkstra map, the total counts the cost of the cell itself and
+     * of every cell along the way, but not the cost of the goal.
+     */
+    distance_type distance(int x, int y) const { return _distances(x, y); }
+    template<grid_coordinate Vector>
+    distance_type distance(Vector const & cell) const
+    {
+        return _distances[cell];
+    }
+
+    /** The direction to step from a cell towards the nearest goal.
+     *
+     * The direction is unspecified for goals and unreachable cells.
+     */
+    Enum direction(int x, int y) const
+    {
+        return _directions[_distances.index_of(x, y)];
+    }
+    template<grid_coordinate Vector>
+    Enum direction(Vector const & cell) const
+    {
+        return _directions[_distances.index_of(cell)];
+    }
+
+    bool reachable(int x, int y) const
+    {
+        return distance(x, y) != unreachable_distance;
+    }
+    template<grid_coordinate Vector>
+    bool reachable(Vector const & cell) const
+    {
+        return distance(cell) != unreachable_distance;
+    }
+
+    grid<distance_type> const & distances() const { return _distances; }
+    packed_enum_vector<Enum> const & directions() const { return _directions; }
+    std::vector<grid_point> const & goals() const { return _goals; }
+
+    /** Recompute the whole field from a cost grid and a set of goals.
+     *
+     * Distances are found with a bucketed multi-source Dijkstra search. All
+     * cells in a bucket share the same final distance, so each wavefront is
+     * relaxed in parallel. Directions are then chosen independently per cell.
+     *
+     * Parameters
+     *   policy - the execution policy to relax wavefronts and pick directions
+     *   costs - the cost of stepping into each cell
+     *   goals - the cells to flow towards
+     */
+    template<execution_policy Policy, std::unsigned_integral Cost,
+             ranges::input_range Range>
+        requires grid_coordinate<ranges::range_value_t<Range>>
+    void rebuild(Policy && policy, grid<Cost> const & costs, Range && goals)
+    {
+        _distances = grid<distance_type>(costs.width(), costs.height(),
+                                         unreachable_distance);
+        _directions = packed_enum_vector<Enum>(costs.size());
+        _goals.clear();
+
+        bucket_queue buckets;
+        for (auto const & goal : goals) {
+            if (not costs.contains(goal)) { continue; }
+            auto const cell = costs.index_of(goal);
+            if (_distances[cell] == 0) { continue; }
+
+            _distances[cell] = 0;
+            _goals.push_back(costs.point_of(cell));
+            buckets[0].push_back(cell);
+        }
+        propagate(policy, costs, buckets);
+        update_directions(policy);
+    }
+
+    /** Update the field after the cost of a few cells has changed.
+     *
+     * Only the cells whose cheapest path ran through a changed cell are
+     * invalidated. They're reseeded from their valid neighbors and the
+     * search resumes from there, along with any cells that got cheaper. This
+     * keeps the work proportional to the region that actually changes
+     * instead of the size of the grid.
+     *
+     * Parameters
+     *   policy - the execution policy to relax wavefronts with
+     *   costs - the cost grid the field was built from, after the changes
+     *   changed_cells - the cells whose cost changed
+     */
+    template<execution_policy Policy, std::unsigned_integral Cost,
+             ranges::input_range Range>
+        requires grid_coordinate<ranges::range_value_t<Range>>
+    void repair(Policy && policy, grid<Cost> const & costs,
+                Range && changed_cells)
+    {
+        auto const offsets = directions_as<grid_point, Enum>();
+
+        // invalidate every cell whose path to a goal led through a change
+        std::vector<std::size_t> invalid;
+        for (auto const & changed : changed_cells) {
+            if (not costs.contains(changed)) { continue; }
+            auto const cell = costs.index_of(changed);
+            // goals stay put no matter what their own cost is
+            if (_distances[cell] == 0) { continue; }
+
+            _distances[cell] = unreachable_distance;
+            invalid.push_back(cell);
+        }
+        for (std::size_t i = 0; i < invalid.size(); ++i) {
+            auto const [x, y] = _distances.point_of(invalid[i]);
+            for (auto const & offset : offsets) {
+                int const nx = x + offset.x;
+                int const ny = y + offset.y;
+                if (not _distances.contains(nx, ny)) { continue; }
+
+                std::size_t const neighbor = _distances.index_of(nx, ny);
+                if (_distances[neighbor] == 0 or
+                    _distances[neighbor] == unreachable_distance) {
+                    continue;
+                }
+                auto const step = offsets[_directions[neighbor]];
+                if (nx + step.x == x and ny + step.y == y) {
+                    _distances[neighbor] = unreachable_distance;
+                    invalid.push_back(neighbor);
+                }
+            }
+        }
+
+        // reseed the invalidated region from the cells that are still valid
+        bucket_queue buckets;
+        for (std::size_t const cell : invalid) {
+            Cost const cost = costs[cell];
+            if (cost == impassable_cost<Cost>) { continue; }
+
+            auto const [x, y] = _distances.point_of(cell);
+            distance_type best = unreachable_distance;
+            for (auto const & offset : offsets) {
+                int const nx = x + offset.x;
+                int const ny = y + offset.y;
+                if (_distances.contains(nx, ny)) {
+                    best = std::min(best, _distances(nx, ny));
+                }
+            }
+            if (best == unreachable_distance) { continue; }
+
+            _distances[cell] = detail::add_distance(best, cost);
+            buckets[_distances[cell]].push_back(cell);
+        }
+        std::vector<std::size_t> changed = invalid;
+        propagate(policy, costs, buckets, &changed);
+
+        // any cell next to a changed distance may have a new best neighbor
+        for (std::size_t const cell : changed) {
+            update_direction(cell, offsets);
+            auto const [x, y] = _distances.point_of(cell);
+            for (auto const & offset : offsets) {
+                int const nx = x + offset.x;
+                int const ny = y + offset.y;
+                if (_distances.contains(nx, ny)) {
+                    update_direction(_distances.index_of(nx, ny), offsets);
+                }
+            }
+        }
+    }
+
+    template<std::unsigned_integral Cost, ranges::input_range Range>
+        requires grid_coordinate<ranges::range_value_t<Range>>
+    void repair(grid<Cost> const & costs, Range && changed_cells)
+    {
+        repair(std::execution::seq, costs, std::forward<Range>(changed_cells));
+    }
+private:
+    using bucket_queue = std::map<distance_type, std::vector<std::size_t>>;
+
+    /** The number of frontier cells relaxed by a single task. */
+    static constexpr std::size_t frontier_chunk = 1024;
+
+    /** Relax wavefronts in order of distance until the queue is empty.
+     *
+     * Every cell whose distance improves is appended to improved_cells, if
+     * it's given.
+     */
+    template<execution_policy Policy, std::unsigned_integral Cost>
+    void propagate(Policy && policy, grid<Cost> const & costs,
+                   bucket_queue & buckets,
+                   std::vector<std::size_t> * improved_cells = nullptr)
+    {
+        using improvement = std::pair<std::size_t, distance_type>;
+        auto const offsets = directions_as<grid_point, Enum>();
+
+        while (not buckets.empty()) {
+            auto node = buckets.extract(buckets.begin());
+            distance_type const distance = node.key();
+            auto const & frontier = node.mapped();
+
+            std::size_t const chunks =
+                (frontier.size() + frontier_chunk - 1) / frontier_chunk;
+            std::vector<std::vector<improvement>> improved(chunks);
+
+            for_each_index(policy, chunks, [&](std::size_t chunk) {
+                std::size_t const first = chunk * frontier_chunk;
+                std::size_t const last =
+                    std::min(first + frontier_chunk, frontier.size());
+
+                for (std::size_t i = first; i < last; ++i) {
+                    std::size_t const cell = frontier[i];
+                    std::atomic_ref<distance_type> const current{
+                        _distances[cell]
+                    };
+                    // a cheaper path was found after this entry was queued
+                    if (current.load(std::memory_order_relaxed) != distance) {
+                        continue;
+                    }
+                    auto const [x, y] = costs.point_of(cell);
+                    for (auto const & offset : offsets) {
+                        int const nx = x + offset.x;
+                        int const ny = y + offset.y;
+                        if (not costs.contains(nx, ny)) { continue; }
+
+                        std::size_t const neighbor = costs.index_of(nx, ny);
+                        Cost const cost = costs[neighbor];
+                        if (cost == impassable_cost<Cost>) { continue; }
+
+                        distance_type const candidate =
+                            detail::add_distance(distance, cost);
+                        std::atomic_ref<distance_type> target{
+                            _distances[neighbor]
+                        };
+                        auto known = target.load(std::memory_order_relaxed);
+                        while (candidate < known) {
+                            if (target.compare_exchange_weak(
+                                    known, candidate,
+                                    std::memory_order_relaxed)) {
+                                improved[chunk].emplace_back(neighbor,
+                                                             candidate);
+                                break;
+                            }
+                        }
+                    }
+                }
+            });
+            // only queue the cheapest improvement found for each cell
+            for (auto const & improvements : improved) {
+                for (auto const & [cell, candidate] : improvements) {
+                    if (_distances[cell] != candidate) { continue; }
+                    buckets[candidate].push_back(cell);
+                    if (improved_cells) { improved_cells->push_back(cell); }
+                }
+            }
+        }
+    }
+
+    /** Point a cell towards its cheapest neighbor. */
+    void update_direction(std::size_t cell,
+                          std::array<grid_point, enum_size_v<Enum>> const &
+                          offsets)
+    {
+        distance_type const distance = _distances[cell];
+        if (distance == 0 or distance == unreachable_distance) {
+            _directions.set(cell, Enum{});
+            return;
+        }
+        auto const [x, y] = _distances.point_of(cell);
+        distance_type best = unreachable_distance;
+        std::size_t best_direction = 0;
+        for (std::size_t i = 0; i < offsets.size(); ++i) {
+            int const nx = x + offsets[i].x;
+            int const ny = y + offsets[i].y;
+            if (not _distances.contains(nx, ny)) { continue; }
+
+            distance_type const neighbor = _distances(nx, ny);
+            if (neighbor < best) {
+                best = neighbor;
+                best_direction = i;
+            }
+        }
+        _directions.set(cell, static_cast<Enum>(best_direction));
+    }
+
+    /** Point every cell towards its cheapest neighbor. */
+    template<execution_policy Policy>
+    void update_directions(Policy && policy)
+    {
+        // chunks cover whole words so that no two tasks write the same word
+        constexpr std::size_t chunk =
+            packed_enum_vector<Enum>::values_per_word * 64;
+        std::size_t const chunks = (_distances.size() + chunk - 1) / chunk;
+        auto const offsets = directions_as<grid_point, Enum>();
+
+        for_each_index(policy, chunks, [&](std::size_t i) {
+            std::size_t const first = i * chunk;
+            std::size_t const last = std::min(first + chunk, _distances.size());
+            for (std::size_t cell = first; cell < last; ++cell) {
+                update_direction(cell, offsets);
+            }
+        });
+    }
+
+    grid<distance_type> _distances;
+    packed_enum_vector<Enum> _directions;
+    std::vector<grid_point> _goals;
+};
+
+/** Build a flow field towards one or more goals.
+ *
+ * Parameters
+ *   policy - the execution policy to build the field with
+ *   costs - the cost of stepping into each cell, where the maximum value of
+ *           the cost type marks a wall
+ *   goals - the cells to flow towards
+ *
+ * Example
+ *   auto const field = sp::build_flow_field<sp::cardinal::direction_name>(
+ *       std::execution::par, costs, goals);
+ *   auto const step = sp::direction_as<SDL_Point>(field.direction(unit));
+ */
+template<ranged_enum Enum, execution_policy Policy,
+         std::unsigned_integral Cost, ranges::input_range Range>
+    requires grid_coordinate<ranges::range_value_t<Range>>
+flow_field<Enum> build_flow_field(Policy && policy, grid<Cost> const & costs,
+                                  Range && goals)
+{
+    flow_field<Enum> field;
+    field.rebuild(std::forward<Policy>(policy), costs,
+                  std::forward<Range>(goals));
+    return field;
+}
+
+template<ranged_enum Enum, std::unsigned_integral Cost,
+         ranges::input_range Range>
+    requires grid_coordinate<ranges::range_value_t<Range>>
+flow_field<Enum> build_flow_field(grid<Cost> const & costs, Range && goals)
+{
+    return build_flow_field<Enum>(std::execution::seq, costs,
+                                  std::forward<Range>(goals));
+}
+}
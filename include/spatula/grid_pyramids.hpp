@@ -0,0 +1,328 @@
+#pragma once
+
+// type constraints
+#include <type_traits>
+#include <concepts>
+#include <functional>
+#include "spatula/execution.hpp"
+
+// data types and data structures
+#include <cstddef>
+#include <vector>
+#include <span>
+#include <optional>
+#include <algorithm>
+#include <execution>
+#include "spatula/grids.hpp"
+
+namespace sp {
+
+/** Reduce two cells to the greater of them. */
+struct reduce_max {
+    template<std::totally_ordered T>
+    T operator()(T const & a, T const & b) const { return b > a ? b : a; }
+};
+
+/** Reduce two cells to the lesser of them. */
+struct reduce_min {
+    template<std::totally_ordered T>
+    T operator()(T const & a, T const & b) const { return b < a ? b : a; }
+};
+
+/** A function that combines two cells into one, the same in any order. */
+template<class Reducer, class T>
+concept cell_reducer = std::regular_invocable<Reducer const &, T const &,
+                                              T const &> and
+    std::convertible_to<std::invoke_result_t<Reducer const &, T const &,
+                                             T const &>, T>;
+
+/** A grid along with successively halved levels of itself.
+ *
+ * Each cell of level k + 1 reduces the two by two block of cells below it in
+ * level k, and level 0 is the grid itself. Blocks along the right and bottom
+ * edges of a level with an odd width or height reduce only the cells they
+ * have. The reducer should give the same result however cells are grouped,
+ * like reduce_max, reduce_min, std::plus<> or std::bit_or<>.
+ *
+ * Coarse levels answer for large regions of the grid at once, so queries over
+ * a region only visit the cells along its edges at each level, and searches
+ * can skip any block whose reduction rules it out.
+ */
+template<class T, cell_reducer<T> Reducer>
+class grid_pyramid {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    grid_pyramid() = default;
+    explicit grid_pyramid(grid<T> const & cells, Reducer reduce = Reducer{})
+        : _reduce{std::move(reduce)}
+    {
+        rebuild(cells);
+    }
+
+    size_type width() const { return base().width(); }
+    size_type height() const { return base().height(); }
+
+    /** The number of levels, including the grid itself. */
+    size_type levels() const { return _levels.size(); }
+
+    /** A single level, where level 0 is the grid itself. */
+    grid<T> const & level(size_type k) const { return _levels[k]; }
+    grid<T> const & base() const { return _levels.front(); }
+
+    /** Copy a grid and build every level above it.
+     *
+     * Each level is reduced from the one below a row at a time: pairs of rows
+     * are reduced cell by cell into a row buffer, and then pairs of
+     * neighbouring cells. Rows of each level are scheduled under the
+     * execution policy.
+     */
+    template<execution_policy Policy>
+    void rebuild(Policy && policy, grid<T> const & cells)
+    {
+        _levels.clear();
+        _levels.push_back(cells);
+        while (_levels.back().width() > 1 or _levels.back().height() > 1) {
+            auto const & below = _levels.back();
+            grid<T> above((below.width() + 1) / 2, (below.height() + 1) / 2);
+            for_each_index(policy, above.height(), [&](size_type y) {
+                std::vector<T> pairs(below.width());
+                reduce_row(below, above, y, pairs);
+            });
+            _levels.push_back(std::move(above));
+        }
+    }
+    void rebuild(grid<T> const & cells)
+    {
+        rebuild(std::execution::seq, cells);
+    }
+
+    /** Change a single cell, and the one cell above it in each level. */
+    void set(int x, int y, T const & value)
+    {
+        _levels.front()(x, y) = value;
+        for (size_type k = 1; k < _levels.size(); ++k) {
+            x /= 2;
+            y /= 2;
+            _levels[k](x, y) = reduce_block(k - 1, x, y);
+        }
+    }
+    template<grid_coordinate Vector>
+    void set(Vector const & cell, T const & value)
+    {
+        auto const point = to_grid_point(cell);
+        set(point.x, point.y, value);
+    }
+
+    /** Copy the cells from first to last, inclusive, and rebuild the blocks
+     * above them in each level.
+     *
+     * Parameters
+     *   cells - a grid the same size as the base, with the new values
+     *   first, last - the corners of the region that changed
+     */
+    void update(grid<T> const & cells, grid_point first, grid_point last)
+    {
+        auto region = detail::clip_region(first, last, width(), height());
+        if (region.empty()) { return; }
+        for (auto y = region.y0; y < region.y1; ++y) {
+            auto const from = cells.row(y);
+            std::ranges::copy(from.subspan(region.x0, region.x1 - region.x0),
+                              _levels.front().row(y).begin() + region.x0);
+        }
+        for (size_type k = 1; k < _levels.size(); ++k) {
+            region = detail::cell_region{region.x0 / 2, region.y0 / 2,
+                                         (region.x1 + 1) / 2,
+                                         (region.y1 + 1) / 2};
+            for (auto y = region.y0; y < region.y1; ++y) {
+                for (auto x = region.x0; x < region.x1; ++x) {
+                    _levels[k](static_cast<int>(x), static_cast<int>(y)) =
+                        reduce_block(k - 1, static_cast<int>(x),
+                                     static_cast<int>(y));
+                }
+            }
+        }
+    }
+    template<grid_rect Rect>
+    void update(grid<T> const & cells, Rect const & rect)
+    {
+        update(cells, detail::rect_first(rect), detail::rect_last(rect));
+    }
+
+    /** Reduce every cell from first to last, inclusive.
+     *
+     * At each level, the cells along the edges of the region that don't fill
+     * a whole block of the next level are reduced directly, and the rest of
+     * the region moves up a level, so a region of any size takes a few cells
+     * per level. The region is clipped to the grid, and there is no result
+     * when it misses the grid entirely.
+     */
+    std::optional<T> reduce(grid_point first, grid_point last) const
+    {
+        auto region = detail::clip_region(first, last, width(), height());
+        std::optional<T> result;
+        for (size_type k = 0; k < _levels.size() and not region.empty();
+             ++k) {
+            auto const & cells = _levels[k];
+            // an end closes a block of the next level when it is even, or
+            // when it is the edge of the level
+            auto const closes_block = [](size_type end, size_type size) {
+                return end % 2 == 0 or end == size;
+            };
+            if (region.x0 % 2 == 1) {
+                reduce_cells(cells, {region.x0, region.y0,
+                                     region.x0 + 1, region.y1}, result);
+                ++region.x0;
+            }
+            if (not closes_block(region.x1, cells.width()) and
+                region.x0 < region.x1) {
+                reduce_cells(cells, {region.x1 - 1, region.y0,
+                                     region.x1, region.y1}, result);
+                --region.x1;
+            }
+            if (region.y0 % 2 == 1 and region.x0 < region.x1) {
+                reduce_cells(cells, {region.x0, region.y0,
+                                     region.x1, region.y0 + 1}, result);
+                ++region.y0;
+            }
+            if (not closes_block(region.y1, cells.height()) and
+                region.y0 < region.y1 and region.x0 < region.x1) {
+                reduce_cells(cells, {region.x0, region.y1 - 1,
+                                     region.x1, region.y1}, result);
+                --region.y1;
+            }
+            if (k + 1 == _levels.size()) {
+                reduce_cells(cells, region, result);
+                break;
+            }
+            region = detail::cell_region{region.x0 / 2, region.y0 / 2,
+                                         (region.x1 + 1) / 2,
+                                         (region.y1 + 1) / 2};
+        }
+        return result;
+    }
+    template<grid_rect Rect>
+    std::optional<T> reduce(Rect const & rect) const
+    {
+        return reduce(detail::rect_first(rect), detail::rect_last(rect));
+    }
+
+    /** Find a cell from first to last, inclusive, that satisfies a predicate.
+     *
+     * The search starts from the coarsest level and only looks inside blocks
+     * whose reduction satisfies the predicate, so the predicate must hold for
+     * the reduction of any block holding a cell that satisfies it. A search
+     * for any cell over a height limit of a reduce_max pyramid, for example,
+     * skips every block whose greatest cell is under the limit, and stops at
+     * the first cell it finds.
+     */
+    template<std::predicate<T const &> Predicate>
+    std::optional<grid_point> find(grid_point first, grid_point last,
+                                   Predicate predicate) const
+    {
+        auto const region = detail::clip_region(first, last, width(),
+                                                height());
+        if (region.empty()) { return std::nullopt; }
+        return search(_levels.size() - 1, 0, 0, region, predicate);
+    }
+    template<grid_rect Rect, std::predicate<T const &> Predicate>
+    std::optional<grid_point> find(Rect const & rect,
+                                   Predicate predicate) const
+    {
+        return find(detail::rect_first(rect), detail::rect_last(rect),
+                    std::move(predicate));
+    }
+private:
+    /** Reduce a row of one level from the two rows below it. */
+    void reduce_row(grid<T> const & below, grid<T> & above, size_type y,
+                    std::vector<T> & pairs) const
+    {
+        auto const top = below.row(2 * y);
+        if (2 * y + 1 < below.height()) {
+            auto const bottom = below.row(2 * y + 1);
+            for (size_type x = 0; x < top.size(); ++x) {
+                pairs[x] = _reduce(top[x], bottom[x]);
+            }
+        }
+        else {
+            std::ranges::copy(top, pairs.begin());
+        }
+        auto const out = above.row(y);
+        auto const whole = top.size() / 2;
+        for (size_type x = 0; x < whole; ++x) {
+            out[x] = _reduce(pairs[2 * x], pairs[2 * x + 1]);
+        }
+        if (whole < out.size()) { out[whole] = pairs[2 * whole]; }
+    }
+
+    /** Reduce the block of level k below the cell (x, y) of level k + 1. */
+    T reduce_block(size_type k, int x, int y) const
+    {
+        auto const & below = _levels[k];
+        auto result = below(2 * x, 2 * y);
+        if (below.contains(2 * x + 1, 2 * y)) {
+            result = _reduce(result, below(2 * x + 1, 2 * y));
+        }
+        if (below.contains(2 * x, 2 * y + 1)) {
+            result = _reduce(result, below(2 * x, 2 * y + 1));
+        }
+        if (below.contains(2 * x + 1, 2 * y + 1)) {
+            result = _reduce(result, below(2 * x + 1, 2 * y + 1));
+        }
+        return result;
+    }
+
+    void reduce_cells(grid<T> const & cells,
+                      detail::cell_region const & region,
+                      std::optional<T> & result) const
+    {
+        for (auto y = region.y0; y < region.y1; ++y) {
+            auto const row = cells.row(y);
+            for (auto x = region.x0; x < region.x1; ++x) {
+                result = result ? _reduce(*result, row[x]) : row[x];
+            }
+        }
+    }
+
+    template<class Predicate>
+    std::optional<grid_point> search(size_type k, size_type x, size_type y,
+                                     detail::cell_region const & region,
+                                     Predicate & predicate) const
+    {
+        // the cells of the base this block covers
+        auto const x0 = x << k;
+        auto const y0 = y << k;
+        auto const x1 = (x + 1) << k;
+        auto const y1 = (y + 1) << k;
+        bool const overlaps = x0 < region.x1 and region.x0 < x1 and
+                              y0 < region.y1 and region.y0 < y1;
+        auto const & cells = _levels[k];
+        if (not overlaps or
+            not predicate(cells(static_cast<int>(x), static_cast<int>(y)))) {
+            return std::nullopt;
+        }
+        if (k == 0) {
+            return grid_point{static_cast<int>(x), static_cast<int>(y)};
+        }
+        auto const & below = _levels[k - 1];
+        for (size_type dy = 0; dy < 2; ++dy) {
+            for (size_type dx = 0; dx < 2; ++dx) {
+                auto const cx = 2 * x + dx;
+                auto const cy = 2 * y + dy;
+                if (cx >= below.width() or cy >= below.height()) { continue; }
+                if (auto found = search(k - 1, cx, cy, region, predicate)) {
+                    return found;
+                }
+            }
+        }
+        return std::nullopt;
+    }
+
+    Reducer _reduce{};
+    std::vector<grid<T>> _levels{grid<T>{}};
+};
+
+template<class T, cell_reducer<T> Reducer>
+grid_pyramid(grid<T> const &, Reducer) -> grid_pyramid<T, Reducer>;
+}
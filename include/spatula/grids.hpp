@@ -0,0 +1,221 @@
+#pragma once
+
+// type constraints
+#include <type_traits>
+#include <concepts>
+#include "spatula/vectors.hpp"
+
+// data types and data structures
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <span>
+#include <algorithm>
+
+namespace sp {
+
+/** The distance of a cell that can't reach any goal. */
+constexpr std::uint32_t unreachable_distance =
+    std::numeric_limits<std::uint32_t>::max();
+
+/** The integer coordinates of a cell on a grid. */
+struct grid_point {
+    int x, y;
+    friend constexpr bool operator==(grid_point const &,
+                                     grid_point const &) = default;
+};
+
+/** The integer coordinates of a cell in a three-dimensional voxel grid. */
+struct voxel_point {
+    int x, y, z;
+    friend constexpr bool operator==(voxel_point const &,
+                                     voxel_point const &) = default;
+};
+
+/** A cell on a grid given as any integral semivector2. */
+template<class Vector>
+concept grid_coordinate =
+    semivector2<Vector> and std::integral<scalar_field_t<Vector>>;
+
+/** Something with a width and a height, like a grid, to clip to. */
+template<class Grid>
+concept grid_bounds = requires(Grid const & grid) {
+    { grid.width() } -> std::convertible_to<std::size_t>;
+    { grid.height() } -> std::convertible_to<std::size_t>;
+};
+
+/** A rectangle of cells given by its corner and size, such as SDL_Rect. */
+template<class Rect>
+concept grid_rect = requires(Rect const & rect) {
+    requires std::integral<decltype(rect.x)>;
+    requires std::integral<decltype(rect.y)>;
+    requires std::integral<decltype(rect.w)>;
+    requires std::integral<decltype(rect.h)>;
+};
+
+/** Convert any grid coordinate to a grid_point. */
+template<grid_coordinate Vector>
+grid_point to_grid_point(Vector const & cell)
+{
+    return grid_point{static_cast<int>(get_x(cell)),
+                      static_cast<int>(get_y(cell))};
+}
+
+namespace detail {
+/** Add a cost to a distance.
+ *
+ * The sum is taken in 64 bits and saturates just below unreachable_distance,
+ * so that wide cost types can't wrap around or be truncated into a shorter
+ * path.
+ */
+template<std::unsigned_integral Cost>
+constexpr std::uint32_t add_distance(std::uint32_t distance, Cost cost)
+{
+    constexpr std::uint64_t farthest = unreachable_distance - 1;
+    std::uint64_t const sum = static_cast<std::uint64_t>(distance) +
+                              static_cast<std::uint64_t>(cost);
+    return static_cast<std::uint32_t>(std::min(sum, farthest));
+}
+
+/** A rectangle of cells from x0 and y0 up to but not including x1 and y1. */
+struct cell_region {
+    std::size_t x0, y0, x1, y1;
+
+    bool empty() const { return x0 >= x1 or y0 >= y1; }
+};
+
+/** Clip the cells from first to last, inclusive, to a grid's bounds. */
+inline cell_region clip_region(grid_point first, grid_point last,
+                               std::size_t width, std::size_t height)
+{
+    auto const clamp = [](int value, std::size_t size) {
+        auto const high = static_cast<std::int64_t>(size);
+        return static_cast<std::size_t>(
+            std::clamp<std::int64_t>(value, 0, high));
+    };
+    return cell_region{clamp(first.x, width), clamp(first.y, height),
+                       clamp(std::max(last.x, first.x - 1) + 1, width),
+                       clamp(std::max(last.y, first.y - 1) + 1, height)};
+}
+
+template<grid_rect Rect>
+grid_point rect_first(Rect const & rect)
+{
+    return grid_point{static_cast<int>(rect.x), static_cast<int>(rect.y)};
+}
+
+template<grid_rect Rect>
+grid_point rect_last(Rect const & rect)
+{
+    return grid_point{static_cast<int>(rect.x + rect.w) - 1,
+                      static_cast<int>(rect.y + rect.h) - 1};
+}
+}
+
+/** A dense two-dimensional array of cells, stored row by row.
+ *
+ * Cells are addressed either by their (x, y) coordinates, by any semivector2
+ * with integral components, or by their flat index y * width + x.
+ *
+ * Note
+ *   grid<bool> is disallowed because std::vector<bool> can't hand out spans
+ *   over its rows. Use std::uint8_t for occupancy grids instead.
+ */
+template<class T>
+    requires (not std::same_as<T, bool>)
+class grid {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using reference = T &;
+    using const_reference = T const &;
+    using iterator = typename std::vector<T>::iterator;
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    grid() = default;
+    grid(size_type width, size_type height, T const & value = T{})
+        : _width{width}, _height{height}, _cells(width * height, value)
+    {
+    }
+
+    size_type width() const { return _width; }
+    size_type height() const { return _height; }
+    size_type size() const { return _cells.size(); }
+    bool empty() const { return _cells.empty(); }
+
+    T * data() { return _cells.data(); }
+    T const * data() const { return _cells.data(); }
+
+    iterator begin() { return _cells.begin(); }
+    iterator end() { return _cells.end(); }
+    const_iterator begin() const { return _cells.begin(); }
+    const_iterator end() const { return _cells.end(); }
+
+    /** Determine if a coordinate lies within the grid. */
+    bool contains(int x, int y) const
+    {
+        return x >= 0 and y >= 0 and
+               static_cast<size_type>(x) < _width and
+               static_cast<size_type>(y) < _height;
+    }
+    template<grid_coordinate Vector>
+    bool contains(Vector const & cell) const
+    {
+        return contains(static_cast<int>(get_x(cell)),
+                        static_cast<int>(get_y(cell)));
+    }
+
+    /** The flat index of a coordinate, assuming it lies within the grid. */
+    size_type index_of(int x, int y) const
+    {
+        return static_cast<size_type>(y) * _width + static_cast<size_type>(x);
+    }
+    template<grid_coordinate Vector>
+    size_type index_of(Vector const & cell) const
+    {
+        return index_of(static_cast<int>(get_x(cell)),
+                        static_cast<int>(get_y(cell)));
+    }
+
+    /** The coordinate of a flat index. */
+    grid_point point_of(size_type index) const
+    {
+        return grid_point{static_cast<int>(index % _width),
+                          static_cast<int>(index / _width)};
+    }
+
+    T & operator()(int x, int y) { return _cells[index_of(x, y)]; }
+    T const & operator()(int x, int y) const { return _cells[index_of(x, y)]; }
+
+    T & operator[](size_type index) { return _cells[index]; }
+    T const & operator[](size_type index) const { return _cells[index]; }
+
+    template<grid_coordinate Vector>
+    T & operator[](Vector const & cell) { return _cells[index_of(cell)]; }
+
+    template<grid_coordinate Vector>
+    T const & operator[](Vector const & cell) const
+    {
+        return _cells[index_of(cell)];
+    }
+
+    /** The cells of a single row. */
+    std::span<T> row(size_type y)
+    {
+        return std::span<T>{_cells.data() + y * _width, _width};
+    }
+    std::span<T const> row(size_type y) const
+    {
+        return std::span<T const>{_cells.data() + y * _width, _width};
+    }
+
+    void fill(T const & value) { std::ranges::fill(_cells, value); }
+
+    friend bool operator==(grid const &, grid const &) = default;
+private:
+    size_type _width = 0;
+    size_type _height = 0;
+    std::vector<T> _cells;
+};
+}
@@ -0,0 +1,320 @@
+#pragma once
+
+// type constraints
+#include <type_traits>
+#include <concepts>
+#include "spatula/vectors.hpp"
+#include "spatula/directions.hpp"
+
+// data types and data structures
+#include <cstddef>
+#include <array>
+#include <vector>
+#include <span>
+#include <algorithm>
+#include "spatula/grids.hpp"
+#include "spatula/hexes.hpp"
+
+namespace sp {
+
+/** A hexagon-shaped map of hexes, stored densely row by row.
+ *
+ * The map holds every hex within radius steps of the origin. Row r holds the
+ * hexes with that r coordinate, from the smallest q to the largest, and rows
+ * are stored without padding, so no corner of a bounding square is wasted.
+ *
+ * Axial coordinates map to flat indices with closed-form arithmetic. Since rows
+ * have different lengths, the index offset of each neighbour depends on the
+ * row, so neighbour_deltas gives one precomputed set of offsets per row, in the
+ * order of the Enum direction table.
+ */
+template<class T, hex_layout Enum = pointed_hex::direction_name>
+    requires (not std::same_as<T, bool>)
+class hexagon_map {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using reference = T &;
+    using const_reference = T const &;
+    using iterator = typename std::vector<T>::iterator;
+    using const_iterator = typename std::vector<T>::const_iterator;
+    using neighbour_offsets = std::array<std::ptrdiff_t, enum_size_v<Enum>>;
+
+    hexagon_map() = default;
+    explicit hexagon_map(int radius, T const & value = T{})
+        : _radius{std::max(radius, 0)},
+          _cells(static_cast<size_type>(detail::hex_area(_radius)), value)
+    {
+        auto const steps = directions_as<hex_point, Enum>();
+        _deltas.resize(static_cast<size_type>(2 * _radius + 1));
+        for (int r = -_radius; r <= _radius; ++r) {
+            auto & deltas = _deltas[static_cast<size_type>(r + _radius)];
+            for (size_type i = 0; i < steps.size(); ++i) {
+                // flat indices are linear in q within a row, so the offset
+                // between neighbours is the same anywhere along the row
+                deltas[i] = offset_of(steps[i].q, r + steps[i].r) -
+                            offset_of(0, r);
+            }
+        }
+    }
+
+    int radius() const { return _radius; }
+    size_type size() const { return _cells.size(); }
+    bool empty() const { return _cells.empty(); }
+
+    T * data() { return _cells.data(); }
+    T const * data() const { return _cells.data(); }
+
+    iterator begin() { return _cells.begin(); }
+    iterator end() { return _cells.end(); }
+    const_iterator begin() const { return _cells.begin(); }
+    const_iterator end() const { return _cells.end(); }
+
+    /** Determine if a hex lies within the map. */
+    bool contains(int q, int r) const
+    {
+        int const s = -q - r;
+        return std::max({q, -q, r, -r, s, -s}) <= _radius;
+    }
+    template<grid_coordinate Hex>
+    bool contains(Hex const & hex) const
+    {
+        return contains(static_cast<int>(get_x(hex)),
+                        static_cast<int>(get_y(hex)));
+    }
+
+    /** The flat index of a hex, assuming it lies within the map. */
+    size_type index_of(int q, int r) const
+    {
+        return static_cast<size_type>(offset_of(q, r));
+    }
+    template<grid_coordinate Hex>
+    size_type index_of(Hex const & hex) const
+    {
+        return index_of(static_cast<int>(get_x(hex)),
+                        static_cast<int>(get_y(hex)));
+    }
+
+    /** The hex of a flat index. */
+    hex_point hex_of(size_type index) const
+    {
+        // binary search for the last row that starts at or before the index
+        auto const i = static_cast<std::ptrdiff_t>(index);
+        int low = -_radius;
+        int high = _radius;
+        while (low < high) {
+            int const mid = low + (high - low + 1) / 2;
+            if (static_cast<std::ptrdiff_t>(row_start(mid)) <= i) {
+                low = mid;
+            }
+            else {
+                high = mid - 1;
+            }
+        }
+        int const first_q = -_radius - std::min(low, 0);
+        auto const along = i - static_cast<std::ptrdiff_t>(row_start(low));
+        return hex_point{first_q + static_cast<int>(along), low};
+    }
+
+    T & operator()(int q, int r) { return _cells[index_of(q, r)]; }
+    T const & operator()(int q, int r) const
+    {
+        return _cells[index_of(q, r)];
+    }
+
+    T & operator[](size_type index) { return _cells[index]; }
+    T const & operator[](size_type index) const { return _cells[index]; }
+
+    template<grid_coordinate Hex>
+    T & operator[](Hex const & hex) { return _cells[index_of(hex)]; }
+
+    template<grid_coordinate Hex>
+    T const & operator[](Hex const & hex) const
+    {
+        return _cells[index_of(hex)];
+    }
+
+    /** The hexes of a single row, from the smallest q to the largest. */
+    std::span<T> row(int r)
+    {
+        return std::span<T>{_cells.data() + row_start(r), row_size(r)};
+    }
+    std::span<T const> row(int r) const
+    {
+        return std::span<T const>{_cells.data() + row_start(r), row_size(r)};
+    }
+
+    /** The index offsets of each neighbour of a hex in row r.
+     *
+     * The neighbour of the hex at index i in direction d is at index
+     * i + neighbour_deltas(r)[d], provided that neighbour lies within the map.
+     */
+    neighbour_offsets const & neighbour_deltas(int r) const
+    {
+        return _deltas[static_cast<size_type>(r + _radius)];
+    }
+
+    void fill(T const & value) { std::ranges::fill(_cells, value); }
+
+    friend bool operator==(hexagon_map const & lhs, hexagon_map const & rhs)
+    {
+        return lhs._radius == rhs._radius and lhs._cells == rhs._cells;
+    }
+private:
+    /** The flat index of a hex, extended linearly to hexes outside the map.
+     *
+     * Row r starts at q = -radius - min(r, 0) and holds 2 * radius + 1 - |r|
+     * hexes, so the rows before it hold
+     *   (r + radius) * (2 * radius + 1) - radius * (radius + 1) / 2 -+ t
+     * hexes, where t = r * (r - 1) / 2 is added for rows below the middle and
+     * subtracted for rows above it.
+     */
+    std::ptrdiff_t offset_of(int q, int r) const
+    {
+        auto const n = static_cast<std::ptrdiff_t>(_radius);
+        auto const rr = static_cast<std::ptrdiff_t>(r);
+        auto const t = rr * (rr - 1) / 2;
+        auto const before = (rr + n) * (2 * n + 1) - n * (n + 1) / 2 -
+                            (rr > 0 ? t : -t);
+        return before + q + n + std::min<std::ptrdiff_t>(rr, 0);
+    }
+
+    size_type row_start(int r) const
+    {
+        return static_cast<size_type>(
+            offset_of(-_radius - std::min(r, 0), r));
+    }
+    size_type row_size(int r) const
+    {
+        return static_cast<size_type>(2 * _radius + 1 - (r < 0 ? -r : r));
+    }
+
+    int _radius = 0;
+    std::vector<T> _cells;
+    std::vector<neighbour_offsets> _deltas;
+};
+
+/** A parallelogram-shaped map of hexes, stored densely row by row.
+ *
+ * The map holds the hexes with 0 <= q < width and 0 <= r < height. In axial
+ * coordinates this is a rectangle, so hexes are indexed exactly like a grid,
+ * and every neighbour is a fixed index offset away.
+ */
+template<class T, hex_layout Enum = pointed_hex::direction_name>
+    requires (not std::same_as<T, bool>)
+class rhombus_map {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using reference = T &;
+    using const_reference = T const &;
+    using iterator = typename std::vector<T>::iterator;
+    using const_iterator = typename std::vector<T>::const_iterator;
+    using neighbour_offsets = std::array<std::ptrdiff_t, enum_size_v<Enum>>;
+
+    rhombus_map() = default;
+    rhombus_map(size_type width, size_type height, T const & value = T{})
+        : _width{width}, _height{height}, _cells(width * height, value)
+    {
+        auto const steps = directions_as<hex_point, Enum>();
+        auto const stride = static_cast<std::ptrdiff_t>(_width);
+        for (size_type i = 0; i < steps.size(); ++i) {
+            _deltas[i] = steps[i].r * stride + steps[i].q;
+        }
+    }
+
+    size_type width() const { return _width; }
+    size_type height() const { return _height; }
+    size_type size() const { return _cells.size(); }
+    bool empty() const { return _cells.empty(); }
+
+    T * data() { return _cells.data(); }
+    T const * data() const { return _cells.data(); }
+
+    iterator begin() { return _cells.begin(); }
+    iterator end() { return _cells.end(); }
+    const_iterator begin() const { return _cells.begin(); }
+    const_iterator end() const { return _cells.end(); }
+
+    /** Determine if a hex lies within the map. */
+    bool contains(int q, int r) const
+    {
+        return q >= 0 and r >= 0 and
+               static_cast<size_type>(q) < _width and
+               static_cast<size_type>(r) < _height;
+    }
+    template<grid_coordinate Hex>
+    bool contains(Hex const & hex) const
+    {
+        return contains(static_cast<int>(get_x(hex)),
+                        static_cast<int>(get_y(hex)));
+    }
+
+    /** The flat index of a hex, assuming it lies within the map. */
+    size_type index_of(int q, int r) const
+    {
+        return static_cast<size_type>(r) * _width + static_cast<size_type>(q);
+    }
+    template<grid_coordinate Hex>
+    size_type index_of(Hex const & hex) const
+    {
+        return index_of(static_cast<int>(get_x(hex)),
+                        static_cast<int>(get_y(hex)));
+    }
+
+    /** The hex of a flat index. */
+    hex_point hex_of(size_type index) const
+    {
+        return hex_point{static_cast<int>(index % _width),
+                         static_cast<int>(index / _width)};
+    }
+
+    T & operator()(int q, int r) { return _cells[index_of(q, r)]; }
+    T const & operator()(int q, int r) const
+    {
+        return _cells[index_of(q, r)];
+    }
+
+    T & operator[](size_type index) { return _cells[index]; }
+    T const & operator[](size_type index) const { return _cells[index]; }
+
+    template<grid_coordinate Hex>
+    T & operator[](Hex const & hex) { return _cells[index_of(hex)]; }
+
+    template<grid_coordinate Hex>
+    T const & operator[](Hex const & hex) const
+    {
+        return _cells[index_of(hex)];
+    }
+
+    /** The hexes of a single row. */
+    std::span<T> row(size_type r)
+    {
+        return std::span<T>{_cells.data() + r * _width, _width};
+    }
+    std::span<T const> row(size_type r) const
+    {
+        return std::span<T const>{_cells.data() + r * _width, _width};
+    }
+
+    /** The index offsets of each neighbour of a hex.
+     *
+     * The neighbour of the hex at index i in direction d is at index
+     * i + neighbour_deltas()[d], provided that neighbour lies within the map.
+     */
+    neighbour_offsets const & neighbour_deltas() const { return _deltas; }
+
+    void fill(T const & value) { std::ranges::fill(_cells, value); }
+
+    friend bool operator==(rhombus_map const & lhs, rhombus_map const & rhs)
+    {
+        return lhs._width == rhs._width and lhs._height == rhs._height and
+               lhs._cells == rhs._cells;
+    }
+private:
+    size_type _width = 0;
+    size_type _height = 0;
+    std::vector<T> _cells;
+    neighbour_offsets _deltas{};
+};
+}
@@ -0,0 +1,611 @@
+#pragma once
+
+// type constraints
+#include <type_traits>
+#include <concepts>
+#include <ranges>
+#include "spatula/vectors.hpp"
+#include "spatula/directions.hpp"
+#include "spatula/execution.hpp"
+
+// data types and algorithms
+#include <cstddef>
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <iterator>
+#include <algorithm>
+#include <execution>
+
+namespace sp {
+
+/** Axial hex coordinates.
+ *
+ * Hex coordinates follow the axial offsets of the sp::flat_hex and
+ * sp::pointed_hex direction tables, where r grows towards the south. The third
+ * cube coordinate is always s = -q - r.
+ *
+ * Any semivector2 works as a hex coordinate: its first component is q and its
+ * second component is r.
+ */
+struct hex_point {
+    int q, r;
+    friend constexpr bool operator==(hex_point const &,
+                                     hex_point const &) = default;
+};
+
+/** The axes a hex coordinate can be reflected across. */
+enum class hex_axis { q, r, s };
+
+/** The conversion between hex coordinates and pixels for an orientation.
+ *
+ * forward maps (q, r) to a pixel offset for hexes of unit size, and inverse
+ * maps a pixel offset back. Both are stored as row-major 2x2 matrices.
+ */
+template<ranged_enum Enum>
+struct hex_orientation;
+
+template<>
+struct hex_orientation<flat_hex::direction_name> {
+    static constexpr double forward[4]{
+        3.0 / 2.0, 0.0,
+        std::numbers::sqrt3 / 2.0, std::numbers::sqrt3
+    };
+    static constexpr double inverse[4]{
+        2.0 / 3.0, 0.0,
+        -1.0 / 3.0, std::numbers::sqrt3 / 3.0
+    };
+};
+
+template<>
+struct hex_orientation<pointed_hex::direction_name> {
+    static constexpr double forward[4]{
+        std::numbers::sqrt3, std::numbers::sqrt3 / 2.0,
+        0.0, 3.0 / 2.0
+    };
+    static constexpr double inverse[4]{
+        std::numbers::sqrt3 / 3.0, -1.0 / 3.0,
+        0.0, 2.0 / 3.0
+    };
+};
+
+/** An orientation that hexes can be laid out in. */
+template<class Enum>
+concept hex_layout = ranged_enum<Enum> and requires {
+    hex_orientation<Enum>::forward;
+    hex_orientation<Enum>::inverse;
+};
+
+//
+// Scalar hex math
+//
+
+/** The number of hex steps between two hex coordinates. */
+template<semivector2 Hex>
+    requires std::signed_integral<scalar_field_t<Hex>>
+scalar_field_t<Hex> hex_distance(Hex const & a, Hex const & b)
+{
+    using Field = scalar_field_t<Hex>;
+    Field const dq = get_x(a) - get_x(b);
+    Field const dr = get_y(a) - get_y(b);
+    Field const ds = -dq - dr;
+    return static_cast<Field>(std::max({dq < 0 ? -dq : dq,
+                                        dr < 0 ? -dr : dr,
+                                        ds < 0 ? -ds : ds}));
+}
+
+/** Round fractional axial coordinates to the hex that contains them.
+ *
+ * Each cube coordinate is rounded, then the one that moved the most is
+ * recomputed from the other two so that q + r + s stays zero.
+ */
+template<semivector2 Hex, semivector2 Fractional>
+    requires std::floating_point<scalar_field_t<Fractional>>
+Hex hex_round(Fractional const & hex)
+{
+    using Field = scalar_field_t<Fractional>;
+    Field const q = get_x(hex);
+    Field const r = get_y(hex);
+    Field const s = -q - r;
+
+    Field rq = std::round(q);
+    Field rr = std::round(r);
+    Field const rs = std::round(s);
+
+    Field const dq = std::abs(rq - q);
+    Field const dr = std::abs(rr - r);
+    Field const ds = std::abs(rs - s);
+
+    bool const fix_q = dq > dr and dq > ds;
+    bool const fix_r = not fix_q and dr > ds;
+    rq = fix_q ? -rr - rs : rq;
+    rr = fix_r ? -rq - rs : rr;
+
+    using Integral = scalar_field_t<Hex>;
+    return Hex{static_cast<Integral>(rq), static_cast<Integral>(rr)};
+}
+
+/** The pixel at the center of a hex.
+ *
+ * Parameters
+ *   hex - the hex coordinate to convert
+ *   size - the distance from the center of a hex to any of its corners
+ */
+template<hex_layout Orientation, semivector2 Pixel, semivector2 Hex>
+Pixel hex_to_pixel(Hex const & hex, scalar_field_t<Pixel> size)
+{
+    using Field = scalar_field_t<Pixel>;
+    constexpr auto const & m = hex_orientation<Orientation>::forward;
+    auto const q = static_cast<Field>(get_x(hex));
+    auto const r = static_cast<Field>(get_y(hex));
+    return Pixel{static_cast<Field>((m[0] * q + m[1] * r) * size),
+                 static_cast<Field>((m[2] * q + m[3] * r) * size)};
+}
+
+/** The hex that contains a pixel.
+ *
+ * Parameters
+ *   pixel - the pixel to convert
+ *   size - the distance from the center of a hex to any of its corners
+ */
+template<hex_layout Orientation, semivector2 Hex, semivector2 Pixel>
+    requires std::floating_point<scalar_field_t<Pixel>>
+Hex pixel_to_hex(Pixel const & pixel, scalar_field_t<Pixel> size)
+{
+    using Field = scalar_field_t<Pixel>;
+    struct fractional { Field x, y; };
+
+    constexpr auto const & m = hex_orientation<Orientation>::inverse;
+    Field const x = get_x(pixel) / size;
+    Field const y = get_y(pixel) / size;
+    return hex_round<Hex>(fractional{static_cast<Field>(m[0] * x + m[1] * y),
+                                     static_cast<Field>(m[2] * x + m[3] * y)});
+}
+
+/** Rotate a hex about the origin in steps of 60 degrees.
+ *
+ * Positive steps turn clockwise on screen, where r grows downwards: one step
+ * turns pointed_hex::east into pointed_hex::southeast.
+ */
+template<semivector2 Hex>
+    requires std::signed_integral<scalar_field_t<Hex>>
+Hex hex_rotate(Hex const & hex, int sixths)
+{
+    using Field = scalar_field_t<Hex>;
+    int const turns = ((sixths % 6) + 6) % 6;
+
+    // each clockwise step maps cube (q, r, s) to (-r, -s, -q), so k steps
+    // shift the cube coordinates by k and negate them when k is odd
+    Field const q = get_x(hex);
+    Field const r = get_y(hex);
+    Field const cube[3]{q, r, static_cast<Field>(-q - r)};
+    int const shift = turns % 3;
+    Field const sign = turns % 2 == 0 ? 1 : -1;
+    return Hex{static_cast<Field>(sign * cube[shift]),
+               static_cast<Field>(sign * cube[(shift + 1) % 3])};
+}
+
+/** Reflect a hex across one of the cube axes through the origin. */
+template<semivector2 Hex>
+    requires std::signed_integral<scalar_field_t<Hex>>
+Hex hex_reflect(Hex const & hex, hex_axis axis)
+{
+    using Field = scalar_field_t<Hex>;
+    Field const q = get_x(hex);
+    Field const r = get_y(hex);
+    Field const s = static_cast<Field>(-q - r);
+    switch (axis) {
+    case hex_axis::q: return Hex{q, s};
+    case hex_axis::r: return Hex{s, r};
+    default: return Hex{r, q};
+    }
+}
+
+//
+// Batch hex math
+//
+// Each batch form applies its scalar counterpart to every element of a range
+// with std::transform under the given execution policy.
+//
+
+/** Find the distance between each pair of hexes in two ranges. */
+template<execution_policy Policy, ranges::forward_range From,
+         ranges::forward_range To, std::forward_iterator Out>
+    requires semivector2<ranges::range_value_t<From>> and
+             std::same_as<ranges::range_value_t<From>,
+                          ranges::range_value_t<To>>
+Out hex_distance(Policy && policy, From const & from, To const & to, Out out)
+{
+    using Hex = ranges::range_value_t<From>;
+    return std::transform(std::forward<Policy>(policy),
+                          ranges::begin(from), ranges::end(from),
+                          ranges::begin(to), out,
+                          [](Hex const & a, Hex const & b) {
+                              return hex_distance(a, b);
+                          });
+}
+
+/** Round every fractional coordinate in a range to its hex. */
+template<semivector2 Hex, execution_policy Policy,
+         ranges::forward_range Range, std::forward_iterator Out>
+    requires semivector2<ranges::range_value_t<Range>>
+Out hex_round(Policy && policy, Range const & hexes, Out out)
+{
+    using Fractional = ranges::range_value_t<Range>;
+    return std::transform(std::forward<Policy>(policy),
+                          ranges::begin(hexes), ranges::end(hexes), out,
+                          [](Fractional const & hex) {
+                              return hex_round<Hex>(hex);
+                          });
+}
+
+/** Find the pixel at the center of every hex in a range. */
+template<hex_layout Orientation, semivector2 Pixel, execution_policy Policy,
+         ranges::forward_range Range, std::forward_iterator Out>
+    requires semivector2<ranges::range_value_t<Range>>
+Out hex_to_pixel(Policy && policy, Range const & hexes,
+                 scalar_field_t<Pixel> size, Out out)
+{
+    using Hex = ranges::range_value_t<Range>;
+    return std::transform(std::forward<Policy>(policy),
+                          ranges::begin(hexes), ranges::end(hexes), out,
+                          [size](Hex const & hex) {
+                              return hex_to_pixel<Orientation, Pixel>(hex,
+                                                                      size);
+                          });
+}
+
+/** Find the hex that contains every pixel in a range. */
+template<hex_layout Orientation, semivector2 Hex, execution_policy Policy,
+         ranges::forward_range Range, std::forward_iterator Out>
+    requires semivector2<ranges::range_value_t<Range>>
+Out pixel_to_hex(Policy && policy, Range const & pixels,
+                 scalar_field_t<ranges::range_value_t<Range>> size, Out out)
+{
+    using Pixel = ranges::range_value_t<Range>;
+    return std::transform(std::forward<Policy>(policy),
+                          ranges::begin(pixels), ranges::end(pixels), out,
+                          [size](Pixel const & pixel) {
+                              return pixel_to_hex<Orientation, Hex>(pixel,
+                                                                    size);
+                          });
+}
+
+/** Rotate every hex in a range about the origin. */
+template<execution_policy Policy, ranges::forward_range Range,
+         std::forward_iterator Out>
+    requires semivector2<ranges::range_value_t<Range>>
+Out hex_rotate(Policy && policy, Range const & hexes, int sixths, Out out)
+{
+    using Hex = ranges::range_value_t<Range>;
+    return std::transform(std::forward<Policy>(policy),
+                          ranges::begin(hexes), ranges::end(hexes), out,
+                          [sixths](Hex const & hex) {
+                              return hex_rotate(hex, sixths);
+                          });
+}
+
+/** Reflect every hex in a range across one of the cube axes. */
+template<execution_policy Policy, ranges::forward_range Range,
+         std::forward_iterator Out>
+    requires semivector2<ranges::range_value_t<Range>>
+Out hex_reflect(Policy && policy, Range const & hexes, hex_axis axis, Out out)
+{
+    using Hex = ranges::range_value_t<Range>;
+    return std::transform(std::forward<Policy>(policy),
+                          ranges::begin(hexes), ranges::end(hexes), out,
+                          [axis](Hex const & hex) {
+                              return hex_reflect(hex, axis);
+                          });
+}
+
+//
+// Hex views
+//
+
+/** A hex coordinate type that hex views can generate. */
+template<class Hex>
+concept hex_coordinate = semivector2<Hex> and field_2d_constructible<Hex> and
+                         std::signed_integral<scalar_field_t<Hex>>;
+
+namespace detail {
+/** The hex at an index along a ring.
+ *
+ * A ring is walked one side at a time, following the directions of a hex table
+ * in order. Side i starts at the corner in direction i + 4 and takes radius
+ * steps in direction i, which lands on the corner side i + 1 starts from.
+ */
+template<hex_coordinate Hex>
+Hex hex_ring_at(Hex const & center, std::array<Hex, 6> const & steps,
+                scalar_field_t<Hex> radius, std::ptrdiff_t index)
+{
+    using Field = scalar_field_t<Hex>;
+    if (radius == 0) { return center; }
+    auto const side = static_cast<std::size_t>(index / radius);
+    auto const along = static_cast<Field>(index % radius);
+    Hex const & corner = steps[(side + 4) % 6];
+    Hex const & step = steps[side];
+    return Hex{static_cast<Field>(get_x(center) + get_x(corner) * radius +
+                                  get_x(step) * along),
+               static_cast<Field>(get_y(center) + get_y(corner) * radius +
+                                  get_y(step) * along)};
+}
+
+/** The number of hexes on a ring. */
+constexpr std::ptrdiff_t hex_ring_size(std::ptrdiff_t radius)
+{
+    return radius < 0 ? 0 : radius == 0 ? 1 : 6 * radius;
+}
+
+/** The number of hexes within a radius of a center. */
+constexpr std::ptrdiff_t hex_area(std::ptrdiff_t radius)
+{
+    return radius < 0 ? 0 : 3 * radius * (radius + 1) + 1;
+}
+}
+
+/** The hexes at exactly a given distance from a center.
+ *
+ * Hexes are generated on the fly in the order of the Enum direction table, so
+ * iterating the view never allocates. Random access is constant time.
+ */
+template<hex_coordinate Hex, hex_layout Enum>
+class hex_ring_view : public ranges::view_interface<hex_ring_view<Hex, Enum>> {
+public:
+    using Field = scalar_field_t<Hex>;
+
+    class iterator {
+    public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Hex;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        iterator(hex_ring_view const * ring, std::ptrdiff_t index)
+            : _ring{ring}, _index{index}
+        {
+        }
+
+        Hex operator*() const
+        {
+            return detail::hex_ring_at(_ring->_center, _ring->_steps,
+                                       _ring->_radius, _index);
+        }
+        Hex operator[](difference_type offset) const
+        {
+            return *(*this + offset);
+        }
+
+        iterator & operator++() { ++_index; return *this; }
+        iterator operator++(int) { auto old = *this; ++_index; return old; }
+        iterator & operator--() { --_index; return *this; }
+        iterator operator--(int) { auto old = *this; --_index; return old; }
+        iterator & operator+=(difference_type n) { _index += n; return *this; }
+        iterator & operator-=(difference_type n) { _index -= n; return *this; }
+
+        friend iterator operator+(iterator it, difference_type n)
+        {
+            return it += n;
+        }
+        friend iterator operator+(difference_type n, iterator it)
+        {
+            return it += n;
+        }
+        friend iterator operator-(iterator it, difference_type n)
+        {
+            return it -= n;
+        }
+        friend difference_type operator-(iterator const & a,
+                                         iterator const & b)
+        {
+            return a._index - b._index;
+        }
+        friend bool operator==(iterator const & a, iterator const & b)
+        {
+            return a._index == b._index;
+        }
+        friend auto operator<=>(iterator const & a, iterator const & b)
+        {
+            return a._index <=> b._index;
+        }
+    private:
+        hex_ring_view const * _ring = nullptr;
+        std::ptrdiff_t _index = 0;
+    };
+
+    hex_ring_view() = default;
+    hex_ring_view(Hex const & center, Field radius)
+        : _center{center}, _radius{radius},
+          _steps{directions_as<Hex, Enum>()}
+    {
+    }
+
+    iterator begin() const { return iterator{this, 0}; }
+    iterator end() const
+    {
+        return iterator{this, detail::hex_ring_size(_radius)};
+    }
+    std::size_t size() const
+    {
+        return static_cast<std::size_t>(detail::hex_ring_size(_radius));
+    }
+private:
+    Hex _center{};
+    Field _radius = 0;
+    std::array<Hex, 6> _steps{};
+};
+
+/** The hexes within a distance of a center, ring by ring.
+ *
+ * The center comes first, followed by each ring in order of its radius. Hexes
+ * are generated on the fly, so iterating the view never allocates.
+ */
+template<hex_coordinate Hex, hex_layout Enum>
+class hex_spiral_view
+    : public ranges::view_interface<hex_spiral_view<Hex, Enum>> {
+public:
+    using Field = scalar_field_t<Hex>;
+
+    class iterator {
+    public:
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Hex;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        iterator(hex_spiral_view const * spiral, std::ptrdiff_t index)
+            : _spiral{spiral}, _index{index}
+        {
+        }
+
+        Hex operator*() const
+        {
+            return detail::hex_ring_at(_spiral->_center, _spiral->_steps,
+                                       _radius, _along);
+        }
+
+        iterator & operator++()
+        {
+            ++_index;
+            if (++_along == detail::hex_ring_size(_radius)) {
+                ++_radius;
+                _along = 0;
+            }
+            return *this;
+        }
+        iterator operator++(int) { auto old = *this; ++*this; return old; }
+
+        friend bool operator==(iterator const & a, iterator const & b)
+        {
+            return a._index == b._index;
+        }
+    private:
+        hex_spiral_view const * _spiral = nullptr;
+        std::ptrdiff_t _index = 0;
+        Field _radius = 0;
+        std::ptrdiff_t _along = 0;
+    };
+
+    hex_spiral_view() = default;
+    hex_spiral_view(Hex const & center, Field radius)
+        : _center{center}, _radius{radius},
+          _steps{directions_as<Hex, Enum>()}
+    {
+    }
+
+    iterator begin() const { return iterator{this, 0}; }
+    iterator end() const { return iterator{this, detail::hex_area(_radius)}; }
+    std::size_t size() const
+    {
+        return static_cast<std::size_t>(detail::hex_area(_radius));
+    }
+private:
+    Hex _center{};
+    Field _radius = 0;
+    std::array<Hex, 6> _steps{};
+};
+
+/** The hexes within a distance of a center, column by column.
+ *
+ * Covers the same hexes as hex_spiral_view, ordered by q and then by r. This
+ * visits rows of dense hex storage in order, and needs no direction table.
+ */
+template<hex_coordinate Hex>
+class hex_range_view : public ranges::view_interface<hex_range_view<Hex>> {
+public:
+    using Field = scalar_field_t<Hex>;
+
+    class iterator {
+    public:
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Hex;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        iterator(Hex const & center, Field radius, std::ptrdiff_t index)
+            : _center{center}, _radius{radius}, _index{index},
+              _q{static_cast<Field>(-radius)}, _r{0}
+        {
+        }
+
+        Hex operator*() const
+        {
+            return Hex{static_cast<Field>(get_x(_center) + _q),
+                       static_cast<Field>(get_y(_center) + _r)};
+        }
+
+        iterator & operator++()
+        {
+            ++_index;
+            // column q spans r from max(-radius, -q - radius) up to
+            // min(radius, radius - q)
+            if (++_r > std::min(_radius, static_cast<Field>(_radius - _q))) {
+                ++_q;
+                _r = std::max(static_cast<Field>(-_radius),
+                              static_cast<Field>(-_q - _radius));
+            }
+            return *this;
+        }
+        iterator operator++(int) { auto old = *this; ++*this; return old; }
+
+        friend bool operator==(iterator const & a, iterator const & b)
+        {
+            return a._index == b._index;
+        }
+    private:
+        Hex _center{};
+        Field _radius = 0;
+        std::ptrdiff_t _index = 0;
+        Field _q = 0;
+        Field _r = 0;
+    };
+
+    hex_range_view() = default;
+    hex_range_view(Hex const & center, Field radius)
+        : _center{center}, _radius{radius}
+    {
+    }
+
+    iterator begin() const { return iterator{_center, _radius, 0}; }
+    iterator end() const
+    {
+        return iterator{_center, _radius, detail::hex_area(_radius)};
+    }
+    std::size_t size() const
+    {
+        return static_cast<std::size_t>(detail::hex_area(_radius));
+    }
+private:
+    Hex _center{};
+    Field _radius = 0;
+};
+
+namespace views {
+/** The hexes at exactly a distance from a center, clockwise in the order of a
+ * hex direction table. */
+template<hex_layout Enum = pointed_hex::direction_name, hex_coordinate Hex>
+hex_ring_view<Hex, Enum> hex_ring(Hex const & center,
+                                  scalar_field_t<Hex> radius)
+{
+    return hex_ring_view<Hex, Enum>{center, radius};
+}
+
+/** The hexes within a distance of a center, from the center outwards. */
+template<hex_layout Enum = pointed_hex::direction_name, hex_coordinate Hex>
+hex_spiral_view<Hex, Enum> hex_spiral(Hex const & center,
+                                      scalar_field_t<Hex> radius)
+{
+    return hex_spiral_view<Hex, Enum>{center, radius};
+}
+
+/** The hexes within a distance of a center, ordered by q and then r. */
+template<hex_coordinate Hex>
+hex_range_view<Hex> hex_range(Hex const & center, scalar_field_t<Hex> radius)
+{
+    return hex_range_view<Hex>{center, radius};
+}
+}
+}
@@ -0,0 +1,300 @@
+#pragma once
+
+// type constraints
+#include <type_traits>
+#include <concepts>
+#include "spatula/vectors.hpp"
+#include "spatula/execution.hpp"
+
+// data types and data structures
+#include <cstddef>
+#include <vector>
+#include <utility>
+#include <span>
+#include <optional>
+#include <initializer_list>
+#include <algorithm>
+#include <execution>
+#include "spatula/grids.hpp"
+
+namespace sp {
+
+/** A layer of an influence map and how much it counts towards a blend. */
+struct layer_weight {
+    std::size_t layer;
+    float weight;
+};
+
+/** The strongest influence found in a region, and where it was. */
+struct influence_peak {
+    grid_point cell;
+    float value;
+};
+
+/** A grid of cells that each hold several layers of float influence.
+ *
+ * Each layer is stored as its own dense plane, row by row, so passes over a
+ * layer run over contiguous floats. Typical layers track threat, control or
+ * interest for one faction each, and are decayed, spread out and blended
+ * together every tick.
+ */
+class influence_map {
+public:
+    using value_type = float;
+    using size_type = std::size_t;
+
+    influence_map() = default;
+    influence_map(size_type width, size_type height, size_type layers)
+        : _width{width}, _height{height},
+          _layers(layers, std::vector<float>(width * height, 0.0f)),
+          _spares(layers)
+    {
+    }
+
+    size_type width() const { return _width; }
+    size_type height() const { return _height; }
+    size_type layers() const { return _layers.size(); }
+
+    /** Determine if a coordinate lies within the map. */
+    bool contains(int x, int y) const
+    {
+        return x >= 0 and y >= 0 and
+               static_cast<size_type>(x) < _width and
+               static_cast<size_type>(y) < _height;
+    }
+    template<grid_coordinate Vector>
+    bool contains(Vector const & cell) const
+    {
+        return contains(static_cast<int>(get_x(cell)),
+                        static_cast<int>(get_y(cell)));
+    }
+
+    /** Every cell of one layer, row by row. */
+    std::span<float> layer(size_type layer) { return _layers[layer]; }
+    std::span<float const> layer(size_type layer) const
+    {
+        return _layers[layer];
+    }
+
+    /** The cells of a single row of one layer. */
+    std::span<float> row(size_type layer, size_type y)
+    {
+        return std::span<float>{_layers[layer].data() + y * _width, _width};
+    }
+    std::span<float const> row(size_type layer, size_type y) const
+    {
+        return std::span<float const>{_layers[layer].data() + y * _width,
+                                      _width};
+    }
+
+    float & operator()(size_type layer, int x, int y)
+    {
+        return _layers[layer][index_of(x, y)];
+    }
+    float operator()(size_type layer, int x, int y) const
+    {
+        return _layers[layer][index_of(x, y)];
+    }
+    template<grid_coordinate Vector>
+    float & operator()(size_type layer, Vector const & cell)
+    {
+        return (*this)(layer, static_cast<int>(get_x(cell)),
+                       static_cast<int>(get_y(cell)));
+    }
+    template<grid_coordinate Vector>
+    float operator()(size_type layer, Vector const & cell) const
+    {
+        return (*this)(layer, static_cast<int>(get_x(cell)),
+                       static_cast<int>(get_y(cell)));
+    }
+
+    void fill(size_type layer, float value)
+    {
+        std::ranges::fill(_layers[layer], value);
+    }
+
+    /** Scale every cell of a layer, so old influence fades away.
+     *
+     * Parameters
+     *   policy - the execution policy to scale cells with
+     *   layer - the layer to decay
+     *   factor - what to multiply each cell by, usually just under 1
+     */
+    template<execution_policy Policy>
+    void decay(Policy && policy, size_type layer, float factor)
+    {
+        auto & cells = _layers[layer];
+        std::transform(std::forward<Policy>(policy),
+                       cells.begin(), cells.end(), cells.begin(),
+                       [factor](float value) { return value * factor; });
+    }
+    void decay(size_type layer, float factor)
+    {
+        decay(std::execution::seq, layer, factor);
+    }
+
+    /** Spread the influence of a layer out to nearby cells.
+     *
+     * The layer is convolved with a square kernel whose weight at offset
+     * (dx, dy) is falloff[|dx|] * falloff[|dy|], so the blur is separable and
+     * runs as a vertical pass then a horizontal pass. The vertical pass sums
+     * weighted rows into a padded row buffer, and the horizontal pass sums
+     * that buffer at each offset, so neither tests for the edge of the map.
+     * Cells past the edge of the map hold no influence.
+     *
+     * Each layer blurs into a spare plane of its own, so different layers
+     * may be spread at the same time.
+     *
+     * Parameters
+     *   policy - the execution policy to schedule bands of rows with
+     *   layer - the layer to spread
+     *   falloff - the weight at each distance from a cell, starting at 0
+     */
+    template<execution_policy Policy>
+    void propagate(Policy && policy, size_type layer,
+                   std::span<float const> falloff)
+    {
+        constexpr size_type band_height = 32;
+        if (falloff.empty() or _width == 0 or _height == 0) { return; }
+
+        auto const radius = falloff.size() - 1;
+        auto const & source = _layers[layer];
+        // the blur lands in the layer's spare plane, then swaps with it
+        auto & result = _spares[layer];
+        result.resize(source.size());
+        auto const bands = (_height + band_height - 1) / band_height;
+
+        for_each_index(std::forward<Policy>(policy), bands,
+                       [&](size_type band) {
+            // the vertical blur of a row, with radius empty cells either side
+            std::vector<float> padded(_width + 2 * radius, 0.0f);
+            float * const blurred = padded.data() + radius;
+
+            auto const last = std::min(_height, (band + 1) * band_height);
+            for (size_type y = band * band_height; y < last; ++y) {
+                std::fill_n(blurred, _width, 0.0f);
+                auto const first_row = y < radius ? 0 : y - radius;
+                auto const last_row = std::min(_height - 1, y + radius);
+                for (size_type ny = first_row; ny <= last_row; ++ny) {
+                    auto const weight = falloff[ny < y ? y - ny : ny - y];
+                    float const * const cells = source.data() + ny * _width;
+                    for (size_type x = 0; x < _width; ++x) {
+                        blurred[x] += weight * cells[x];
+                    }
+                }
+
+                float * const out = result.data() + y * _width;
+                for (size_type x = 0; x < _width; ++x) {
+                    out[x] = falloff[0] * blurred[x];
+                }
+                for (size_type d = 1; d <= radius; ++d) {
+                    auto const weight = falloff[d];
+                    float const * const left = blurred - d;
+                    float const * const right = blurred + d;
+                    for (size_type x = 0; x < _width; ++x) {
+                        out[x] += weight * (left[x] + right[x]);
+                    }
+                }
+            }
+        });
+        std::swap(_layers[layer], result);
+    }
+    void propagate(size_type layer, std::span<float const> falloff)
+    {
+        propagate(std::execution::seq, layer, falloff);
+    }
+
+    /** Set a layer to a weighted sum of layers.
+     *
+     * The target may also be one of the sources, which reads its old value.
+     *
+     * Parameters
+     *   policy - the execution policy to schedule bands of rows with
+     *   target - the layer to write
+     *   sources - the layers to sum and the weight of each
+     */
+    template<execution_policy Policy>
+    void blend(Policy && policy, size_type target,
+               std::span<layer_weight const> sources)
+    {
+        constexpr size_type band_height = 32;
+        auto const bands = (_height + band_height - 1) / band_height;
+        for_each_index(std::forward<Policy>(policy), bands,
+                       [&](size_type band) {
+            std::vector<float> sum(_width);
+            auto const last = std::min(_height, (band + 1) * band_height);
+            for (size_type y = band * band_height; y < last; ++y) {
+                std::ranges::fill(sum, 0.0f);
+                for (auto const & [source, weight] : sources) {
+                    auto const cells = row(source, y);
+                    for (size_type x = 0; x < _width; ++x) {
+                        sum[x] += weight * cells[x];
+                    }
+                }
+                std::ranges::copy(sum, row(target, y).begin());
+            }
+        });
+    }
+    void blend(size_type target, std::span<layer_weight const> sources)
+    {
+        blend(std::execution::seq, target, sources);
+    }
+    void blend(size_type target, std::initializer_list<layer_weight> sources)
+    {
+        blend(std::execution::seq, target,
+              std::span<layer_weight const>{sources.begin(), sources.size()});
+    }
+
+    /** Find the strongest influence of a layer within a region.
+     *
+     * The region holds every cell from first to last, inclusive, clipped to
+     * the map. Ties go to the first cell in row order. There is no peak when
+     * the region misses the map entirely.
+     */
+    std::optional<influence_peak> max_influence(size_type layer,
+                                                grid_point first,
+                                                grid_point last) const
+    {
+        auto const x0 = std::max(first.x, 0);
+        auto const y0 = std::max(first.y, 0);
+        auto const x1 = std::min(last.x, static_cast<int>(_width) - 1);
+        auto const y1 = std::min(last.y, static_cast<int>(_height) - 1);
+        if (x0 > x1 or y0 > y1) { return std::nullopt; }
+
+        influence_peak peak{grid_point{x0, y0}, (*this)(layer, x0, y0)};
+        for (int y = y0; y <= y1; ++y) {
+            auto const cells =
+                row(layer, static_cast<size_type>(y))
+                    .subspan(static_cast<size_type>(x0),
+                             static_cast<size_type>(x1 - x0 + 1));
+            // find the row's maximum in a single reduction first,
+            // and only search for where it is when it beats the peak
+            float best = cells[0];
+            for (float const value : cells) { best = std::max(best, value); }
+            if (best > peak.value) {
+                auto const found = std::ranges::find(cells, best);
+                auto const x = x0 + static_cast<int>(found - cells.begin());
+                peak = influence_peak{grid_point{x, y}, best};
+            }
+        }
+        return peak;
+    }
+    template<grid_coordinate Vector>
+    std::optional<influence_peak> max_influence(size_type layer,
+                                                Vector const & first,
+                                                Vector const & last) const
+    {
+        return max_influence(layer, to_grid_point(first), to_grid_point(last));
+    }
+private:
+    size_type index_of(int x, int y) const
+    {
+        return static_cast<size_type>(y) * _width + static_cast<size_type>(x);
+    }
+
+    size_type _width = 0;
+    size_type _height = 0;
+    std::vector<std::vector<float>> _layers;
+    std::vector<std::vector<float>> _spares;
+};
+}
@@ -0,0 +1,282 @@
+#pragma once
+
+// type constraints
+#include <type_traits>
+#include <concepts>
+#include <iterator>
+#include <ranges>
+#include "spatula/vectors.hpp"
+
+// data types and algorithms
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <compare>
+#include <algorithm>
+
+namespace sp {
+
+/** An integer point in two or three dimensions that a line can run between,
+ * such as SDL_Point or glm::ivec3. */
+template<class Vector>
+concept line_endpoint = (semivector2<Vector> or semivector3<Vector>) and
+                        std::signed_integral<scalar_field_t<Vector>>;
+
+namespace detail {
+template<line_endpoint Vector>
+constexpr std::size_t line_dimensions_v = semivector3<Vector> ? 3 : 2;
+
+/** The steps a line takes along each axis, from one endpoint to another. */
+template<line_endpoint Vector>
+struct line_deltas {
+    static constexpr std::size_t D = line_dimensions_v<Vector>;
+
+    std::array<std::int64_t, D> start{};
+    std::array<std::int64_t, D> length{};
+    std::array<std::int64_t, D> sign{};
+
+    line_deltas() = default;
+    line_deltas(Vector const & a, Vector const & b)
+    {
+        std::array<std::int64_t, D> end;
+        start[0] = get_x(a);
+        start[1] = get_y(a);
+        end[0] = get_x(b);
+        end[1] = get_y(b);
+        if constexpr (D == 3) {
+            start[2] = get_z(a);
+            end[2] = get_z(b);
+        }
+        for (std::size_t i = 0; i < D; ++i) {
+            sign[i] = end[i] < start[i] ? -1 : 1;
+            length[i] = (end[i] - start[i]) * sign[i];
+        }
+    }
+
+    /** The point a number of steps along each axis from the start. */
+    Vector at(std::array<std::int64_t, D> const & steps) const
+    {
+        using Field = scalar_field_t<Vector>;
+        auto const along = [&](std::size_t i) {
+            return static_cast<Field>(start[i] + sign[i] * steps[i]);
+        };
+        if constexpr (D == 3) { return Vector{along(0), along(1), along(2)}; }
+        else { return Vector{along(0), along(1)}; }
+    }
+};
+
+/** A random access iterator over the points of a line view, found by index.
+ */
+template<class View, class Value>
+class line_iterator {
+public:
+    using iterator_concept = std::random_access_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = Value;
+    using difference_type = std::ptrdiff_t;
+
+    line_iterator() = default;
+    line_iterator(View const * view, std::ptrdiff_t index)
+        : _view{view}, _index{index}
+    {
+    }
+
+    Value operator*() const { return (*_view)[_index]; }
+    Value operator[](difference_type offset) const
+    {
+        return (*_view)[_index + offset];
+    }
+
+    line_iterator & operator++() { ++_index; return *this; }
+    line_iterator operator++(int) { auto old = *this; ++_index; return old; }
+    line_iterator & operator--() { --_index; return *this; }
+    line_iterator operator--(int) { auto old = *this; --_index; return old; }
+    line_iterator & operator+=(difference_type n) { _index += n; return *this; }
+    line_iterator & operator-=(difference_type n) { _index -= n; return *this; }
+
+    friend line_iterator operator+(line_iterator it, difference_type n)
+    {
+        return it += n;
+    }
+    friend line_iterator operator+(difference_type n, line_iterator it)
+    {
+        return it += n;
+    }
+    friend line_iterator operator-(line_iterator it, difference_type n)
+    {
+        return it -= n;
+    }
+    friend difference_type operator-(line_iterator const & a,
+                                     line_iterator const & b)
+    {
+        return a._index - b._index;
+    }
+    friend bool operator==(line_iterator const & a, line_iterator const & b)
+    {
+        return a._index == b._index;
+    }
+    friend auto operator<=>(line_iterator const & a, line_iterator const & b)
+    {
+        return a._index <=> b._index;
+    }
+private:
+    View const * _view = nullptr;
+    std::ptrdiff_t _index = 0;
+};
+
+inline std::int64_t floor_half(std::int64_t numerator,
+                               std::int64_t denominator)
+{
+    // numerator and denominator are never negative here
+    return numerator / (2 * denominator);
+}
+}
+
+/** The points of a Bresenham line between two endpoints, inclusive.
+ *
+ * The line takes one step along its longest axis for each point, and each
+ * other axis follows by rounding to the nearest integer, with halves rounding
+ * away from the start. Every point is found from its index in constant time,
+ * so the view is random access and never allocates.
+ */
+template<line_endpoint Vector>
+class line_view : public ranges::view_interface<line_view<Vector>> {
+public:
+    static constexpr std::size_t D = detail::line_dimensions_v<Vector>;
+    using iterator = detail::line_iterator<line_view, Vector>;
+
+    line_view() = default;
+    line_view(Vector const & a, Vector const & b) : _deltas{a, b}
+    {
+        for (auto const length : _deltas.length) {
+            _major = std::max(_major, length);
+        }
+    }
+
+    iterator begin() const { return iterator{this, 0}; }
+    iterator end() const
+    {
+        return iterator{this, static_cast<std::ptrdiff_t>(size())};
+    }
+    std::size_t size() const { return static_cast<std::size_t>(_major + 1); }
+
+    Vector operator[](std::ptrdiff_t index) const
+    {
+        std::array<std::int64_t, D> steps{};
+        for (std::size_t i = 0; _major > 0 and i < D; ++i) {
+            steps[i] = detail::floor_half(
+                2 * index * _deltas.length[i] + _major, _major);
+        }
+        return _deltas.at(steps);
+    }
+private:
+    detail::line_deltas<Vector> _deltas;
+    std::int64_t _major = 0;
+};
+
+/** Every cell that the segment between the centers of two cells passes
+ * through, inclusive.
+ *
+ * Consecutive cells always share a face, so a line through a corner or along
+ * an edge of the grid steps along the tied axes one at a time, x first, then y,
+ * then z. The line has one cell for each step along any axis, plus one.
+ *
+ * Every cell is found from its index, in constant time on square grids and in
+ * logarithmic time on voxel grids, so the view is random access and never
+ * allocates.
+ */
+template<line_endpoint Vector>
+class supercover_line_view
+    : public ranges::view_interface<supercover_line_view<Vector>> {
+public:
+    static constexpr std::size_t D = detail::line_dimensions_v<Vector>;
+    using iterator = detail::line_iterator<supercover_line_view, Vector>;
+
+    supercover_line_view() = default;
+    supercover_line_view(Vector const & a, Vector const & b) : _deltas{a, b}
+    {
+        for (auto const length : _deltas.length) { _steps += length; }
+    }
+
+    iterator begin() const { return iterator{this, 0}; }
+    iterator end() const
+    {
+        return iterator{this, static_cast<std::ptrdiff_t>(size())};
+    }
+    std::size_t size() const { return static_cast<std::size_t>(_steps + 1); }
+
+    Vector operator[](std::ptrdiff_t index) const
+    {
+        std::array<std::int64_t, D> steps{};
+        if constexpr (D == 2) {
+            // the segment crosses x + y = index + 1 within the cell it visits
+            // at that index, which gives x directly
+            if (_steps > 0) {
+                steps[0] = detail::floor_half(
+                    2 * index * _deltas.length[0] + _steps, _steps);
+            }
+            steps[1] = index - steps[0];
+        }
+        else {
+            for (std::size_t axis = 0; axis < D; ++axis) {
+                steps[axis] = crossings_before(axis, index);
+            }
+        }
+        return _deltas.at(steps);
+    }
+private:
+    /** The number of times the line has crossed into the next cell along an
+     * axis by the time it reaches a given index. */
+    std::int64_t crossings_before(std::size_t axis, std::int64_t index) const
+    {
+        // crossing i of an axis happens at time (2 i + 1) / (2 length), and
+        // its place in the line grows with i, so search for the last one
+        // that comes no later than index
+        std::int64_t low = 0;
+        std::int64_t high = _deltas.length[axis];
+        while (low < high) {
+            auto const middle = low + (high - low) / 2;
+            if (place_of(axis, middle) <= index) { low = middle + 1; }
+            else { high = middle; }
+        }
+        return low;
+    }
+
+    /** The index of the cell the line enters with crossing i of an axis. */
+    std::int64_t place_of(std::size_t axis, std::int64_t i) const
+    {
+        auto const & length = _deltas.length;
+        auto const own = length[axis];
+        std::int64_t place = i + 1;
+        for (std::size_t other = 0; other < D; ++other) {
+            if (other == axis or length[other] == 0) { continue; }
+            auto const time = (2 * i + 1) * length[other];
+            // crossings tied with this one come first on earlier axes only
+            auto const before = other < axis ? (time + own) / (2 * own)
+                                             : (time - 1 + own) / (2 * own);
+            place += std::min(before, length[other]);
+        }
+        return place;
+    }
+
+    detail::line_deltas<Vector> _deltas;
+    std::int64_t _steps = 0;
+};
+
+namespace views {
+/** The points of a Bresenham line from a to b, inclusive. */
+template<line_endpoint Vector>
+line_view<Vector> line(Vector const & a, Vector const & b)
+{
+    return line_view<Vector>{a, b};
+}
+
+/** Every cell the segment between the centers of a and b passes through. */
+template<line_endpoint Vector>
+supercover_line_view<Vector> supercover_line(Vector const & a,
+                                             Vector const & b)
+{
+    return supercover_line_view<Vector>{a, b};
+}
+}
+}
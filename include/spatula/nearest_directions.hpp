@@ -0,0 +1,173 @@
+#pragma once
+
+// type constraints
+#include <type_traits>
+#include <concepts>
+#include <ranges>
+#include "spatula/vectors.hpp"
+#include "spatula/directions.hpp"
+#include "spatula/execution.hpp"
+
+// data types and algorithms
+#include <cstddef>
+#include <array>
+#include <numbers>
+#include <iterator>
+#include <algorithm>
+#include <execution>
+
+namespace sp {
+
+/** The cartesian vector of each component axis of a direction set.
+ *
+ * Nearest directions are measured by angle, so they need to know how the
+ * components of a direction set's offsets lie in space. The general template
+ * treats the components as orthonormal axes, which suits cardinal, octile and
+ * voxel directions. Specializations define
+ *   dimensions - the number of cartesian components
+ *   axes - the cartesian vector of each offset component
+ */
+template<tabled_direction Enum>
+struct direction_basis {
+    static constexpr std::size_t dimensions = direction_table<Enum>::dimensions;
+    static constexpr auto axes = [] {
+        std::array<std::array<double, dimensions>, dimensions> axes{};
+        for (std::size_t i = 0; i < dimensions; ++i) { axes[i][i] = 1.0; }
+        return axes;
+    }();
+};
+
+/** Axial q and r axes lie 60 degrees apart, in both hex orientations. */
+struct axial_basis {
+    static constexpr std::size_t dimensions = 2;
+    static constexpr std::array<std::array<double, 2>, 2> axes{{
+        {1.0, 0.0}, {0.5, std::numbers::sqrt3 / 2.0}
+    }};
+};
+
+template<>
+struct direction_basis<flat_hex::direction_name> : axial_basis {};
+
+template<>
+struct direction_basis<pointed_hex::direction_name> : axial_basis {};
+
+/** Triangle coordinates count lines crossed to the north, southeast and
+ * southwest. */
+template<>
+struct direction_basis<triangular::direction_name> {
+    static constexpr std::size_t dimensions = 2;
+    static constexpr std::array<std::array<double, 2>, 3> axes{{
+        {0.0, 1.0},
+        {std::numbers::sqrt3 / 2.0, -0.5},
+        {-std::numbers::sqrt3 / 2.0, -0.5}
+    }};
+};
+
+namespace detail {
+constexpr double constexpr_sqrt(double x)
+{
+    if (x <= 0.0) { return 0.0; }
+    double root = x < 1.0 ? 1.0 : x;
+    for (int i = 0; i < 64; ++i) { root = 0.5 * (root + x / root); }
+    return root;
+}
+
+/** The weights that project a vector onto each unit direction.
+ *
+ * The score of direction i for a vector v is the sum of v[k] * weights[i][k],
+ * which is the cartesian dot product of v with the unit vector of direction i.
+ */
+template<tabled_direction Enum>
+inline constexpr auto direction_weights = [] {
+    using table = direction_table<Enum>;
+    using basis = direction_basis<Enum>;
+    constexpr std::size_t N = enum_size_v<Enum>;
+    constexpr std::size_t D = table::dimensions;
+    constexpr std::size_t C = basis::dimensions;
+
+    std::array<std::array<double, D>, N> weights{};
+    for (std::size_t i = 0; i < N; ++i) {
+        std::array<double, C> cartesian{};
+        for (std::size_t k = 0; k < D; ++k) {
+            for (std::size_t c = 0; c < C; ++c) {
+                cartesian[c] += table::offsets[i][k] * basis::axes[k][c];
+            }
+        }
+        double norm = 0.0;
+        for (double const c : cartesian) { norm += c * c; }
+        norm = constexpr_sqrt(norm);
+
+        for (std::size_t k = 0; k < D; ++k) {
+            double dot = 0.0;
+            for (std::size_t c = 0; c < C; ++c) {
+                dot += basis::axes[k][c] * cartesian[c];
+            }
+            weights[i][k] = dot / norm;
+        }
+    }
+    return weights;
+}();
+}
+
+/** A vector whose components line up with a direction set's offsets. */
+template<class Vector, class Enum>
+concept direction_vector =
+    tabled_direction<Enum> and
+    ((direction_table<Enum>::dimensions == 2 and semivector2<Vector>) or
+     (direction_table<Enum>::dimensions == 3 and semivector3<Vector>));
+
+/** The direction closest in angle to a vector.
+ *
+ * Each direction is scored by projecting the vector onto it, and the highest
+ * score wins. Vectors made by direction_as map back to the direction they came
+ * from. Exact ties and the zero vector resolve to the lowest direction in enum
+ * order.
+ */
+template<tabled_direction Enum, class Vector>
+    requires direction_vector<Vector, Enum>
+Enum nearest_direction(Vector const & vector)
+{
+    using Field = scalar_field_t<Vector>;
+    using Real = std::conditional_t<std::floating_point<Field>, Field, double>;
+    constexpr auto const & weights = detail::direction_weights<Enum>;
+    constexpr std::size_t D = direction_table<Enum>::dimensions;
+
+    std::array<Real, D> components{};
+    components[0] = static_cast<Real>(get_x(vector));
+    components[1] = static_cast<Real>(get_y(vector));
+    if constexpr (D == 3) { components[2] = static_cast<Real>(get_z(vector)); }
+
+    std::size_t best = 0;
+    Real best_score = 0;
+    for (std::size_t i = 0; i < weights.size(); ++i) {
+        Real score = 0;
+        for (std::size_t k = 0; k < D; ++k) {
+            score += components[k] * static_cast<Real>(weights[i][k]);
+        }
+        bool const better = i == 0 or score > best_score;
+        best = better ? i : best;
+        best_score = better ? score : best_score;
+    }
+    return static_cast<Enum>(best);
+}
+
+/** Find the nearest direction to every vector in a range.
+ *
+ * Parameters
+ *   policy - the execution policy to quantize with
+ *   vectors - the vectors to quantize
+ *   out - where to write the directions
+ */
+template<tabled_direction Enum, execution_policy Policy,
+         ranges::forward_range Range, std::forward_iterator Out>
+    requires direction_vector<ranges::range_value_t<Range>, Enum>
+Out nearest_direction(Policy && policy, Range const & vectors, Out out)
+{
+    using Vector = ranges::range_value_t<Range>;
+    return std::transform(std::forward<Policy>(policy),
+                          ranges::begin(vectors), ranges::end(vectors), out,
+                          [](Vector const & vector) {
+                              return nearest_direction<Enum>(vector);
+                          });
+}
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+// type constraints
+#include <type_traits>
+#include "spatula/directions.hpp"
+
+// data types and data structures
+#include <cstdint>
+#include <cstddef>
+#include <bit>
+#include <vector>
+
+namespace sp {
+
+/** The number of bits needed to store any value of a ranged_enum. */
+template<ranged_enum Enum>
+constexpr std::size_t enum_bits_v =
+    std::bit_width(enum_size_v<Enum> > 1 ? enum_size_v<Enum> - 1 : 1);
+
+/** A sequence of ranged_enum values packed into as few bits as possible.
+ *
+ * Each value takes enum_bits_v<Enum> bits: 2 for cardinal directions and 3 for
+ * the hex directions. Values never straddle a word boundary, so writes to
+ * values stored in different words never touch the same memory. Parallel
+ * writers should split their work on multiples of values_per_word.
+ */
+template<ranged_enum Enum>
+class packed_enum_vector {
+public:
+    using value_type = Enum;
+    using size_type = std::size_t;
+    using word_type = std::uint64_t;
+
+    static constexpr size_type bits_per_value = enum_bits_v<Enum>;
+    static constexpr size_type values_per_word = 64 / bits_per_value;
+
+    packed_enum_vector() = default;
+    explicit packed_enum_vector(size_type count, Enum value = Enum{})
+    {
+        resize(count, value);
+    }
+
+    size_type size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    void clear() { _words.clear(); _size = 0; }
+
+    /** The packed words backing the sequence. */
+    std::vector<word_type> const & words() const { return _words; }
+
+    Enum operator[](size_type i) const
+    {
+        auto const shift = (i % values_per_word) * bits_per_value;
+        return static_cast<Enum>((_words[i / values_per_word] >> shift) & mask);
+    }
+
+    void set(size_type i, Enum value)
+    {
+        auto const shift = (i % values_per_word) * bits_per_value;
+        auto & word = _words[i / values_per_word];
+        word = (word & ~(mask << shift)) |
+               ((static_cast<word_type>(value) & mask) << shift);
+    }
+
+    void push_back(Enum value)
+    {
+        if (_size % values_per_word == 0) { _words.push_back(0); }
+        set(_size++, value);
+    }
+
+    void resize(size_type count, Enum value = Enum{})
+    {
+        auto const old_size = _size;
+        _words.resize((count + values_per_word - 1) / values_per_word, 0);
+        _size = count;
+        for (size_type i = old_size; i < count; ++i) { set(i, value); }
+    }
+
+    friend bool operator==(packed_enum_vector const & a,
+                           packed_enum_vector const & b)
+    {
+        if (a._size != b._size) { return false; }
+        for (size_type i = 0; i < a._size; ++i) {
+            if (a[i] != b[i]) { return false; }
+        }
+        return true;
+    }
+private:
+    static constexpr word_type mask = (word_type{1} << bits_per_value) - 1;
+
+    std::vector<word_type> _words;
+    size_type _size = 0;
+};
+}
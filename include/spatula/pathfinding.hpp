@@ -0,0 +1,604 @@
+#pragma once
+
+// type constraints
+#include <type_traits>
+#include <concepts>
+#include "spatula/vectors.hpp"
+#include "spatula/directions.hpp"
+#include "spatula/execution.hpp"
+
+// data types and data structures
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <array>
+#include <vector>
+#include <queue>
+#include <unordered_map>
+#include "spatula/grids.hpp"
+#include "spatula/flow_fields.hpp"
+
+namespace sp {
+namespace detail {
+
+/** The rectangle of cells [x0, x1) x [y0, y1) that a search is confined to. */
+struct search_bounds {
+    int x0, y0, x1, y1;
+
+    bool contains(int x, int y) const
+    {
+        return x >= x0 and y >= y0 and x < x1 and y < y1;
+    }
+    std::size_t width() const { return static_cast<std::size_t>(x1 - x0); }
+    std::size_t size() const
+    {
+        return width() * static_cast<std::size_t>(y1 - y0);
+    }
+    std::size_t index_of(int x, int y) const
+    {
+        return static_cast<std::size_t>(y - y0) * width() +
+               static_cast<std::size_t>(x - x0);
+    }
+    grid_point point_of(std::size_t index) const
+    {
+        return grid_point{x0 + static_cast<int>(index % width()),
+                          y0 + static_cast<int>(index / width())};
+    }
+};
+
+template<class Cost>
+search_bounds whole_grid(grid<Cost> const & costs)
+{
+    return search_bounds{0, 0, static_cast<int>(costs.width()),
+                         static_cast<int>(costs.height())};
+}
+
+using search_entry = std::pair<std::uint32_t, std::size_t>;
+using search_queue = std::priority_queue<search_entry,
+                                         std::vector<search_entry>,
+                                         std::greater<>>;
+
+/** The cost of the cheapest path between a cell and every cell in bounds.
+ *
+ * Distances are measured from the source to each cell, or from each cell to
+ * the source when reverse is set. The result is indexed by bounds.index_of.
+ */
+template<ranged_enum Enum, std::unsigned_integral Cost>
+std::vector<std::uint32_t> search_distances(grid<Cost> const & costs,
+                                            grid_point source,
+                                            search_bounds const & bounds,
+                                            bool reverse = false)
+{
+    auto const offsets = directions_as<grid_point, Enum>();
+    std::vector<std::uint32_t> distances(bounds.size(), unreachable_distance);
+    search_queue open;
+
+    if (reverse and costs[source] == impassable_cost<Cost>) { return distances; }
+    distances[bounds.index_of(source.x, source.y)] = 0;
+    open.emplace(0, bounds.index_of(source.x, source.y));
+
+    while (not open.empty()) {
+        auto const [distance, index] = open.top();
+        open.pop();
+        if (distance != distances[index]) { continue; }
+
+        auto const cell = bounds.point_of(index);
+        for (auto const & offset : offsets) {
+            // walking backwards, a neighbor steps into the current cell
+            int const nx = reverse ? cell.x - offset.x : cell.x + offset.x;
+            int const ny = reverse ? cell.y - offset.y : cell.y + offset.y;
+            if (not bounds.contains(nx, ny) or
+                costs(nx, ny) == impassable_cost<Cost>) {
+                continue;
+            }
+            Cost const cost = reverse ? costs[cell] : costs(nx, ny);
+            std::uint32_t const candidate = add_distance(distance, cost);
+
+            std::size_t const neighbor = bounds.index_of(nx, ny);
+            if (candidate < distances[neighbor]) {
+                distances[neighbor] = candidate;
+                open.emplace(candidate, neighbor);
+            }
+        }
+    }
+    return distances;
+}
+
+/** Find the cheapest path between two cells with A*, confined to bounds. */
+template<ranged_enum Enum, std::unsigned_integral Cost>
+std::vector<grid_point> search_path(grid<Cost> const & costs,
+                                    grid_point start, grid_point goal,
+                                    search_bounds const & bounds)
+{
+    auto const offsets = directions_as<grid_point, Enum>();
+    step_distance<Enum> const heuristic{};
+    auto const estimate = [&](grid_point const & cell) {
+        return heuristic(goal.x - cell.x, goal.y - cell.y);
+    };
+
+    std::vector<grid_point> path;
+    if (not bounds.contains(start.x, start.y) or
+        not bounds.contains(goal.x, goal.y) or
+        costs[goal] == impassable_cost<Cost>) {
+        return path;
+    }
+    std::vector<std::uint32_t> distances(bounds.size(), unreachable_distance);
+    std::vector<std::uint8_t> arrived_by(bounds.size(), 0);
+    search_queue open;
+
+    std::size_t const first = bounds.index_of(start.x, start.y);
+    std::size_t const last = bounds.index_of(goal.x, goal.y);
+    distances[first] = 0;
+    open.emplace(estimate(start), first);
+
+    while (not open.empty()) {
+        auto const [priority, index] = open.top();
+        open.pop();
+        if (index == last) { break; }
+
+        auto const cell = bounds.point_of(index);
+        if (priority != add_distance(distances[index], estimate(cell))) {
+            continue;
+        }
+
+        for (std::size_t i = 0; i < offsets.size(); ++i) {
+            int const nx = cell.x + offsets[i].x;
+            int const ny = cell.y + offsets[i].y;
+            if (not bounds.contains(nx, ny) or
+                costs(nx, ny) == impassable_cost<Cost>) {
+                continue;
+            }
+            std::uint32_t const candidate =
+                add_distance(distances[index], costs(nx, ny));
+
+            std::size_t const neighbor = bounds.index_of(nx, ny);
+            if (candidate < distances[neighbor]) {
+                distances[neighbor] = candidate;
+                arrived_by[neighbor] = static_cast<std::uint8_t>(i);
+                open.emplace(add_distance(candidate,
+                                          estimate(grid_point{nx, ny})),
+                             neighbor);
+            }
+        }
+    }
+    if (distances[last] == unreachable_distance) { return path; }
+
+    for (grid_point cell = goal; cell != start;) {
+        path.push_back(cell);
+        auto const & offset = offsets[arrived_by[bounds.index_of(cell.x,
+                                                                 cell.y)]];
+        cell = grid_point{cell.x - offset.x, cell.y - offset.y};
+    }
+    path.push_back(start);
+    std::ranges::reverse(path);
+    return path;
+}
+}
+
+/** Find the cheapest path between two cells with A*.
+ *
+ * Parameters
+ *   costs - the cost of stepping into each cell, where the maximum value of
+ *           the cost type marks a wall
+ *   start - the cell to start from
+ *   goal - the cell to finish on
+ *
+ * Return
+ *   The cells of the path from start to goal inclusive, or an empty path if
+ *   the goal can't be reached.
+ */
+template<ranged_enum Enum, std::unsigned_integral Cost, grid_coordinate Vector>
+std::vector<grid_point> find_path(grid<Cost> const & costs,
+                                  Vector const & start, Vector const & goal)
+{
+    if (not costs.contains(start) or not costs.contains(goal)) { return {}; }
+    return detail::search_path<Enum>(costs, to_grid_point(start),
+                                     to_grid_point(goal),
+                                     detail::whole_grid(costs));
+}
+
+/** Hierarchical A* (HPA*) over a grid divided into square chunks.
+ *
+ * Each chunk keeps a small abstract graph: the entrance cells on its borders,
+ * the cheapest distance between every pair of them within the chunk, and the
+ * links stepping across into neighboring chunks. Long-range queries search this
+ * graph and then refine each abstract edge with a search confined to a single
+ * chunk, so the work scales with the number of chunks crossed rather than the
+ * number of cells.
+ *
+ * Paths are near-optimal: they're restricted to pass through the chosen
+ * entrances. Chunks marked with invalidate are rebuilt lazily on the next
+ * query, or eagerly in parallel with refresh.
+ *
+ * Note
+ *   The pathfinder keeps a reference to the cost grid, which must outlive it.
+ */
+template<ranged_enum Enum, std::unsigned_integral Cost>
+class hierarchical_pathfinder {
+public:
+    /** Runs of entrance cells at least this long get an entrance at each end. */
+    static constexpr std::size_t long_entrance = 6;
+
+    explicit hierarchical_pathfinder(grid<Cost> const & costs,
+                                     std::size_t chunk_size = 32)
+        : _costs{&costs}, _chunk_size{chunk_size},
+          _chunks_x{(costs.width() + chunk_size - 1) / chunk_size},
+          _chunks_y{(costs.height() + chunk_size - 1) / chunk_size},
+          _chunks(_chunks_x * _chunks_y)
+    {
+    }
+
+    std::size_t chunk_size() const { return _chunk_size; }
+    std::size_t chunks_x() const { return _chunks_x; }
+    std::size_t chunks_y() const { return _chunks_y; }
+
+    /** The number of entrance cells in the abstract graph. */
+    std::size_t node_count() const
+    {
+        std::size_t count = 0;
+        for (auto const & chunk : _chunks) { count += chunk.nodes.size(); }
+        return count;
+    }
+
+    /** Mark the chunk holding a cell as changed. */
+    void invalidate(int x, int y)
+    {
+        if (_costs->contains(x, y)) { _chunks[chunk_of(x, y)].dirty = true; }
+    }
+    template<grid_coordinate Vector>
+    void invalidate(Vector const & cell)
+    {
+        invalidate(static_cast<int>(get_x(cell)), static_cast<int>(get_y(cell)));
+    }
+
+    /** Rebuild the abstract graph of every changed chunk.
+     *
+     * Entrances are found sequentially, then the distances between the
+     * entrances of each affected chunk are computed in parallel.
+     */
+    template<execution_policy Policy>
+    void refresh(Policy && policy)
+    {
+        std::vector<std::size_t> dirty;
+        for (std::size_t i = 0; i < _chunks.size(); ++i) {
+            if (_chunks[i].dirty) { dirty.push_back(i); }
+        }
+        if (dirty.empty()) { return; }
+
+        std::vector<bool> affected(_chunks.size(), false);
+        for (std::size_t const chunk : dirty) {
+            affected[chunk] = true;
+            for (std::size_t const neighbor : neighbors_of(chunk)) {
+                // pairs of dirty chunks only need to be linked once
+                if (_chunks[neighbor].dirty and neighbor < chunk) { continue; }
+                link(chunk, neighbor);
+                link(neighbor, chunk);
+                affected[neighbor] = true;
+            }
+        }
+        std::vector<std::size_t> rebuilt;
+        for (std::size_t i = 0; i < _chunks.size(); ++i) {
+            if (affected[i]) { rebuilt.push_back(i); }
+        }
+        for (std::size_t const chunk : rebuilt) { collect_nodes(chunk); }
+
+        for_each_index(policy, rebuilt.size(), [&](std::size_t i) {
+            connect_nodes(rebuilt[i]);
+        });
+        for (std::size_t const chunk : dirty) { _chunks[chunk].dirty = false; }
+    }
+    void refresh() { refresh(std::execution::seq); }
+
+    /** Find a path between two cells.
+     *
+     * Return
+     *   The cells of the path from start to goal inclusive, or an empty path
+     *   if the goal can't be reached.
+     */
+    template<grid_coordinate Vector>
+    std::vector<grid_point> find_path(Vector const & start_cell,
+                                      Vector const & goal_cell)
+    {
+        refresh();
+        std::vector<grid_point> path;
+        if (not _costs->contains(start_cell) or
+            not _costs->contains(goal_cell)) {
+            return path;
+        }
+        auto const start = to_grid_point(start_cell);
+        auto const goal = to_grid_point(goal_cell);
+        std::size_t const start_index = _costs->index_of(start.x, start.y);
+        std::size_t const goal_index = _costs->index_of(goal.x, goal.y);
+        if (start_index == goal_index) { return {start}; }
+
+        // connect the endpoints to the entrances of their chunks
+        std::size_t const start_chunk = chunk_of(start.x, start.y);
+        std::size_t const goal_chunk = chunk_of(goal.x, goal.y);
+        auto const start_bounds = bounds_of(start_chunk);
+        auto const goal_bounds = bounds_of(goal_chunk);
+        auto const from_start = detail::search_distances<Enum>(
+            *_costs, start, start_bounds);
+        auto const to_goal = detail::search_distances<Enum>(
+            *_costs, goal, goal_bounds, true);
+
+        auto const abstract = search_abstract(start_index, goal_index,
+                                              from_start, to_goal);
+        if (abstract.empty()) { return path; }
+
+        // refine each abstract edge within a single chunk
+        path.push_back(start);
+        for (std::size_t i = 1; i < abstract.size(); ++i) {
+            auto const from = _costs->point_of(abstract[i - 1]);
+            auto const to = _costs->point_of(abstract[i]);
+            std::size_t const chunk = chunk_of(from.x, from.y);
+            if (chunk != chunk_of(to.x, to.y)) {
+                path.push_back(to);
+                continue;
+            }
+            auto const segment = detail::search_path<Enum>(
+                *_costs, from, to, bounds_of(chunk));
+            path.insert(path.end(), segment.begin() + 1, segment.end());
+        }
+        return path;
+    }
+private:
+    /** A step from an entrance cell into a neighboring chunk. */
+    struct link_type {
+        std::size_t from, to;
+        std::uint32_t cost;
+    };
+
+    struct chunk_graph {
+        std::vector<link_type> links;
+        std::vector<std::size_t> nodes;
+        std::vector<std::uint32_t> distances;
+        bool dirty = true;
+
+        std::size_t node_index(std::size_t cell) const
+        {
+            auto const found = std::ranges::find(nodes, cell);
+            return static_cast<std::size_t>(found - nodes.begin());
+        }
+    };
+
+    std::size_t chunk_of(int x, int y) const
+    {
+        return (static_cast<std::size_t>(y) / _chunk_size) * _chunks_x +
+               static_cast<std::size_t>(x) / _chunk_size;
+    }
+
+    detail::search_bounds bounds_of(std::size_t chunk) const
+    {
+        int const x0 = static_cast<int>((chunk % _chunks_x) * _chunk_size);
+        int const y0 = static_cast<int>((chunk / _chunks_x) * _chunk_size);
+        int const size = static_cast<int>(_chunk_size);
+        return detail::search_bounds{
+            x0, y0,
+            std::min(x0 + size, static_cast<int>(_costs->width())),
+            std::min(y0 + size, static_cast<int>(_costs->height()))
+        };
+    }
+
+    std::vector<std::size_t> neighbors_of(std::size_t chunk) const
+    {
+        std::vector<std::size_t> neighbors;
+        int const cx = static_cast<int>(chunk % _chunks_x);
+        int const cy = static_cast<int>(chunk / _chunks_x);
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                int const nx = cx + dx;
+                int const ny = cy + dy;
+                if ((dx == 0 and dy == 0) or nx < 0 or ny < 0 or
+                    nx >= static_cast<int>(_chunks_x) or
+                    ny >= static_cast<int>(_chunks_y)) {
+                    continue;
+                }
+                neighbors.push_back(static_cast<std::size_t>(ny) * _chunks_x +
+                                    static_cast<std::size_t>(nx));
+            }
+        }
+        return neighbors;
+    }
+
+    /** Choose the entrances that step from one chunk into another.
+     *
+     * Every passable step across the border is a candidate. Candidates are
+     * grouped by direction into contiguous runs along the border, and each
+     * run gets an entrance in its middle, or one at each end when it's long.
+     */
+    void link(std::size_t from_chunk, std::size_t to_chunk)
+    {
+        auto & links = _chunks[from_chunk].links;
+        std::erase_if(links, [&](link_type const & link) {
+            auto const to = _costs->point_of(link.to);
+            return chunk_of(to.x, to.y) == to_chunk;
+        });
+
+        // only the cells on the side facing the other chunk can step into it
+        auto const bounds = bounds_of(from_chunk);
+        int const dx = static_cast<int>(to_chunk % _chunks_x) -
+                       static_cast<int>(from_chunk % _chunks_x);
+        int const dy = static_cast<int>(to_chunk / _chunks_x) -
+                       static_cast<int>(from_chunk / _chunks_x);
+        int const edge_x = dx > 0 ? bounds.x1 - 1 : bounds.x0;
+        int const edge_y = dy > 0 ? bounds.y1 - 1 : bounds.y0;
+
+        std::vector<grid_point> edge;
+        if (dx != 0 and dy != 0) {
+            edge.push_back(grid_point{edge_x, edge_y});
+        } else if (dx != 0) {
+            for (int y = bounds.y0; y < bounds.y1; ++y) {
+                edge.push_back(grid_point{edge_x, y});
+            }
+        } else {
+            for (int x = bounds.x0; x < bounds.x1; ++x) {
+                edge.push_back(grid_point{x, edge_y});
+            }
+        }
+
+        auto const offsets = directions_as<grid_point, Enum>();
+        for (auto const & offset : offsets) {
+            std::vector<link_type> run;
+            auto const close_run = [&]() {
+                if (run.empty()) { return; }
+                if (run.size() >= long_entrance) {
+                    links.push_back(run.front());
+                    links.push_back(run.back());
+                } else {
+                    links.push_back(run[run.size() / 2]);
+                }
+                run.clear();
+            };
+            for (auto const & [x, y] : edge) {
+                int const nx = x + offset.x;
+                int const ny = y + offset.y;
+                bool const crosses =
+                    _costs->contains(nx, ny) and
+                    chunk_of(nx, ny) == to_chunk and
+                    (*_costs)(x, y) != impassable_cost<Cost> and
+                    (*_costs)(nx, ny) != impassable_cost<Cost>;
+                if (not crosses) {
+                    close_run();
+                    continue;
+                }
+                run.push_back(link_type{
+                    _costs->index_of(x, y), _costs->index_of(nx, ny),
+                    detail::add_distance(0, (*_costs)(nx, ny))
+                });
+            }
+            close_run();
+        }
+    }
+
+    /** Gather the entrance cells that lie within a chunk. */
+    void collect_nodes(std::size_t chunk)
+    {
+        auto & nodes = _chunks[chunk].nodes;
+        nodes.clear();
+        for (auto const & link : _chunks[chunk].links) {
+            nodes.push_back(link.from);
+        }
+        for (std::size_t const neighbor : neighbors_of(chunk)) {
+            for (auto const & link : _chunks[neighbor].links) {
+                auto const to = _costs->point_of(link.to);
+                if (chunk_of(to.x, to.y) == chunk) { nodes.push_back(link.to); }
+            }
+        }
+        std::ranges::sort(nodes);
+        auto const duplicates = std::ranges::unique(nodes);
+        nodes.erase(duplicates.begin(), duplicates.end());
+    }
+
+    /** Find the distance between every pair of entrances within a chunk. */
+    void connect_nodes(std::size_t chunk)
+    {
+        auto & graph = _chunks[chunk];
+        auto const bounds = bounds_of(chunk);
+        std::size_t const count = graph.nodes.size();
+        graph.distances.assign(count * count, unreachable_distance);
+
+        for (std::size_t i = 0; i < count; ++i) {
+            auto const distances = detail::search_distances<Enum>(
+                *_costs, _costs->point_of(graph.nodes[i]), bounds);
+            for (std::size_t j = 0; j < count; ++j) {
+                auto const node = _costs->point_of(graph.nodes[j]);
+                graph.distances[i * count + j] =
+                    distances[bounds.index_of(node.x, node.y)];
+            }
+        }
+    }
+
+    /** Search the abstract graph for a sequence of entrances to follow. */
+    std::vector<std::size_t> search_abstract(
+        std::size_t start, std::size_t goal,
+        std::vector<std::uint32_t> const & from_start,
+        std::vector<std::uint32_t> const & to_goal) const
+    {
+        auto const start_point = _costs->point_of(start);
+        auto const goal_point = _costs->point_of(goal);
+        std::size_t const start_chunk = chunk_of(start_point.x, start_point.y);
+        std::size_t const goal_chunk = chunk_of(goal_point.x, goal_point.y);
+        auto const start_bounds = bounds_of(start_chunk);
+        auto const goal_bounds = bounds_of(goal_chunk);
+
+        step_distance<Enum> const heuristic{};
+        auto const estimate = [&](std::size_t cell) {
+            auto const point = _costs->point_of(cell);
+            return heuristic(goal_point.x - point.x, goal_point.y - point.y);
+        };
+
+        std::unordered_map<std::size_t, std::uint32_t> distances;
+        std::unordered_map<std::size_t, std::size_t> parents;
+        detail::search_queue open;
+        distances[start] = 0;
+        open.emplace(estimate(start), start);
+
+        auto const relax = [&](std::size_t from, std::size_t to,
+                               std::uint32_t cost) {
+            if (cost == unreachable_distance) { return; }
+            std::uint32_t const candidate =
+                detail::add_distance(distances[from], cost);
+            auto const known = distances.find(to);
+            if (known != distances.end() and known->second <= candidate) {
+                return;
+            }
+            distances[to] = candidate;
+            parents[to] = from;
+            open.emplace(detail::add_distance(candidate, estimate(to)), to);
+        };
+
+        while (not open.empty()) {
+            auto const [priority, cell] = open.top();
+            open.pop();
+            if (cell == goal) { break; }
+            if (priority != detail::add_distance(distances[cell],
+                                                 estimate(cell))) {
+                continue;
+            }
+
+            auto const point = _costs->point_of(cell);
+            std::size_t const chunk = chunk_of(point.x, point.y);
+            auto const & graph = _chunks[chunk];
+
+            if (chunk == goal_chunk) {
+                relax(cell, goal, to_goal[goal_bounds.index_of(point.x,
+                                                               point.y)]);
+            }
+            if (cell == start) {
+                for (std::size_t const node : graph.nodes) {
+                    auto const p = _costs->point_of(node);
+                    relax(cell, node, from_start[start_bounds.index_of(p.x,
+                                                                       p.y)]);
+                }
+            } else {
+                std::size_t const i = graph.node_index(cell);
+                std::size_t const count = graph.nodes.size();
+                for (std::size_t j = 0; j < count; ++j) {
+                    relax(cell, graph.nodes[j], graph.distances[i * count + j]);
+                }
+            }
+            for (auto const & link : graph.links) {
+                if (link.from == cell) { relax(cell, link.to, link.cost); }
+            }
+        }
+
+        std::vector<std::size_t> path;
+        if (not distances.contains(goal)) { return path; }
+        for (std::size_t cell = goal; cell != start; cell = parents.at(cell)) {
+            path.push_back(cell);
+        }
+        path.push_back(start);
+        std::ranges::reverse(path);
+        return path;
+    }
+
+    grid<Cost> const * _costs;
+    std::size_t _chunk_size;
+    std::size_t _chunks_x;
+    std::size_t _chunks_y;
+    std::vector<chunk_graph> _chunks;
+};
+}
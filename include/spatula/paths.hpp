@@ -0,0 +1,299 @@
+#pragma once
+
+// type constraints
+#include <type_traits>
+#include <concepts>
+#include <ranges>
+#include <iterator>
+#include "spatula/vectors.hpp"
+#include "spatula/directions.hpp"
+
+// data types and data structures
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <array>
+#include <vector>
+#include <unordered_map>
+#include "spatula/grids.hpp"
+#include "spatula/packed_enums.hpp"
+
+namespace sp {
+
+/** A store of paths that can be invalidated by the cells they cross.
+ *
+ * Each cached path is indexed by every cell it visits, so invalidating a set
+ * of changed cells only touches the paths that actually run through them.
+ */
+class path_cache {
+public:
+    using path_id = std::size_t;
+
+    /** Add a path to the cache.
+     *
+     * Return
+     *   An id that refers to the path until it's erased or invalidated.
+     */
+    template<ranges::input_range Range>
+        requires grid_coordinate<ranges::range_value_t<Range>>
+    path_id insert(Range && path)
+    {
+        path_id const id = _next_id++;
+        auto & cells = _paths[id];
+        for (auto const & cell : path) {
+            cells.push_back(to_grid_point(cell));
+        }
+        for (auto const & cell : cells) {
+            auto & crossing = _crossings[key_of(cell)];
+            // paths that revisit a cell are only indexed by it once
+            if (crossing.empty() or crossing.back() != id) {
+                crossing.push_back(id);
+            }
+        }
+        return id;
+    }
+
+    bool contains(path_id id) const { return _paths.contains(id); }
+    std::size_t size() const { return _paths.size(); }
+    bool empty() const { return _paths.empty(); }
+
+    /** The cells of a cached path. */
+    std::vector<grid_point> const & path(path_id id) const
+    {
+        return _paths.at(id);
+    }
+
+    /** Remove a path from the cache. */
+    void erase(path_id id)
+    {
+        auto const found = _paths.find(id);
+        if (found == _paths.end()) { return; }
+
+        for (auto const & cell : found->second) {
+            auto const crossing = _crossings.find(key_of(cell));
+            if (crossing == _crossings.end()) { continue; }
+
+            std::erase(crossing->second, id);
+            if (crossing->second.empty()) { _crossings.erase(crossing); }
+        }
+        _paths.erase(found);
+    }
+
+    /** Erase every path that crosses any of the changed cells.
+     *
+     * Return
+     *   The ids of the erased paths.
+     */
+    template<ranges::input_range Range>
+        requires grid_coordinate<ranges::range_value_t<Range>>
+    std::vector<path_id> invalidate(Range && changed_cells)
+    {
+        std::vector<path_id> invalidated;
+        for (auto const & cell : changed_cells) {
+            auto const crossing = _crossings.find(key_of(to_grid_point(cell)));
+            if (crossing == _crossings.end()) { continue; }
+
+            invalidated.insert(invalidated.end(),
+                               crossing->second.begin(),
+                               crossing->second.end());
+        }
+        std::ranges::sort(invalidated);
+        auto const duplicates = std::ranges::unique(invalidated);
+        invalidated.erase(duplicates.begin(), duplicates.end());
+
+        for (path_id const id : invalidated) { erase(id); }
+        return invalidated;
+    }
+
+    void clear()
+    {
+        _paths.clear();
+        _crossings.clear();
+    }
+private:
+    static std::uint64_t key_of(grid_point const & cell)
+    {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(cell.x))
+                << 32) | static_cast<std::uint32_t>(cell.y);
+    }
+
+    path_id _next_id = 0;
+    std::unordered_map<path_id, std::vector<grid_point>> _paths;
+    std::unordered_map<std::uint64_t, std::vector<path_id>> _crossings;
+};
+
+/** A path stored as a start cell and a packed sequence of direction steps.
+ *
+ * Each step takes enum_bits_v<Enum> bits, so a cardinal path costs 2 bits per
+ * cell instead of a full coordinate. Cells are decoded lazily through
+ * direction_as. The cell reached every checkpoint_interval steps is also kept,
+ * so random access only has to replay the steps since the last checkpoint.
+ */
+template<ranged_enum Enum>
+class packed_path {
+public:
+    using value_type = grid_point;
+    using size_type = std::size_t;
+
+    static constexpr size_type checkpoint_interval = 64;
+
+    /** Walks the cells of a path, decoding one step at a time. */
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = grid_point;
+        using difference_type = std::ptrdiff_t;
+        using reference = grid_point;
+        using pointer = void;
+
+        iterator() = default;
+        iterator(packed_path const * path, size_type index, grid_point cell)
+            : _path{path}, _index{index}, _cell{cell}
+        {
+        }
+
+        grid_point operator*() const { return _cell; }
+        iterator & operator++()
+        {
+            if (_index < _path->step_count()) {
+                auto const & step = offsets()[_path->_steps[_index]];
+                _cell = grid_point{_cell.x + step.x, _cell.y + step.y};
+            }
+            ++_index;
+            return *this;
+        }
+        iterator operator++(int) { auto old = *this; ++*this; return old; }
+
+        friend bool operator==(iterator const & a, iterator const & b)
+        {
+            return a._index == b._index;
+        }
+    private:
+        packed_path const * _path = nullptr;
+        size_type _index = 0;
+        grid_point _cell{};
+    };
+
+    packed_path() = default;
+    template<grid_coordinate Vector>
+    explicit packed_path(Vector const & start)
+        : _checkpoints{to_grid_point(start)}, _last{to_grid_point(start)}
+    {
+    }
+
+    /** Encode a path of cells.
+     *
+     * Encoding stops at the first cell that isn't a single step away from the
+     * cell before it, so the result holds the longest legal prefix.
+     */
+    template<ranges::input_range Range>
+        requires grid_coordinate<ranges::range_value_t<Range>> and
+                 (not std::same_as<std::remove_cvref_t<Range>, packed_path>)
+    explicit packed_path(Range && cells)
+    {
+        auto it = ranges::begin(cells);
+        auto const end = ranges::end(cells);
+        if (it == end) { return; }
+
+        *this = packed_path{*it};
+        for (++it; it != end; ++it) {
+            if (not extend_to(*it)) { break; }
+        }
+    }
+
+    /** The number of cells on the path, including the start. */
+    size_type size() const
+    {
+        return _checkpoints.empty() ? 0 : _steps.size() + 1;
+    }
+    bool empty() const { return _checkpoints.empty(); }
+    size_type step_count() const { return _steps.size(); }
+
+    grid_point front() const { return _checkpoints.front(); }
+    grid_point back() const { return _last; }
+
+    /** The packed direction of each step. */
+    packed_enum_vector<Enum> const & steps() const { return _steps; }
+
+    /** Add a step to the end of the path.
+     *
+     * Return
+     *   false, leaving the path unchanged, if the path is empty. An empty path
+     *   has no start cell to step from, so it's started by constructing it
+     *   from a cell.
+     */
+    bool push_back(Enum step)
+    {
+        if (empty()) { return false; }
+        auto const & offset = offsets()[step];
+        _last = grid_point{_last.x + offset.x, _last.y + offset.y};
+        _steps.push_back(step);
+        if (_steps.size() % checkpoint_interval == 0) {
+            _checkpoints.push_back(_last);
+        }
+        return true;
+    }
+
+    /** Step to a neighbouring cell.
+     *
+     * Return
+     *   false, leaving the path unchanged, if the cell isn't one step away from
+     *   the end of the path.
+     */
+    template<grid_coordinate Vector>
+    bool extend_to(Vector const & cell)
+    {
+        auto const next = to_grid_point(cell);
+        grid_point const offset{next.x - _last.x, next.y - _last.y};
+        auto const & table = offsets();
+        auto const found = std::ranges::find(table, offset);
+        if (empty() or found == table.end()) { return false; }
+
+        return push_back(static_cast<Enum>(found - table.begin()));
+    }
+
+    /** The cell at a position along the path, replaying at most
+     * checkpoint_interval - 1 steps from the nearest checkpoint. */
+    grid_point operator[](size_type index) const
+    {
+        auto const checkpoint = index / checkpoint_interval;
+        grid_point cell = _checkpoints[checkpoint];
+        for (auto i = checkpoint * checkpoint_interval; i < index; ++i) {
+            auto const & step = offsets()[_steps[i]];
+            cell.x += step.x;
+            cell.y += step.y;
+        }
+        return cell;
+    }
+
+    iterator begin() const
+    {
+        return iterator{this, 0, empty() ? grid_point{} : front()};
+    }
+    iterator end() const { return iterator{this, size(), _last}; }
+
+    /** Decode every cell of the path. */
+    std::vector<grid_point> cells() const
+    {
+        std::vector<grid_point> decoded;
+        decoded.reserve(size());
+        std::ranges::copy(*this, std::back_inserter(decoded));
+        return decoded;
+    }
+
+    friend bool operator==(packed_path const & a, packed_path const & b)
+    {
+        return a._checkpoints == b._checkpoints and a._steps == b._steps;
+    }
+private:
+    static std::array<grid_point, enum_size_v<Enum>> const & offsets()
+    {
+        static auto const table = directions_as<grid_point, Enum>();
+        return table;
+    }
+
+    packed_enum_vector<Enum> _steps;
+    std::vector<grid_point> _checkpoints;
+    grid_point _last{};
+};
+}
@@ -0,0 +1,274 @@
+#pragma once
+
+// type constraints
+#include <type_traits>
+#include <concepts>
+#include <functional>
+#include "spatula/execution.hpp"
+
+// data types and data structures
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <span>
+#include <bit>
+#include <optional>
+#include <algorithm>
+#include <execution>
+#include "spatula/grids.hpp"
+
+namespace sp {
+
+namespace detail {
+inline std::size_t floor_log2(std::size_t n)
+{
+    return static_cast<std::size_t>(std::bit_width(n)) - 1;
+}
+}
+
+/** A two-dimensional sparse table, for the least cell of any rectangle in
+ * constant time.
+ *
+ * Level (i, j) of the table holds the least cell of every 2^i by 2^j block of
+ * the grid, so any rectangle is covered by four overlapping blocks of a single
+ * level. Cells are ordered by Compare, so std::less finds the minimum and
+ * std::greater the maximum.
+ *
+ * The table takes O(n log(width) log(height)) memory for a grid of n cells.
+ * For large grids, blocked_extremum_table answers the same queries in far
+ * less memory.
+ */
+template<std::totally_ordered T, class Compare = std::less<>>
+    requires std::strict_weak_order<Compare, T const &, T const &>
+class extremum_table {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    extremum_table() = default;
+    explicit extremum_table(grid<T> const & cells) { rebuild(cells); }
+
+    size_type width() const { return _width; }
+    size_type height() const { return _height; }
+
+    /** Build every level of the table from a grid.
+     *
+     * Each level is built from the one before it by combining pairs of rows
+     * or pairs of cells a row at a time, with rows scheduled under the
+     * execution policy.
+     */
+    template<execution_policy Policy>
+    void rebuild(Policy && policy, grid<T> const & cells)
+    {
+        _width = cells.width();
+        _height = cells.height();
+        _levels.clear();
+        if (cells.empty()) {
+            _columns = 0;
+            return;
+        }
+        _columns = detail::floor_log2(_width) + 1;
+        auto const rows = detail::floor_log2(_height) + 1;
+        _levels.reserve(_columns * rows);
+        for (size_type ky = 0; ky < rows; ++ky) {
+            for (size_type kx = 0; kx < _columns; ++kx) {
+                if (kx == 0 and ky == 0) {
+                    _levels.push_back(cells);
+                    continue;
+                }
+                grid<T> level(_width - (size_type{1} << kx) + 1,
+                              _height - (size_type{1} << ky) + 1);
+                // build along x from the level to the left, and along y from
+                // the level above
+                bool const across = kx > 0;
+                auto const & from = across ? _levels.back()
+                                           : _levels[(ky - 1) * _columns];
+                auto const half = size_type{1} << (across ? kx - 1 : ky - 1);
+                for_each_index(policy, level.height(), [&](size_type y) {
+                    auto const out = level.row(y);
+                    auto const a = from.row(y);
+                    auto const b = across ? a.subspan(half)
+                                          : from.row(y + half);
+                    for (size_type x = 0; x < out.size(); ++x) {
+                        out[x] = best(a[x], b[x]);
+                    }
+                });
+                _levels.push_back(std::move(level));
+            }
+        }
+    }
+    void rebuild(grid<T> const & cells)
+    {
+        rebuild(std::execution::seq, cells);
+    }
+
+    /** The least cell from first to last, inclusive.
+     *
+     * The region is clipped to the table. There is no least cell when the
+     * region misses the table entirely.
+     */
+    std::optional<T> query(grid_point first, grid_point last) const
+    {
+        auto const region = detail::clip_region(first, last, _width, _height);
+        if (region.empty()) { return std::nullopt; }
+        return query(region);
+    }
+    template<grid_rect Rect>
+    std::optional<T> query(Rect const & rect) const
+    {
+        return query(detail::rect_first(rect), detail::rect_last(rect));
+    }
+private:
+    template<std::totally_ordered U, class C>
+        requires std::strict_weak_order<C, U const &, U const &>
+    friend class blocked_extremum_table;
+
+    /** The least cell of a clipped region that holds at least one cell. */
+    T query(detail::cell_region const & region) const
+    {
+        auto const kx = detail::floor_log2(region.x1 - region.x0);
+        auto const ky = detail::floor_log2(region.y1 - region.y0);
+        auto const & level = _levels[ky * _columns + kx];
+        auto const x0 = static_cast<int>(region.x0);
+        auto const y0 = static_cast<int>(region.y0);
+        auto const x1 = static_cast<int>(region.x1 - (size_type{1} << kx));
+        auto const y1 = static_cast<int>(region.y1 - (size_type{1} << ky));
+        return best(best(level(x0, y0), level(x1, y0)),
+                    best(level(x0, y1), level(x1, y1)));
+    }
+    static T const & best(T const & a, T const & b)
+    {
+        return Compare{}(b, a) ? b : a;
+    }
+
+    size_type _width = 0;
+    size_type _height = 0;
+    size_type _columns = 0;
+    // level (kx, ky) lives at index ky * _columns + kx
+    std::vector<grid<T>> _levels;
+};
+
+/** A memory-light table for the least cell of any rectangle.
+ *
+ * The grid is split into square blocks of block_size cells a side, and a
+ * sparse table over the least cell of each block answers for every whole
+ * block a rectangle covers. The cells around those blocks, fewer than
+ * block_size deep on each side, are scanned a row at a time. The table takes
+ * a little more memory than the grid itself.
+ */
+template<std::totally_ordered T, class Compare = std::less<>>
+    requires std::strict_weak_order<Compare, T const &, T const &>
+class blocked_extremum_table {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    static constexpr size_type block_size = 16;
+
+    blocked_extremum_table() = default;
+    explicit blocked_extremum_table(grid<T> const & cells)
+    {
+        rebuild(cells);
+    }
+
+    size_type width() const { return _cells.width(); }
+    size_type height() const { return _cells.height(); }
+
+    /** Copy a grid and build the table over its blocks.
+     *
+     * Rows of blocks are reduced under the execution policy, as is each level
+     * of the sparse table over them.
+     */
+    template<execution_policy Policy>
+    void rebuild(Policy && policy, grid<T> const & cells)
+    {
+        _cells = cells;
+        auto const columns = (_cells.width() + block_size - 1) / block_size;
+        auto const rows = (_cells.height() + block_size - 1) / block_size;
+        grid<T> blocks(columns, rows);
+        for_each_index(policy, rows, [&](size_type by) {
+            auto const first = by * block_size;
+            auto const last = std::min(_cells.height(), first + block_size);
+            auto const out = blocks.row(by);
+            for (size_type bx = 0; bx < columns; ++bx) {
+                out[bx] = _cells(static_cast<int>(bx * block_size),
+                                 static_cast<int>(first));
+            }
+            for (auto y = first; y < last; ++y) {
+                auto const row = _cells.row(y);
+                for (size_type bx = 0; bx < columns; ++bx) {
+                    auto const x0 = bx * block_size;
+                    auto const x1 = std::min(row.size(), x0 + block_size);
+                    out[bx] = scan(row.subspan(x0, x1 - x0), out[bx]);
+                }
+            }
+        });
+        _blocks.rebuild(std::forward<Policy>(policy), blocks);
+    }
+    void rebuild(grid<T> const & cells)
+    {
+        rebuild(std::execution::seq, cells);
+    }
+
+    /** The least cell from first to last, inclusive.
+     *
+     * The region is clipped to the table. There is no least cell when the
+     * region misses the table entirely.
+     */
+    std::optional<T> query(grid_point first, grid_point last) const
+    {
+        auto const region = detail::clip_region(first, last, width(),
+                                                height());
+        if (region.empty()) { return std::nullopt; }
+
+        // the whole blocks the region covers
+        auto const bx0 = (region.x0 + block_size - 1) / block_size;
+        auto const by0 = (region.y0 + block_size - 1) / block_size;
+        auto const bx1 = region.x1 / block_size;
+        auto const by1 = region.y1 / block_size;
+        if (bx0 >= bx1 or by0 >= by1) {
+            return scan_rows(region, _cells(static_cast<int>(region.x0),
+                                            static_cast<int>(region.y0)));
+        }
+
+        auto least = _blocks.query(detail::cell_region{bx0, by0, bx1, by1});
+        auto const inner_x0 = bx0 * block_size;
+        auto const inner_y0 = by0 * block_size;
+        auto const inner_x1 = bx1 * block_size;
+        auto const inner_y1 = by1 * block_size;
+        // the strips above and below span the whole width of the region, and
+        // the strips to either side fill in between them
+        least = scan_rows({region.x0, region.y0, region.x1, inner_y0}, least);
+        least = scan_rows({region.x0, inner_y1, region.x1, region.y1}, least);
+        least = scan_rows({region.x0, inner_y0, inner_x0, inner_y1}, least);
+        least = scan_rows({inner_x1, inner_y0, region.x1, inner_y1}, least);
+        return least;
+    }
+    template<grid_rect Rect>
+    std::optional<T> query(Rect const & rect) const
+    {
+        return query(detail::rect_first(rect), detail::rect_last(rect));
+    }
+private:
+    static T scan(std::span<T const> cells, T least)
+    {
+        for (auto const & cell : cells) {
+            least = Compare{}(cell, least) ? cell : least;
+        }
+        return least;
+    }
+
+    T scan_rows(detail::cell_region const & region, T least) const
+    {
+        if (region.empty()) { return least; }
+        for (auto y = region.y0; y < region.y1; ++y) {
+            auto const row = _cells.row(y);
+            least = scan(row.subspan(region.x0, region.x1 - region.x0),
+                         least);
+        }
+        return least;
+    }
+
+    grid<T> _cells;
+    extremum_table<T, Compare> _blocks;
+};
+}
@@ -0,0 +1,248 @@
+#pragma once
+
+// type constraints
+#include <type_traits>
+#include <concepts>
+#include <ranges>
+#include "spatula/vectors.hpp"
+
+// data types and algorithms
+#include <cstddef>
+#include <span>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include "spatula/grids.hpp"
+#include "spatula/bit_grids.hpp"
+
+namespace sp {
+
+/** A vector that can place the corners or center of a shape on a grid. */
+template<class Vector>
+concept shape_vector = semivector2<Vector> and
+                       std::is_arithmetic_v<scalar_field_t<Vector>>;
+
+/** A filled circle. */
+template<shape_vector Vector>
+struct disk {
+    Vector center;
+    scalar_field_t<Vector> radius;
+};
+
+/** A filled triangle, with its corners in either winding order. */
+template<shape_vector Vector>
+struct triangle {
+    Vector a, b, c;
+};
+
+/** A filled convex polygon, with its corners in either winding order. */
+template<shape_vector Vector>
+struct convex_polygon {
+    std::span<Vector const> corners;
+};
+
+template<std::ranges::contiguous_range Range>
+convex_polygon(Range const &)
+    -> convex_polygon<std::ranges::range_value_t<Range>>;
+
+/** A run of cells in a single row, from x_begin up to but not including
+ * x_end. */
+struct grid_span {
+    int y;
+    int x_begin;
+    int x_end;
+    friend constexpr bool operator==(grid_span const &,
+                                     grid_span const &) = default;
+};
+
+namespace detail {
+/** A closed range of coordinates along one axis, empty when low > high. */
+struct raster_extent {
+    double low;
+    double high;
+};
+
+constexpr raster_extent empty_extent{
+    std::numeric_limits<double>::infinity(),
+    -std::numeric_limits<double>::infinity()};
+
+template<shape_vector Vector>
+raster_extent shape_rows(disk<Vector> const & shape)
+{
+    auto const y = static_cast<double>(get_y(shape.center));
+    auto const radius = static_cast<double>(shape.radius);
+    return raster_extent{y - radius, y + radius};
+}
+
+template<shape_vector Vector>
+raster_extent shape_row(disk<Vector> const & shape, double y)
+{
+    auto const dy = y - static_cast<double>(get_y(shape.center));
+    auto const radius = static_cast<double>(shape.radius);
+    auto const squared = radius * radius - dy * dy;
+    if (squared < 0.0) { return empty_extent; }
+    // exact for integer disks, since sqrt is correctly rounded and returns
+    // the exact root of a perfect square
+    auto const half = std::sqrt(squared);
+    auto const x = static_cast<double>(get_x(shape.center));
+    return raster_extent{x - half, x + half};
+}
+
+template<shape_vector Vector>
+raster_extent corner_rows(std::span<Vector const> corners)
+{
+    auto extent = empty_extent;
+    for (auto const & corner : corners) {
+        auto const y = static_cast<double>(get_y(corner));
+        extent.low = std::min(extent.low, y);
+        extent.high = std::max(extent.high, y);
+    }
+    return extent;
+}
+
+/** Where a row crosses the edges of a convex polygon.
+ *
+ * Every point where the row meets an edge lies on the polygon, so the row
+ * covers the polygon from the leftmost crossing to the rightmost one.
+ */
+template<shape_vector Vector>
+raster_extent corner_row(std::span<Vector const> corners, double y)
+{
+    auto extent = empty_extent;
+    for (std::size_t i = 0; i < corners.size(); ++i) {
+        auto const & from = corners[i];
+        auto const & to = corners[(i + 1) % corners.size()];
+        auto const x0 = static_cast<double>(get_x(from));
+        auto const y0 = static_cast<double>(get_y(from));
+        auto const x1 = static_cast<double>(get_x(to));
+        auto const y1 = static_cast<double>(get_y(to));
+        if (y < std::min(y0, y1) or y > std::max(y0, y1)) { continue; }
+        if (y0 == y1) {
+            extent.low = std::min({extent.low, x0, x1});
+            extent.high = std::max({extent.high, x0, x1});
+            continue;
+        }
+        // a single division keeps crossings of integer corners exact
+        auto const x = (x0 * (y1 - y) + x1 * (y - y0)) / (y1 - y0);
+        extent.low = std::min(extent.low, x);
+        extent.high = std::max(extent.high, x);
+    }
+    return extent;
+}
+
+template<shape_vector Vector>
+raster_extent shape_rows(triangle<Vector> const & shape)
+{
+    Vector const corners[] = {shape.a, shape.b, shape.c};
+    return corner_rows(std::span<Vector const>{corners});
+}
+
+template<shape_vector Vector>
+raster_extent shape_row(triangle<Vector> const & shape, double y)
+{
+    Vector const corners[] = {shape.a, shape.b, shape.c};
+    return corner_row(std::span<Vector const>{corners}, y);
+}
+
+template<shape_vector Vector>
+raster_extent shape_rows(convex_polygon<Vector> const & shape)
+{
+    return corner_rows(shape.corners);
+}
+
+template<shape_vector Vector>
+raster_extent shape_row(convex_polygon<Vector> const & shape, double y)
+{
+    return corner_row(shape.corners, y);
+}
+
+/** The cells whose centers lie within an extent, clipped to [0, size). */
+inline bool clip_extent(raster_extent extent, std::size_t size,
+                        int & first, int & last)
+{
+    auto const low = std::max(std::ceil(extent.low), 0.0);
+    auto const high = std::min(std::floor(extent.high),
+                               static_cast<double>(size) - 1.0);
+    // also rejects extents that are not a number
+    if (not (low <= high)) { return false; }
+    first = static_cast<int>(low);
+    last = static_cast<int>(high);
+    return true;
+}
+}
+
+/** A shape that can be rasterized into a grid one row at a time. */
+template<class Shape>
+concept raster_shape = requires(Shape const & shape, double y) {
+    { detail::shape_rows(shape) } -> std::same_as<detail::raster_extent>;
+    { detail::shape_row(shape, y) } -> std::same_as<detail::raster_extent>;
+};
+
+/** Visit the spans of cells covered by a shape, one row at a time.
+ *
+ * The cell at (x, y) is centered on the point (x, y), and is covered when its
+ * center lies inside or on the edge of the shape. Spans are clipped to the
+ * bounds, visited in order of increasing y, and never empty.
+ *
+ * Parameters
+ *   shape - the disk, triangle or convex polygon to rasterize
+ *   bounds - the grid to clip spans to
+ *   visit - called with each grid_span
+ */
+template<raster_shape Shape, grid_bounds Grid,
+         std::invocable<grid_span> Visit>
+void rasterize_spans(Shape const & shape, Grid const & bounds, Visit visit)
+{
+    int first_row, last_row;
+    if (not detail::clip_extent(detail::shape_rows(shape), bounds.height(),
+                                first_row, last_row)) {
+        return;
+    }
+    for (int y = first_row; y <= last_row; ++y) {
+        int first, last;
+        auto const extent = detail::shape_row(shape, static_cast<double>(y));
+        if (detail::clip_extent(extent, bounds.width(), first, last)) {
+            visit(grid_span{y, first, last + 1});
+        }
+    }
+}
+
+/** Set every cell covered by a shape to a value.
+ *
+ * Each row of the shape is filled as a single span, so only the cells the
+ * shape covers are ever touched.
+ */
+template<raster_shape Shape, class T>
+void rasterize(grid<T> & cells, Shape const & shape,
+               std::type_identity_t<T> const & value)
+{
+    rasterize_spans(shape, cells, [&](grid_span span) {
+        auto const row = cells.row(static_cast<std::size_t>(span.y));
+        std::fill(row.begin() + span.x_begin, row.begin() + span.x_end,
+                  value);
+    });
+}
+
+/** Set or clear every cell covered by a shape, a word at a time. */
+template<raster_shape Shape>
+void rasterize(bit_grid & bits, Shape const & shape, bool value = true)
+{
+    using word_type = bit_grid::word_type;
+    constexpr std::size_t word_bits = bit_grid::word_bits;
+    rasterize_spans(shape, bits, [&](grid_span span) {
+        auto const words = bits.row(static_cast<std::size_t>(span.y));
+        auto begin = static_cast<std::size_t>(span.x_begin);
+        auto const end = static_cast<std::size_t>(span.x_end);
+        while (begin < end) {
+            auto const w = begin / word_bits;
+            auto const stop = std::min(end, (w + 1) * word_bits);
+            auto const count = stop - begin;
+            auto const ones = count == word_bits ? ~word_type{0}
+                                                 : (word_type{1} << count) - 1;
+            auto const mask = ones << (begin % word_bits);
+            words[w] = value ? words[w] | mask : words[w] & ~mask;
+            begin = stop;
+        }
+    });
+}
+}
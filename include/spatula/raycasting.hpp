@@ -0,0 +1,470 @@
+#pragma once
+
+// type constraints
+#include <type_traits>
+#include <concepts>
+#include <iterator>
+#include <ranges>
+#include "spatula/vectors.hpp"
+
+// data types and algorithms
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include "spatula/grids.hpp"
+
+namespace sp {
+
+/** A vector that can describe a ray through a grid of squares or cubes. */
+template<class Vector>
+concept ray_vector = (semivector2<Vector> or semivector3<Vector>) and
+                     std::is_arithmetic_v<scalar_field_t<Vector>>;
+
+/** The number of dimensions a ray vector moves through. */
+template<ray_vector Vector>
+constexpr std::size_t ray_dimensions_v = semivector3<Vector> ? 3 : 2;
+
+namespace detail {
+template<std::size_t D>
+using traversal_cell = std::conditional_t<D == 2, grid_point, voxel_point>;
+
+inline constexpr double no_crossing = std::numeric_limits<double>::infinity();
+
+template<std::size_t D, ray_vector Vector>
+std::array<double, D> ray_components(Vector const & vector)
+{
+    if constexpr (D == 3) {
+        return {static_cast<double>(get_x(vector)),
+                static_cast<double>(get_y(vector)),
+                static_cast<double>(get_z(vector))};
+    }
+    else {
+        return {static_cast<double>(get_x(vector)),
+                static_cast<double>(get_y(vector))};
+    }
+}
+
+template<std::size_t D>
+traversal_cell<D> to_traversal_cell(std::array<int, D> const & cell)
+{
+    if constexpr (D == 3) { return voxel_point{cell[0], cell[1], cell[2]}; }
+    else { return grid_point{cell[0], cell[1]}; }
+}
+
+/** Where a ray crosses into the next cell along each axis.
+ *
+ * Rays follow origin + t * direction, and cell (i, j) covers [i, i + 1) by
+ * [j, j + 1). Each step moves along the axis whose next crossing comes first,
+ * after Amanatides and Woo.
+ */
+template<std::size_t D>
+struct ray_stepper {
+    std::array<int, D> cell{};
+    std::array<int, D> step{};
+    std::array<double, D> next{};
+    std::array<double, D> delta{};
+
+    ray_stepper() = default;
+    ray_stepper(std::array<double, D> const & origin,
+                std::array<double, D> const & direction,
+                std::array<int, D> const & start)
+        : cell{start}
+    {
+        for (std::size_t a = 0; a < D; ++a) {
+            if (direction[a] > 0.0) {
+                step[a] = 1;
+                next[a] = (cell[a] + 1 - origin[a]) / direction[a];
+                delta[a] = 1.0 / direction[a];
+            }
+            else if (direction[a] < 0.0) {
+                step[a] = -1;
+                next[a] = (cell[a] - origin[a]) / direction[a];
+                delta[a] = -1.0 / direction[a];
+            }
+            else {
+                next[a] = no_crossing;
+                delta[a] = no_crossing;
+            }
+        }
+    }
+
+    /** Step into the next cell, and return the t where the ray enters it. */
+    double advance()
+    {
+        std::size_t axis = 0;
+        for (std::size_t a = 1; a < D; ++a) {
+            axis = next[a] < next[axis] ? a : axis;
+        }
+        double const t = next[axis];
+        cell[axis] += step[axis];
+        next[axis] += delta[axis];
+        return t;
+    }
+};
+
+/** The cell holding a point. */
+template<std::size_t D>
+std::array<int, D> containing_cell(std::array<double, D> const & point)
+{
+    std::array<int, D> cell;
+    for (std::size_t a = 0; a < D; ++a) {
+        cell[a] = static_cast<int>(std::floor(point[a]));
+    }
+    return cell;
+}
+}
+
+/** The cells a ray passes through, in order.
+ *
+ * The view is lazy and never allocates: each step of the iterator moves one
+ * cell along the ray. Iterators also report the t at which the ray enters
+ * their cell, which is a distance when the direction has unit length.
+ */
+template<std::size_t D>
+class cell_traversal_view
+    : public std::ranges::view_interface<cell_traversal_view<D>> {
+public:
+    using cell_type = detail::traversal_cell<D>;
+
+    class iterator {
+    public:
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = cell_type;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        iterator(cell_traversal_view const * view)
+            : _view{view}, _stepper{view->_stepper}, _t{view->_t_start},
+              _done{view->_empty}
+        {
+        }
+
+        cell_type operator*() const
+        {
+            return detail::to_traversal_cell<D>(_stepper.cell);
+        }
+        /** The t at which the ray enters the current cell. */
+        double distance() const { return _t; }
+
+        iterator & operator++()
+        {
+            _t = _stepper.advance();
+            _done = _t >= _view->_t_end or not _view->bounded(_stepper.cell);
+            return *this;
+        }
+        iterator operator++(int) { auto old = *this; ++*this; return old; }
+
+        friend bool operator==(iterator const & a, iterator const & b)
+        {
+            if (a._done or b._done) { return a._done == b._done; }
+            return a._t == b._t and a._stepper.cell == b._stepper.cell;
+        }
+        friend bool operator==(iterator const & it, std::default_sentinel_t)
+        {
+            return it._done;
+        }
+    private:
+        cell_traversal_view const * _view = nullptr;
+        detail::ray_stepper<D> _stepper{};
+        double _t = 0.0;
+        bool _done = true;
+    };
+
+    cell_traversal_view() = default;
+
+    /** Follow a ray from t = 0 up to, but not including, t = max_distance. */
+    cell_traversal_view(std::array<double, D> const & origin,
+                        std::array<double, D> const & direction,
+                        double max_distance)
+        : _stepper{origin, direction, detail::containing_cell<D>(origin)},
+          _t_end{max_distance}, _empty{max_distance <= 0.0}
+    {
+        std::ranges::fill(_low, std::numeric_limits<int>::min());
+        std::ranges::fill(_high, std::numeric_limits<int>::max());
+    }
+
+    /** Follow a ray through the box of cells from 0 up to extent.
+     *
+     * Rays that start outside the box begin at the first cell they enter.
+     */
+    cell_traversal_view(std::array<double, D> const & origin,
+                        std::array<double, D> const & direction,
+                        std::array<int, D> const & extent,
+                        double max_distance)
+        : _high{extent}
+    {
+        // clip the ray to each pair of planes that bound the box
+        double enter = 0.0;
+        double exit = max_distance;
+        for (std::size_t a = 0; a < D; ++a) {
+            if (direction[a] == 0.0) {
+                bool const inside = origin[a] >= 0.0 and origin[a] < extent[a];
+                exit = inside ? exit : -1.0;
+                continue;
+            }
+            auto t0 = -origin[a] / direction[a];
+            auto t1 = (extent[a] - origin[a]) / direction[a];
+            if (t0 > t1) { std::swap(t0, t1); }
+            enter = std::max(enter, t0);
+            exit = std::min(exit, t1);
+        }
+        _empty = enter >= exit;
+
+        std::array<double, D> start;
+        for (std::size_t a = 0; a < D; ++a) {
+            start[a] = origin[a] + enter * direction[a];
+        }
+        auto cell = detail::containing_cell<D>(start);
+        for (std::size_t a = 0; a < D; ++a) {
+            // rounding can leave the entry point a hair outside the box
+            cell[a] = std::clamp(cell[a], 0, std::max(extent[a] - 1, 0));
+        }
+        _empty = _empty or not bounded(cell);
+        _stepper = detail::ray_stepper<D>{origin, direction, cell};
+        _t_start = enter;
+        _t_end = exit;
+    }
+
+    iterator begin() const { return iterator{this}; }
+    std::default_sentinel_t end() const { return std::default_sentinel; }
+private:
+    bool bounded(std::array<int, D> const & cell) const
+    {
+        for (std::size_t a = 0; a < D; ++a) {
+            if (cell[a] < _low[a] or cell[a] >= _high[a]) { return false; }
+        }
+        return true;
+    }
+
+    detail::ray_stepper<D> _stepper{};
+    std::array<int, D> _low{};
+    std::array<int, D> _high{};
+    double _t_start = 0.0;
+    double _t_end = 0.0;
+    bool _empty = true;
+};
+
+/** The cells along a ray, from the cell holding its origin.
+ *
+ * Parameters
+ *   origin - where the ray starts, in cell units
+ *   direction - the direction of the ray
+ *   max_distance - the t at which to stop, in multiples of direction
+ */
+template<ray_vector Vector>
+cell_traversal_view<ray_dimensions_v<Vector>>
+traverse_cells(Vector const & origin, Vector const & direction,
+               double max_distance = detail::no_crossing)
+{
+    constexpr auto D = ray_dimensions_v<Vector>;
+    return cell_traversal_view<D>{detail::ray_components<D>(origin),
+                                  detail::ray_components<D>(direction),
+                                  max_distance};
+}
+
+/** The cells along a ray that lie within a grid. */
+template<ray_vector Vector, grid_bounds Grid>
+    requires (ray_dimensions_v<Vector> == 2)
+cell_traversal_view<2>
+traverse_cells(Vector const & origin, Vector const & direction,
+               Grid const & grid, double max_distance = detail::no_crossing)
+{
+    return cell_traversal_view<2>{
+        detail::ray_components<2>(origin),
+        detail::ray_components<2>(direction),
+        {static_cast<int>(grid.width()), static_cast<int>(grid.height())},
+        max_distance};
+}
+
+/** The cells along a ray that lie within a box of voxels from the origin
+ * up to extent. */
+template<ray_vector Vector>
+    requires (ray_dimensions_v<Vector> == 3)
+cell_traversal_view<3>
+traverse_cells(Vector const & origin, Vector const & direction,
+               voxel_point const & extent,
+               double max_distance = detail::no_crossing)
+{
+    return cell_traversal_view<3>{
+        detail::ray_components<3>(origin),
+        detail::ray_components<3>(direction),
+        {extent.x, extent.y, extent.z}, max_distance};
+}
+
+/** Several rays that step through cells together, one lane per ray.
+ *
+ * The state of every ray is stored lane by lane in arrays of doubles, and
+ * advance runs the same arithmetic for every lane, masking off stopped lanes
+ * by their active flag rather than skipping them. A lane stops once its ray
+ * passes its maximum distance, leaves the bounds of the packet, or is stopped
+ * by hand.
+ *
+ * Rays in a bounded packet should start within the bounds, since lanes that
+ * start outside are stopped straight away.
+ */
+template<std::size_t Lanes, std::size_t D = 2>
+    requires (D == 2 or D == 3)
+class ray_packet {
+public:
+    using cell_type = detail::traversal_cell<D>;
+    static constexpr std::size_t lanes = Lanes;
+
+    ray_packet() = default;
+
+    template<ray_vector Vector>
+        requires (ray_dimensions_v<Vector> == D)
+    ray_packet(std::array<Vector, Lanes> const & origins,
+               std::array<Vector, Lanes> const & directions,
+               double max_distance = detail::no_crossing)
+    {
+        std::array<int, D> low, high;
+        std::ranges::fill(low, std::numeric_limits<int>::min());
+        std::ranges::fill(high, std::numeric_limits<int>::max());
+        init(origins, directions, low, high, max_distance);
+    }
+
+    template<ray_vector Vector>
+        requires (ray_dimensions_v<Vector> == D)
+    ray_packet(std::array<Vector, Lanes> const & origins,
+               std::array<Vector, Lanes> const & directions,
+               std::array<int, D> const & extent,
+               double max_distance = detail::no_crossing)
+    {
+        init(origins, directions, std::array<int, D>{}, extent, max_distance);
+    }
+
+    bool active(std::size_t lane) const { return _active[lane] != 0.0; }
+    bool any_active() const
+    {
+        return std::ranges::any_of(_active, [](double a) { return a != 0.0; });
+    }
+
+    /** The cell a lane's ray is in. */
+    cell_type cell(std::size_t lane) const
+    {
+        std::array<int, D> cell;
+        for (std::size_t a = 0; a < D; ++a) {
+            cell[a] = static_cast<int>(_cell[a][lane]);
+        }
+        return detail::to_traversal_cell<D>(cell);
+    }
+    /** The t at which a lane's ray entered its cell. */
+    double distance(std::size_t lane) const { return _t[lane]; }
+
+    void stop(std::size_t lane) { _active[lane] = 0.0; }
+
+    /** Move every active ray into its next cell. */
+    void advance()
+    {
+        // every lane runs the same arithmetic, and a lane that has stopped
+        // moves by its active flag of 0 rather than being skipped
+        for (std::size_t lane = 0; lane < Lanes; ++lane) {
+            double const active = _active[lane];
+            double t = _next[0][lane];
+            for (std::size_t a = 1; a < D; ++a) {
+                t = std::min(t, _next[a][lane]);
+            }
+            double inside = t < _t_end[lane] ? active : 0.0;
+            // ties go to the first axis, just like a single ray
+            bool taken = false;
+            for (std::size_t a = 0; a < D; ++a) {
+                bool const first = (_next[a][lane] == t) & not taken;
+                double const move = first ? active : 0.0;
+                taken |= first;
+                _next[a][lane] += move * _delta[a][lane];
+                _cell[a][lane] += move * _step[a][lane];
+                inside = _cell[a][lane] >= _low[a] ? inside : 0.0;
+                inside = _cell[a][lane] < _high[a] ? inside : 0.0;
+            }
+            _t[lane] = active != 0.0 ? t : _t[lane];
+            _active[lane] = inside;
+        }
+    }
+private:
+    template<class Vector>
+    void init(std::array<Vector, Lanes> const & origins,
+              std::array<Vector, Lanes> const & directions,
+              std::array<int, D> const & low, std::array<int, D> const & high,
+              double max_distance)
+    {
+        std::ranges::copy(low, _low.begin());
+        std::ranges::copy(high, _high.begin());
+        for (std::size_t lane = 0; lane < Lanes; ++lane) {
+            auto const origin = detail::ray_components<D>(origins[lane]);
+            detail::ray_stepper<D> const stepper{
+                origin, detail::ray_components<D>(directions[lane]),
+                detail::containing_cell<D>(origin)};
+            bool inside = max_distance > 0.0;
+            for (std::size_t a = 0; a < D; ++a) {
+                _cell[a][lane] = stepper.cell[a];
+                _step[a][lane] = stepper.step[a];
+                _next[a][lane] = stepper.next[a];
+                // rays never step along axes they run parallel to
+                _delta[a][lane] = stepper.step[a] == 0 ? 0.0 : stepper.delta[a];
+                inside = inside and stepper.cell[a] >= low[a] and
+                                    stepper.cell[a] < high[a];
+            }
+            _t[lane] = 0.0;
+            _t_end[lane] = max_distance;
+            _active[lane] = inside ? 1.0 : 0.0;
+        }
+    }
+
+    std::array<std::array<double, Lanes>, D> _cell{};
+    std::array<std::array<double, Lanes>, D> _step{};
+    std::array<std::array<double, Lanes>, D> _next{};
+    std::array<std::array<double, Lanes>, D> _delta{};
+    std::array<double, Lanes> _t{};
+    std::array<double, Lanes> _t_end{};
+    std::array<double, Lanes> _active{};
+    std::array<double, D> _low{};
+    std::array<double, D> _high{};
+};
+
+template<ray_vector Vector, std::size_t Lanes>
+ray_packet(std::array<Vector, Lanes> const &,
+           std::array<Vector, Lanes> const &)
+    -> ray_packet<Lanes, ray_dimensions_v<Vector>>;
+
+template<ray_vector Vector, std::size_t Lanes>
+ray_packet(std::array<Vector, Lanes> const &,
+           std::array<Vector, Lanes> const &, double)
+    -> ray_packet<Lanes, ray_dimensions_v<Vector>>;
+
+template<ray_vector Vector, std::size_t Lanes, std::size_t D>
+ray_packet(std::array<Vector, Lanes> const &,
+           std::array<Vector, Lanes> const &, std::array<int, D> const &)
+    -> ray_packet<Lanes, ray_dimensions_v<Vector>>;
+
+template<ray_vector Vector, std::size_t Lanes, std::size_t D>
+ray_packet(std::array<Vector, Lanes> const &,
+           std::array<Vector, Lanes> const &, std::array<int, D> const &,
+           double)
+    -> ray_packet<Lanes, ray_dimensions_v<Vector>>;
+
+/** Step a packet of rays until every lane stops.
+ *
+ * Parameters
+ *   packet - the rays to step
+ *   visit - called with each active lane and its cell, returning false to
+ *           stop that lane
+ */
+template<std::size_t Lanes, std::size_t D, class Visit>
+    requires std::predicate<Visit &, std::size_t,
+                            detail::traversal_cell<D>>
+void traverse_packet(ray_packet<Lanes, D> & packet, Visit visit)
+{
+    while (packet.any_active()) {
+        for (std::size_t lane = 0; lane < Lanes; ++lane) {
+            if (packet.active(lane) and not visit(lane, packet.cell(lane))) {
+                packet.stop(lane);
+            }
+        }
+        packet.advance();
+    }
+}
+}
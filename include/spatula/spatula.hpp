@@ -1,3 +1,27 @@
 #pragma once
 
 #include "spatula/math.hpp"
+#include "spatula/grids.hpp"
+#include "spatula/flow_fields.hpp"
+#include "spatula/paths.hpp"
+#include "spatula/pathfinding.hpp"
+#include "spatula/hexes.hpp"
+#include "spatula/hex_maps.hpp"
+#include "spatula/nearest_directions.hpp"
+#include "spatula/direction_sets.hpp"
+#include "spatula/symmetry.hpp"
+#include "spatula/autotiling.hpp"
+#include "spatula/bit_grids.hpp"
+#include "spatula/automata.hpp"
+#include "spatula/stencils.hpp"
+#include "spatula/influence_maps.hpp"
+#include "spatula/raycasting.hpp"
+#include "spatula/visibility.hpp"
+#include "spatula/lines.hpp"
+#include "spatula/rasterization.hpp"
+#include "spatula/distance_transforms.hpp"
+#include "spatula/summed_area_tables.hpp"
+#include "spatula/range_queries.hpp"
+#include "spatula/grid_pyramids.hpp"
+#include "spatula/components.hpp"
+#include "spatula/contours.hpp"
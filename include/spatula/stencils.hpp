@@ -0,0 +1,276 @@
+#pragma once
+
+// type constraints
+#include <type_traits>
+#include <concepts>
+#include "spatula/directions.hpp"
+#include "spatula/execution.hpp"
+
+// data types and algorithms
+#include <cstddef>
+#include <array>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <execution>
+#include "spatula/grids.hpp"
+
+namespace sp {
+
+/** A function that finds a cell's new value from its old value and the values
+ * of its neighbours, given in the order of the Enum direction table. */
+template<class Kernel, class T, class Enum>
+concept stencil_kernel =
+    adjacent_direction<Enum> and
+    std::invocable<Kernel const &, T const &,
+                   std::array<T, enum_size_v<Enum>> const &>;
+
+namespace detail {
+/** The most iterations a tile advances before syncing with its neighbours. */
+inline constexpr std::size_t stencil_temporal_depth = 4;
+
+/** A rectangle of cells on a grid, [x0, x1) by [y0, y1). */
+struct stencil_region {
+    std::ptrdiff_t x0, y0, x1, y1;
+};
+
+/** A grid split into tiles of the same size, except along its far edges. */
+struct stencil_tiling {
+    std::ptrdiff_t width, height;
+    std::ptrdiff_t tile_width, tile_height;
+
+    std::ptrdiff_t columns() const
+    {
+        return (width + tile_width - 1) / tile_width;
+    }
+    std::size_t size() const
+    {
+        auto const rows = (height + tile_height - 1) / tile_height;
+        return static_cast<std::size_t>(columns() * rows);
+    }
+    stencil_region operator[](std::size_t tile) const
+    {
+        auto const index = static_cast<std::ptrdiff_t>(tile);
+        auto const x0 = (index % columns()) * tile_width;
+        auto const y0 = (index / columns()) * tile_height;
+        return stencil_region{x0, y0, std::min(width, x0 + tile_width),
+                              std::min(height, y0 + tile_height)};
+    }
+};
+
+/** Cells laid out row by row, covering a region of a larger grid. */
+template<class T>
+struct stencil_buffer {
+    T * cells;
+    stencil_region bounds;
+
+    T & operator()(std::ptrdiff_t x, std::ptrdiff_t y) const
+    {
+        return cells[(y - bounds.y0) * (bounds.x1 - bounds.x0) +
+                     (x - bounds.x0)];
+    }
+};
+
+/** Apply a kernel to every cell of a region.
+ *
+ * Neighbours that fall off the edge of the whole grid take the value of the
+ * cell itself. Every other neighbour of the region must lie within from.
+ */
+template<adjacent_direction Enum, class T, class U, class Kernel>
+void apply_stencil_region(stencil_buffer<T const> from,
+                          stencil_buffer<U> to, stencil_region region,
+                          std::ptrdiff_t width, std::ptrdiff_t height,
+                          Kernel const & kernel)
+{
+    constexpr auto const & offsets = direction_table<Enum>::offsets;
+    constexpr std::size_t N = offsets.size();
+    using neighbours = std::array<T, N>;
+
+    auto const stride = from.bounds.x1 - from.bounds.x0;
+    std::array<std::ptrdiff_t, N> deltas;
+    for (std::size_t i = 0; i < N; ++i) {
+        deltas[i] = offsets[i][1] * stride + offsets[i][0];
+    }
+
+    // cells on the edge of the grid check each neighbour
+    auto const apply_edge = [&](std::ptrdiff_t x, std::ptrdiff_t y) {
+        T const & center = from(x, y);
+        neighbours around;
+        for (std::size_t i = 0; i < N; ++i) {
+            auto const nx = x + offsets[i][0];
+            auto const ny = y + offsets[i][1];
+            bool const inside = nx >= 0 and ny >= 0 and
+                                nx < width and ny < height;
+            around[i] = inside ? from(nx, ny) : center;
+        }
+        to(x, y) = static_cast<U>(kernel(center, around));
+    };
+
+    for (auto y = region.y0; y < region.y1; ++y) {
+        bool const inner_row = y > 0 and y < height - 1;
+        auto const inner_x0 = inner_row ? std::max<std::ptrdiff_t>(
+                                              region.x0, 1)
+                                        : region.x1;
+        auto const inner_x1 =
+            std::max(inner_x0, std::min(region.x1, width - 1));
+
+        for (auto x = region.x0; x < inner_x0; ++x) { apply_edge(x, y); }
+
+        // cells inside the grid read their neighbours at fixed offsets
+        T const * center = &from(inner_x0, y);
+        U * out = &to(inner_x0, y);
+        for (auto x = inner_x0; x < inner_x1; ++x, ++center, ++out) {
+            auto const around = [&]<std::size_t... I>(
+                std::index_sequence<I...>) {
+                return neighbours{center[deltas[I]]...};
+            }(std::make_index_sequence<N>{});
+            *out = static_cast<U>(kernel(*center, around));
+        }
+
+        for (auto x = inner_x1; x < region.x1; ++x) { apply_edge(x, y); }
+    }
+}
+
+}
+
+/** Apply a kernel over the neighbourhood of every cell on a grid.
+ *
+ * The kernel is called with each cell of the input grid and its neighbours in
+ * the order of the Enum direction table, and its result is stored in the same
+ * cell of the output grid. Neighbours that fall off the edge of the grid take
+ * the value of the cell itself, so sums and averages see no flux across the
+ * edge. Hex grids are indexed by their axial (q, r) coordinates.
+ *
+ * The grid is split into bands of whole rows that run under the execution
+ * policy, so each band streams through memory. Cells away from the edges read
+ * their neighbours at fixed index offsets.
+ *
+ * Parameters
+ *   policy - the execution policy to schedule tiles with
+ *   in - the cells to read
+ *   out - where to write the new cells, resized to match in if needed
+ *   kernel - the function to find each new cell with
+ */
+template<adjacent_direction Enum, execution_policy Policy,
+         class T, class U, stencil_kernel<T, Enum> Kernel>
+    requires (not std::same_as<T, bool>) and (not std::same_as<U, bool>)
+void stencil_apply(Policy && policy, grid<T> const & in, grid<U> & out,
+                   Kernel kernel)
+{
+    if (out.width() != in.width() or out.height() != in.height()) {
+        out = grid<U>(in.width(), in.height());
+    }
+    if (in.empty()) { return; }
+    auto const width = static_cast<std::ptrdiff_t>(in.width());
+    auto const height = static_cast<std::ptrdiff_t>(in.height());
+    detail::stencil_region const whole{0, 0, width, height};
+    detail::stencil_tiling const bands{width, height, width, 16};
+
+    for_each_index(std::forward<Policy>(policy), bands.size(),
+                   [&](std::size_t band) {
+        detail::apply_stencil_region<Enum>(
+            detail::stencil_buffer<T const>{in.data(), whole},
+            detail::stencil_buffer<U>{out.data(), whole},
+            bands[band], width, height, kernel);
+    });
+}
+
+template<adjacent_direction Enum, class T, class U,
+         stencil_kernel<T, Enum> Kernel>
+    requires (not std::same_as<T, bool>) and (not std::same_as<U, bool>)
+void stencil_apply(grid<T> const & in, grid<U> & out, Kernel kernel)
+{
+    stencil_apply<Enum>(std::execution::seq, in, out, std::move(kernel));
+}
+
+/** Apply a kernel over a grid several times, in place.
+ *
+ * Each iteration behaves exactly like the single pass form. With temporal
+ * blocking, each tile is copied out along with a halo of neighbouring cells,
+ * one cell deep per iteration, and advanced several iterations while it's
+ * still in cache. Only then are tiles written back, so the whole grid is swept
+ * once every few iterations rather than once per iteration.
+ *
+ * Parameters
+ *   policy - the execution policy to schedule tiles with
+ *   cells - the cells to advance
+ *   kernel - the function to find each new cell with
+ *   iterations - the number of times to apply the kernel
+ */
+template<adjacent_direction Enum, execution_policy Policy,
+         class T, stencil_kernel<T, Enum> Kernel>
+    requires (not std::same_as<T, bool>) and
+             std::convertible_to<
+                 std::invoke_result_t<Kernel const &, T const &,
+                                      std::array<T, enum_size_v<Enum>>
+                                          const &>, T>
+void stencil_apply(Policy && policy, grid<T> & cells, Kernel kernel,
+                   std::size_t iterations)
+{
+    if (cells.empty()) { return; }
+    auto const width = static_cast<std::ptrdiff_t>(cells.width());
+    auto const height = static_cast<std::ptrdiff_t>(cells.height());
+    detail::stencil_tiling const tiles{width, height, 256, 32};
+    grid<T> next(cells.width(), cells.height());
+
+    while (iterations > 0) {
+        auto const depth =
+            std::min(iterations, detail::stencil_temporal_depth);
+        auto const halo = static_cast<std::ptrdiff_t>(depth);
+
+        for_each_index(policy, tiles.size(), [&](std::size_t tile) {
+            auto const core = tiles[tile];
+            detail::stencil_region const bounds{
+                std::max<std::ptrdiff_t>(core.x0 - halo, 0),
+                std::max<std::ptrdiff_t>(core.y0 - halo, 0),
+                std::min(core.x1 + halo, width),
+                std::min(core.y1 + halo, height)};
+            auto const area = static_cast<std::size_t>(
+                (bounds.x1 - bounds.x0) * (bounds.y1 - bounds.y0));
+
+            std::vector<T> current(area);
+            std::vector<T> advanced(area);
+            detail::stencil_buffer<T> const whole{cells.data(),
+                                                  {0, 0, width, height}};
+            detail::stencil_buffer<T> const local{current.data(), bounds};
+            for (auto y = bounds.y0; y < bounds.y1; ++y) {
+                std::copy_n(&whole(bounds.x0, y), bounds.x1 - bounds.x0,
+                            &local(bounds.x0, y));
+            }
+
+            // the cells that can be trusted shrink by one per iteration,
+            // except along the edges of the grid
+            for (std::ptrdiff_t step = 1; step <= halo; ++step) {
+                detail::stencil_region const valid{
+                    bounds.x0 == 0 ? 0 : bounds.x0 + step,
+                    bounds.y0 == 0 ? 0 : bounds.y0 + step,
+                    bounds.x1 == width ? width : bounds.x1 - step,
+                    bounds.y1 == height ? height : bounds.y1 - step};
+                detail::apply_stencil_region<Enum>(
+                    detail::stencil_buffer<T const>{current.data(), bounds},
+                    detail::stencil_buffer<T>{advanced.data(), bounds},
+                    valid, width, height, kernel);
+                std::swap(current, advanced);
+            }
+
+            detail::stencil_buffer<T> const result{current.data(), bounds};
+            detail::stencil_buffer<T> const target{next.data(),
+                                                   {0, 0, width, height}};
+            for (auto y = core.y0; y < core.y1; ++y) {
+                std::copy_n(&result(core.x0, y), core.x1 - core.x0,
+                            &target(core.x0, y));
+            }
+        });
+        std::swap(cells, next);
+        iterations -= depth;
+    }
+}
+
+template<adjacent_direction Enum, class T, stencil_kernel<T, Enum> Kernel>
+    requires (not std::same_as<T, bool>)
+void stencil_apply(grid<T> & cells, Kernel kernel, std::size_t iterations)
+{
+    stencil_apply<Enum>(std::execution::seq, cells, std::move(kernel),
+                        iterations);
+}
+}
@@ -0,0 +1,201 @@
+#pragma once
+
+// type constraints
+#include <type_traits>
+#include <concepts>
+#include "spatula/execution.hpp"
+
+// data types and data structures
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <span>
+#include <optional>
+#include <algorithm>
+#include <execution>
+#include "spatula/grids.hpp"
+
+namespace sp {
+
+/** A table of running sums over a grid, for the sum of any rectangle of cells
+ * in constant time.
+ *
+ * Integral cells are summed as std::int64_t and floating point cells as
+ * double. Rows are grouped into bands, and each band keeps running sums of its
+ * own cells alongside the sums of every row above it, so that changing a few
+ * cells only rebuilds the bands they lie in.
+ */
+template<class T>
+    requires std::is_arithmetic_v<T>
+class summed_area_table {
+public:
+    using value_type = T;
+    using sum_type = std::conditional_t<std::is_floating_point_v<T>,
+                                        double, std::int64_t>;
+    using size_type = std::size_t;
+    static constexpr size_type band_height = 64;
+
+    summed_area_table() = default;
+    explicit summed_area_table(grid<T> const & cells) { rebuild(cells); }
+
+    size_type width() const { return _width; }
+    size_type height() const { return _height; }
+
+    /** Sum a whole grid into the table.
+     *
+     * Bands of rows are summed in parallel under the execution policy, then
+     * the totals of each band are carried down into the bands below.
+     */
+    template<execution_policy Policy>
+    void rebuild(Policy && policy, grid<T> const & cells)
+    {
+        _width = cells.width();
+        _height = cells.height();
+        auto const bands = (_height + band_height - 1) / band_height;
+        _sums.assign((_width + 1) * _height, sum_type{0});
+        _above.assign((_width + 1) * bands, sum_type{0});
+        for_each_index(std::forward<Policy>(policy), bands,
+                       [&](size_type band) { sum_band(cells, band); });
+        carry_from(0);
+    }
+    void rebuild(grid<T> const & cells)
+    {
+        rebuild(std::execution::seq, cells);
+    }
+
+    /** Re-sum the cells from first to last, inclusive, after they change.
+     *
+     * Only the bands of rows the region touches are summed again, and the
+     * bands below them take the new totals.
+     *
+     * Parameters
+     *   cells - the same grid the table was built from, with its new values
+     *   first, last - the corners of the region that changed
+     */
+    void update(grid<T> const & cells, grid_point first, grid_point last)
+    {
+        auto const y0 = std::max(first.y, 0);
+        auto const y1 = std::min(last.y, static_cast<int>(_height) - 1);
+        if (y0 > y1) { return; }
+        auto const first_band = static_cast<size_type>(y0) / band_height;
+        auto const last_band = static_cast<size_type>(y1) / band_height;
+        for (auto band = first_band; band <= last_band; ++band) {
+            sum_band(cells, band);
+        }
+        carry_from(first_band);
+    }
+    template<grid_rect Rect>
+    void update(grid<T> const & cells, Rect const & rect)
+    {
+        update(cells, detail::rect_first(rect), detail::rect_last(rect));
+    }
+
+    /** The sum of every cell from first to last, inclusive.
+     *
+     * The region is clipped to the table, and sums to 0 when it misses the
+     * table entirely.
+     */
+    sum_type sum(grid_point first, grid_point last) const
+    {
+        auto const [x0, y0, x1, y1] =
+            detail::clip_region(first, last, _width, _height);
+        if (x0 >= x1 or y0 >= y1) { return sum_type{0}; }
+        return prefix(x1, y1) - prefix(x0, y1) - prefix(x1, y0) +
+               prefix(x0, y0);
+    }
+    template<grid_rect Rect>
+    sum_type sum(Rect const & rect) const
+    {
+        return sum(detail::rect_first(rect), detail::rect_last(rect));
+    }
+
+    /** The number of cells from first to last, inclusive, within the table.
+     */
+    size_type count(grid_point first, grid_point last) const
+    {
+        auto const [x0, y0, x1, y1] =
+            detail::clip_region(first, last, _width, _height);
+        if (x0 >= x1 or y0 >= y1) { return 0; }
+        return (x1 - x0) * (y1 - y0);
+    }
+    template<grid_rect Rect>
+    size_type count(Rect const & rect) const
+    {
+        return count(detail::rect_first(rect), detail::rect_last(rect));
+    }
+
+    /** The mean of the cells from first to last, inclusive, within the table.
+     *
+     * There is no mean when the region misses the table entirely.
+     */
+    std::optional<double> mean(grid_point first, grid_point last) const
+    {
+        auto const cells = count(first, last);
+        if (cells == 0) { return std::nullopt; }
+        return static_cast<double>(sum(first, last)) /
+               static_cast<double>(cells);
+    }
+    template<grid_rect Rect>
+    std::optional<double> mean(Rect const & rect) const
+    {
+        return mean(detail::rect_first(rect), detail::rect_last(rect));
+    }
+private:
+    /** The sum of every cell left of x and above y. */
+    sum_type prefix(size_type x, size_type y) const
+    {
+        if (y == 0) { return sum_type{0}; }
+        auto const row = y - 1;
+        auto const band = row / band_height;
+        return _above[band * (_width + 1) + x] +
+               _sums[row * (_width + 1) + x];
+    }
+
+    /** Sum the cells of one band, from the top of the band down. */
+    void sum_band(grid<T> const & cells, size_type band)
+    {
+        auto const first = band * band_height;
+        auto const last = std::min(_height, first + band_height);
+        auto const stride = _width + 1;
+        for (auto y = first; y < last; ++y) {
+            auto const row = cells.row(y);
+            sum_type * const sums = _sums.data() + y * stride;
+            sums[0] = sum_type{0};
+            for (size_type x = 0; x < _width; ++x) {
+                sums[x + 1] = sums[x] + static_cast<sum_type>(row[x]);
+            }
+            if (y == first) { continue; }
+            // then add the row above to turn row sums into table sums
+            sum_type const * const above = sums - stride;
+            for (size_type x = 1; x <= _width; ++x) { sums[x] += above[x]; }
+        }
+    }
+
+    /** Carry the totals of each band from a given one down into the rest. */
+    void carry_from(size_type first_band)
+    {
+        auto const stride = _width + 1;
+        auto const bands = _above.size() / stride;
+        for (auto band = first_band + 1; band < bands; ++band) {
+            auto const last_row = band * band_height - 1;
+            sum_type const * const previous =
+                _above.data() + (band - 1) * stride;
+            sum_type const * const totals = _sums.data() + last_row * stride;
+            sum_type * const above = _above.data() + band * stride;
+            for (size_type x = 0; x < stride; ++x) {
+                above[x] = previous[x] + totals[x];
+            }
+        }
+    }
+
+    size_type _width = 0;
+    size_type _height = 0;
+    // running sums of each row within its band, with a leading column of 0
+    std::vector<sum_type> _sums;
+    // running sums of every row above each band, with a leading column of 0
+    std::vector<sum_type> _above;
+};
+
+template<class T>
+summed_area_table(grid<T> const &) -> summed_area_table<T>;
+}
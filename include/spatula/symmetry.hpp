@@ -0,0 +1,271 @@
+#pragma once
+
+// type constraints
+#include <type_traits>
+#include <concepts>
+#include "spatula/vectors.hpp"
+#include "spatula/directions.hpp"
+
+// data types and data structures
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <functional>
+#include <algorithm>
+#include "spatula/grids.hpp"
+#include "spatula/hex_maps.hpp"
+
+namespace sp {
+
+/** The dihedral symmetry group of a lattice, described by its directions.
+ *
+ * Specializations define
+ *   rotations - the number of turns that map the lattice onto itself
+ *   turn_step - how many direction_table turns make up one lattice turn
+ *   mirror - the image of each direction when the lattice is mirrored
+ *
+ * Square lattices have the group D4, with four rotations, and hex lattices have
+ * D6, with six. Each mirror reflects the lattice across its north-south axis.
+ */
+template<tabled_direction Enum>
+struct dihedral_symmetry;
+
+template<>
+struct dihedral_symmetry<cardinal::direction_name> {
+    using enum cardinal::direction_name;
+    static constexpr std::size_t rotations = 4;
+    static constexpr int turn_step = 1;
+    static constexpr std::array<cardinal::direction_name, 4> mirror{
+        north, west, south, east
+    };
+};
+
+template<>
+struct dihedral_symmetry<octile::direction_name> {
+    using enum octile::direction_name;
+    static constexpr std::size_t rotations = 4;
+    static constexpr int turn_step = 2;
+    static constexpr std::array<octile::direction_name, 8> mirror{
+        north, northwest, west, southwest, south, southeast, east, northeast
+    };
+};
+
+template<>
+struct dihedral_symmetry<flat_hex::direction_name> {
+    using enum flat_hex::direction_name;
+    static constexpr std::size_t rotations = 6;
+    static constexpr int turn_step = 1;
+    static constexpr std::array<flat_hex::direction_name, 6> mirror{
+        north, northwest, southwest, south, southeast, northeast
+    };
+};
+
+template<>
+struct dihedral_symmetry<pointed_hex::direction_name> {
+    using enum pointed_hex::direction_name;
+    static constexpr std::size_t rotations = 6;
+    static constexpr int turn_step = 1;
+    static constexpr std::array<pointed_hex::direction_name, 6> mirror{
+        northwest, west, southwest, southeast, east, northeast
+    };
+};
+
+/** A direction set with a dihedral symmetry group. */
+template<class Enum>
+concept symmetric_direction = tabled_direction<Enum> and
+                              direction_table<Enum>::dimensions == 2 and
+requires {
+    dihedral_symmetry<Enum>::rotations;
+    dihedral_symmetry<Enum>::turn_step;
+    dihedral_symmetry<Enum>::mirror;
+};
+
+/** An element of a dihedral group: an optional mirror, then clockwise turns. */
+struct lattice_symmetry {
+    int turns = 0;
+    bool mirrored = false;
+    friend constexpr bool operator==(lattice_symmetry const &,
+                                     lattice_symmetry const &) = default;
+};
+
+/** The number of symmetries of a lattice: 8 for D4 and 12 for D6. */
+template<symmetric_direction Enum>
+constexpr std::size_t symmetry_order_v = 2 * dihedral_symmetry<Enum>::rotations;
+
+/** Every symmetry of a lattice, starting with the identity. */
+template<symmetric_direction Enum>
+inline constexpr auto symmetries_v = [] {
+    constexpr auto rotations = dihedral_symmetry<Enum>::rotations;
+    std::array<lattice_symmetry, symmetry_order_v<Enum>> group{};
+    for (std::size_t i = 0; i < group.size(); ++i) {
+        group[i] = lattice_symmetry{static_cast<int>(i % rotations),
+                                    i >= rotations};
+    }
+    return group;
+}();
+
+namespace detail {
+/** The image of every direction under every symmetry, indexed by mirrored
+ * turns, then by direction. */
+template<symmetric_direction Enum>
+inline constexpr auto symmetry_tables = [] {
+    using group = dihedral_symmetry<Enum>;
+    constexpr std::size_t N = enum_size_v<Enum>;
+    std::array<std::array<Enum, N>, symmetry_order_v<Enum>> tables{};
+    for (std::size_t g = 0; g < tables.size(); ++g) {
+        auto const symmetry = symmetries_v<Enum>[g];
+        for (std::size_t i = 0; i < N; ++i) {
+            auto const dir = static_cast<Enum>(i);
+            tables[g][i] = rotate_direction(
+                symmetry.mirrored ? group::mirror[dir] : dir,
+                symmetry.turns * group::turn_step);
+        }
+    }
+    return tables;
+}();
+
+template<symmetric_direction Enum>
+constexpr std::size_t symmetry_index(lattice_symmetry symmetry)
+{
+    constexpr auto rotations =
+        static_cast<int>(dihedral_symmetry<Enum>::rotations);
+    auto const turns = ((symmetry.turns % rotations) + rotations) % rotations;
+    return static_cast<std::size_t>(turns) +
+           (symmetry.mirrored ? dihedral_symmetry<Enum>::rotations : 0);
+}
+
+/** The direction with a given offset. */
+template<symmetric_direction Enum>
+constexpr Enum direction_with_offset(int x, int y)
+{
+    auto const & offsets = direction_table<Enum>::offsets;
+    for (std::size_t i = 0; i < offsets.size(); ++i) {
+        if (offsets[i][0] == x and offsets[i][1] == y) {
+            return static_cast<Enum>(i);
+        }
+    }
+    return static_cast<Enum>(0);
+}
+}
+
+/** Apply a symmetry to a direction. */
+template<symmetric_direction Enum>
+constexpr Enum transform_direction(Enum direction, lattice_symmetry symmetry)
+{
+    return detail::symmetry_tables<Enum>
+        [detail::symmetry_index<Enum>(symmetry)][direction];
+}
+
+/** Apply a symmetry to an offset on the lattice.
+ *
+ * Symmetries are linear, so offsets follow the images of the two unit axis
+ * directions, and always agree with transform_direction.
+ */
+template<symmetric_direction Enum, grid_coordinate Vector>
+Vector transform_offset(Vector const & offset, lattice_symmetry symmetry)
+{
+    using Field = scalar_field_t<Vector>;
+    auto const & offsets = direction_table<Enum>::offsets;
+    constexpr Enum x_axis = detail::direction_with_offset<Enum>(1, 0);
+    constexpr Enum y_axis = detail::direction_with_offset<Enum>(0, 1);
+    auto const & a = offsets[transform_direction(x_axis, symmetry)];
+    auto const & b = offsets[transform_direction(y_axis, symmetry)];
+
+    auto const x = get_x(offset);
+    auto const y = get_y(offset);
+    return Vector{static_cast<Field>(x * a[0] + y * b[0]),
+                  static_cast<Field>(x * a[1] + y * b[1])};
+}
+
+/** Apply a symmetry to a rectangular patch of a square lattice.
+ *
+ * The patch turns about its center, so odd turns swap its width and height.
+ */
+template<symmetric_direction Enum, class T>
+    requires (dihedral_symmetry<Enum>::rotations == 4)
+grid<T> transform_patch(grid<T> const & patch, lattice_symmetry symmetry)
+{
+    bool const swapped = detail::symmetry_index<Enum>(symmetry) % 2 == 1;
+    auto const width = swapped ? patch.height() : patch.width();
+    auto const height = swapped ? patch.width() : patch.height();
+    grid<T> result(width, height);
+
+    // offsets from the center are measured in half cells to stay integral
+    auto const w = static_cast<int>(patch.width()) - 1;
+    auto const h = static_cast<int>(patch.height()) - 1;
+    auto const rw = static_cast<int>(width) - 1;
+    auto const rh = static_cast<int>(height) - 1;
+    for (int y = 0; y <= h; ++y) {
+        for (int x = 0; x <= w; ++x) {
+            auto const moved = transform_offset<Enum>(
+                grid_point{2 * x - w, 2 * y - h}, symmetry);
+            result((moved.x + rw) / 2, (moved.y + rh) / 2) = patch(x, y);
+        }
+    }
+    return result;
+}
+
+/** Apply a symmetry to a hexagon-shaped patch, about its center hex. */
+template<symmetric_direction Enum, class T>
+hexagon_map<T, Enum> transform_patch(hexagon_map<T, Enum> const & patch,
+                                     lattice_symmetry symmetry)
+{
+    hexagon_map<T, Enum> result(patch.radius());
+    for (std::size_t i = 0; i < patch.size(); ++i) {
+        result[transform_offset<Enum>(patch.hex_of(i), symmetry)] = patch[i];
+    }
+    return result;
+}
+
+/** A patch in canonical form, with the symmetry that produced it. */
+template<class Patch>
+struct canonical_patch {
+    Patch patch;
+    lattice_symmetry symmetry;
+};
+
+/** Find the canonical form of a patch.
+ *
+ * Every symmetric image of the patch is compared cell by cell, and the
+ * lexicographically smallest wins, so patches that differ only by a rotation or
+ * a mirror share a canonical form. Ties go to the earliest symmetry in
+ * symmetries_v. Rectangular grid patches are compared by their cells alone, so
+ * square patches should be preferred for matching.
+ */
+template<symmetric_direction Enum, class Patch>
+    requires requires(Patch const & patch, lattice_symmetry symmetry) {
+        transform_patch<Enum>(patch, symmetry);
+    }
+canonical_patch<Patch> canonicalize(Patch const & patch)
+{
+    canonical_patch<Patch> best{patch, lattice_symmetry{}};
+    for (auto const symmetry : symmetries_v<Enum>) {
+        if (symmetry == lattice_symmetry{}) { continue; }
+        auto image = transform_patch<Enum>(patch, symmetry);
+        bool const smaller = std::ranges::lexicographical_compare(
+            image, best.patch, [](auto const & a, auto const & b) {
+                return a < b;
+            });
+        if (smaller) {
+            best.patch = std::move(image);
+            best.symmetry = symmetry;
+        }
+    }
+    return best;
+}
+
+/** A hash of a patch that's the same for all of its symmetric images. */
+template<symmetric_direction Enum, class Patch>
+std::size_t symmetry_hash(Patch const & patch)
+{
+    auto const canonical = canonicalize<Enum>(patch).patch;
+    // FNV-1a over the hashes of the cells
+    std::uint64_t hash = 14695981039346656037ull;
+    for (auto const & cell : canonical) {
+        using Cell = std::remove_cvref_t<decltype(cell)>;
+        hash ^= static_cast<std::uint64_t>(std::hash<Cell>{}(cell));
+        hash *= 1099511628211ull;
+    }
+    return static_cast<std::size_t>(hash);
+}
+}
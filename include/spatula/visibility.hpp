@@ -0,0 +1,385 @@
+#pragma once
+
+// type constraints
+#include <type_traits>
+#include <concepts>
+#include "spatula/directions.hpp"
+#include "spatula/execution.hpp"
+
+// data types and algorithms
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <span>
+#include <algorithm>
+#include <execution>
+#include "spatula/grids.hpp"
+#include "spatula/bit_grids.hpp"
+#include "spatula/hexes.hpp"
+
+namespace sp {
+
+/** A direction set whose grid light can be cast across: square grids with
+ * cardinal or octile directions, and hex grids indexed by axial (q, r). */
+template<class Enum>
+concept sight_direction = adjacent_direction<Enum> and
+                          (hex_layout<Enum> or enum_size_v<Enum> == 4 or
+                           enum_size_v<Enum> == 8);
+
+/** A cell to look out from, and how far it can see. */
+struct viewpoint {
+    grid_point cell;
+    int radius;
+};
+
+/** A pair of cells to check for a clear line of sight. */
+struct sight_line {
+    grid_point from;
+    grid_point to;
+};
+
+namespace detail {
+/** A wedge of cells around a viewpoint, walked one row at a time.
+ *
+ * The cell at a column of a row lies at origin + depth * forward + column *
+ * side. Square grids split into four quadrants whose columns run from -depth
+ * to depth, and hex grids into six sextants whose columns run from 0 to depth,
+ * along one side of the ring at that depth.
+ */
+struct fov_sector {
+    std::array<int, 2> forward;
+    std::array<int, 2> side;
+};
+
+template<sight_direction Enum>
+constexpr auto fov_sectors()
+{
+    if constexpr (hex_layout<Enum>) {
+        constexpr auto const & offsets = direction_table<Enum>::offsets;
+        std::array<fov_sector, 6> sectors{};
+        for (std::size_t i = 0; i < 6; ++i) {
+            auto const & next = offsets[(i + 1) % 6];
+            sectors[i] = fov_sector{offsets[i], {next[0] - offsets[i][0],
+                                                 next[1] - offsets[i][1]}};
+        }
+        return sectors;
+    }
+    else {
+        constexpr auto const & offsets =
+            direction_table<cardinal::direction_name>::offsets;
+        std::array<fov_sector, 4> sectors{};
+        for (std::size_t i = 0; i < 4; ++i) {
+            sectors[i] = fov_sector{offsets[i], offsets[(i + 1) % 4]};
+        }
+        return sectors;
+    }
+}
+
+/** An exact slope across a sector, as a fraction with a positive
+ * denominator. */
+struct fov_slope {
+    std::int64_t numerator;
+    std::int64_t denominator;
+};
+
+inline std::int64_t floor_divide(std::int64_t a, std::int64_t b)
+{
+    auto const quotient = a / b;
+    return (a % b != 0 and (a < 0) != (b < 0)) ? quotient - 1 : quotient;
+}
+
+/** Symmetric recursive shadowcasting over one sector, after Albert Ford.
+ *
+ * Each cell of a row covers the slopes from (2 column - 1) / (2 depth) to
+ * (2 column + 1) / (2 depth). Opaque cells are lit when any part of them is in
+ * view, and clear cells only when their center is, so that whenever one clear
+ * cell can see another, the other can see it back. Slopes are kept as exact
+ * fractions so that no cell flickers at the edge of a shadow.
+ */
+class shadowcaster {
+public:
+    shadowcaster(bit_grid const & opaque, bit_grid & visible,
+                 grid_point origin, int radius, bool hex, fov_sector sector)
+        : _opaque{opaque}, _visible{visible}, _origin{origin},
+          _radius{radius}, _hex{hex}, _sector{sector}
+    {
+    }
+
+    void scan(int depth, fov_slope start, fov_slope end) const
+    {
+        if (depth > _radius) { return; }
+        auto const first = static_cast<int>(floor_divide(
+            2 * depth * start.numerator + start.denominator,
+            2 * start.denominator));
+        auto const last = static_cast<int>(-floor_divide(
+            end.denominator - 2 * depth * end.numerator,
+            2 * end.denominator));
+
+        // -1 before the first cell, then whether the last cell was opaque
+        int previous = -1;
+        for (int column = first; column <= last; ++column) {
+            auto const cell = cell_at(depth, column);
+            bool const inside = _opaque.contains(cell);
+            bool const wall = not inside or _opaque.test(cell);
+            if (inside and (wall or centered(depth, column, start, end))) {
+                reveal(cell, depth, column);
+            }
+            fov_slope const edge{2 * column - 1, 2 * depth};
+            if (previous == 1 and not wall) { start = edge; }
+            if (previous == 0 and wall) { scan(depth + 1, start, edge); }
+            previous = wall ? 1 : 0;
+        }
+        if (previous == 0) { scan(depth + 1, start, end); }
+    }
+private:
+    grid_point cell_at(int depth, int column) const
+    {
+        return grid_point{
+            _origin.x + depth * _sector.forward[0] + column * _sector.side[0],
+            _origin.y + depth * _sector.forward[1] + column * _sector.side[1]};
+    }
+
+    static bool centered(int depth, int column, fov_slope start,
+                         fov_slope end)
+    {
+        return column * start.denominator >= depth * start.numerator and
+               column * end.denominator <= depth * end.numerator;
+    }
+
+    void reveal(grid_point cell, int depth, int column) const
+    {
+        // square grids see a circle, and hex grids see every ring in range
+        bool const in_range =
+            _hex or depth * depth + column * column <= _radius * _radius;
+        if (in_range) { _visible.set(cell); }
+    }
+
+    bit_grid const & _opaque;
+    bit_grid & _visible;
+    grid_point _origin;
+    int _radius;
+    bool _hex;
+    fov_sector _sector;
+};
+
+/** Determine if nothing opaque lies strictly between two square cells.
+ *
+ * The line runs between cell centers and passes through a cell when it
+ * crosses the cell's interior, so lines through a corner step diagonally and
+ * the result is the same in either direction.
+ */
+inline bool square_line_of_sight(bit_grid const & opaque,
+                                 grid_point from, grid_point to)
+{
+    std::int64_t const dx = std::abs(to.x - from.x);
+    std::int64_t const dy = std::abs(to.y - from.y);
+    int const step_x = to.x > from.x ? 1 : -1;
+    int const step_y = to.y > from.y ? 1 : -1;
+
+    // error compares when the line next crosses a column and a row
+    auto error = dx - dy;
+    auto remaining = dx + dy;
+    auto cell = from;
+    while (remaining > 0) {
+        if (error > 0) {
+            cell.x += step_x;
+            error -= 2 * dy;
+            remaining -= 1;
+        }
+        else if (error < 0) {
+            cell.y += step_y;
+            error += 2 * dx;
+            remaining -= 1;
+        }
+        else {
+            cell.x += step_x;
+            cell.y += step_y;
+            error += 2 * (dx - dy);
+            remaining -= 2;
+        }
+        bool const blocked = not opaque.contains(cell) or opaque.test(cell);
+        if (remaining > 0 and blocked) { return false; }
+    }
+    return true;
+}
+
+/** Determine if nothing opaque lies strictly between two hexes.
+ *
+ * The hexes along the line are found by rounding evenly spaced points between
+ * the two centers, nudged slightly so that no point lands on an edge.
+ */
+inline bool hex_line_of_sight(bit_grid const & opaque,
+                              grid_point from, grid_point to)
+{
+    struct fractional { double q, r; };
+    auto const steps = hex_distance(from, to);
+    for (int i = 1; i < steps; ++i) {
+        double const t = static_cast<double>(i) / steps;
+        fractional const point{
+            from.x + 1e-6 + (to.x - from.x) * t,
+            from.y + 2e-6 + (to.y - from.y) * t};
+        auto const hex = hex_round<hex_point>(point);
+        grid_point const cell{hex.q, hex.r};
+        if (not opaque.contains(cell) or opaque.test(cell)) { return false; }
+    }
+    return true;
+}
+
+/** Reset a bitmap of visible cells if it isn't the same size as opaque. */
+inline void match_size(bit_grid const & opaque, bit_grid & visible)
+{
+    if (visible.width() != opaque.width() or
+        visible.height() != opaque.height()) {
+        visible = bit_grid(opaque.width(), opaque.height());
+    }
+}
+}
+
+/** Mark every cell visible from a viewpoint.
+ *
+ * Light is cast with symmetric recursive shadowcasting, sector by sector,
+ * reading opaque cells from a packed bitmap. Square grids see every cell
+ * within a circle of the given radius, and hex grids every hex within radius
+ * steps. Opaque cells are visible themselves, and cells off the bitmap are
+ * treated as opaque.
+ *
+ * Cells are only ever set, so the fields of view of several viewpoints can be
+ * gathered into the same bitmap. Hex grids are indexed by axial (q, r).
+ *
+ * Parameters
+ *   opaque - the cells that block sight
+ *   origin - the cell to look out from
+ *   radius - how far the viewpoint can see
+ *   visible - where to mark visible cells, which is cleared and resized to
+ *             match opaque if its size differs
+ */
+template<sight_direction Enum>
+void field_of_view(bit_grid const & opaque, grid_point origin, int radius,
+                   bit_grid & visible)
+{
+    detail::match_size(opaque, visible);
+    if (not opaque.contains(origin) or radius < 0) { return; }
+    visible.set(origin);
+    constexpr auto sectors = detail::fov_sectors<Enum>();
+    // square quadrants cover slopes -1 to 1, and hex sextants 0 to 1
+    constexpr bool hex = hex_layout<Enum>;
+    detail::fov_slope const start{hex ? 0 : -1, 1};
+    detail::fov_slope const end{1, 1};
+    for (auto const & sector : sectors) {
+        detail::shadowcaster const caster{opaque, visible, origin, radius,
+                                          hex, sector};
+        caster.scan(1, start, end);
+    }
+}
+
+/** Mark every cell visible from any of many viewpoints.
+ *
+ * Viewpoints are split evenly between as many tasks as the execution policy
+ * can run at once. Each task casts light into its own bitmap, and the bitmaps
+ * are then merged word by word into visible, so memory and merging grow with
+ * the parallelism rather than the number of viewpoints. A policy that runs one
+ * task at a time casts straight into visible.
+ *
+ * Parameters
+ *   policy - the execution policy to schedule tasks of viewpoints with
+ *   opaque - the cells that block sight
+ *   viewpoints - the cells to look out from, and how far each can see
+ *   visible - where to mark visible cells, which is cleared and resized to
+ *             match opaque if its size differs
+ */
+template<sight_direction Enum, execution_policy Policy>
+void field_of_view(Policy && policy, bit_grid const & opaque,
+                   std::span<viewpoint const> viewpoints, bit_grid & visible)
+{
+    detail::match_size(opaque, visible);
+    auto const tasks = std::min(viewpoints.size(), concurrency_of(policy));
+    if (tasks <= 1) {
+        for (auto const & eye : viewpoints) {
+            field_of_view<Enum>(opaque, eye.cell, eye.radius, visible);
+        }
+        return;
+    }
+    std::vector<bit_grid> seen(tasks, bit_grid(opaque.width(),
+                                               opaque.height()));
+    for_each_index(policy, tasks, [&](std::size_t task) {
+        auto const first = task * viewpoints.size() / tasks;
+        auto const last = (task + 1) * viewpoints.size() / tasks;
+        for (auto i = first; i < last; ++i) {
+            field_of_view<Enum>(opaque, viewpoints[i].cell,
+                                viewpoints[i].radius, seen[task]);
+        }
+    });
+    for_each_index(std::forward<Policy>(policy), visible.height(),
+                   [&](std::size_t y) {
+        auto const words = visible.row(y);
+        for (auto const & part : seen) {
+            auto const from = part.row(y);
+            for (std::size_t i = 0; i < words.size(); ++i) {
+                words[i] |= from[i];
+            }
+        }
+    });
+}
+
+template<sight_direction Enum>
+void field_of_view(bit_grid const & opaque,
+                   std::span<viewpoint const> viewpoints, bit_grid & visible)
+{
+    field_of_view<Enum>(std::execution::seq, opaque, viewpoints, visible);
+}
+
+/** Determine if nothing opaque lies between two cells.
+ *
+ * The cells at either end may be opaque themselves, so a wall can be seen.
+ * Cells off the bitmap block sight. Hex grids are indexed by axial (q, r).
+ */
+template<sight_direction Enum>
+bool line_of_sight(bit_grid const & opaque, grid_point from, grid_point to)
+{
+    if constexpr (hex_layout<Enum>) {
+        return detail::hex_line_of_sight(opaque, from, to);
+    }
+    else {
+        return detail::square_line_of_sight(opaque, from, to);
+    }
+}
+
+/** Check many lines of sight at once.
+ *
+ * Results are written as a bitset: bit i % 64 of word i / 64 is set when line
+ * i is clear, and cleared otherwise. Each word is filled by a single task, so
+ * lines are scheduled 64 at a time under the execution policy.
+ *
+ * Parameters
+ *   policy - the execution policy to schedule lines with
+ *   opaque - the cells that block sight
+ *   lines - the pairs of cells to check
+ *   clear - where to write results, at least (lines.size() + 63) / 64 words
+ */
+template<sight_direction Enum, execution_policy Policy>
+void line_of_sight(Policy && policy, bit_grid const & opaque,
+                   std::span<sight_line const> lines,
+                   std::span<bit_grid::word_type> clear)
+{
+    constexpr std::size_t word_bits = bit_grid::word_bits;
+    auto const words = (lines.size() + word_bits - 1) / word_bits;
+    for_each_index(std::forward<Policy>(policy), words, [&](std::size_t w) {
+        bit_grid::word_type word = 0;
+        auto const last = std::min(lines.size(), (w + 1) * word_bits);
+        for (auto i = w * word_bits; i < last; ++i) {
+            bool const seen =
+                line_of_sight<Enum>(opaque, lines[i].from, lines[i].to);
+            word |= bit_grid::word_type{seen} << (i % word_bits);
+        }
+        clear[w] = word;
+    });
+}
+
+template<sight_direction Enum>
+void line_of_sight(bit_grid const & opaque, std::span<sight_line const> lines,
+                   std::span<bit_grid::word_type> clear)
+{
+    line_of_sight<Enum>(std::execution::seq, opaque, lines, clear);
+}
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include "spatula/grids.hpp"
+
+/** Fixtures shared by the grid tests. */
+namespace test_grids {
+/** A rectangle laid out like SDL_Rect. */
+struct rect { int x, y, w, h; };
+
+/** Advance a linear congruential generator, returning its new state. */
+inline std::uint32_t next_state(std::uint32_t & state)
+{
+    state = state * 1664525u + 1013904223u;
+    return state;
+}
+
+/** A pseudo-random integer in [0, size). */
+inline int next_random(std::uint32_t & seed, int size)
+{
+    return static_cast<int>((next_state(seed) >> 8) %
+                            static_cast<std::uint32_t>(size));
+}
+
+/** A grid whose cells are generated, in order, from successive states of a
+ * generator started at seed. */
+template<class T, class Generate>
+sp::grid<T> seeded_grid(std::size_t width, std::size_t height,
+                        std::uint32_t seed, Generate generate)
+{
+    sp::grid<T> cells(width, height);
+    for (auto & cell : cells) { cell = generate(next_state(seed)); }
+    return cells;
+}
+
+/** Visit every cell of a region that lies on the grid, row by row. */
+template<class T, class Visit>
+void for_each_cell_in(sp::grid<T> const & cells, rect region, Visit visit)
+{
+    for (int y = region.y; y < region.y + region.h; ++y) {
+        for (int x = region.x; x < region.x + region.w; ++x) {
+            if (cells.contains(x, y)) { visit(cells(x, y)); }
+        }
+    }
+}
+}
@@ -0,0 +1,142 @@
+#include <catch2/catch.hpp>
+#include "spatula/automata.hpp"
+#include "grid_fixtures.hpp"
+
+#include <cstdint>
+#include <execution>
+
+using namespace sp;
+using namespace test_grids;
+
+namespace test_automata {
+using cardinal_direction = cardinal::direction_name;
+using octile_direction = octile::direction_name;
+using pointed_hex_direction = pointed_hex::direction_name;
+
+/** A random grid of live cells. */
+grid<std::uint8_t> scattered(std::size_t width, std::size_t height)
+{
+    return seeded_grid<std::uint8_t>(width, height, 4242,
+                                     [](std::uint32_t state) {
+        return (state >> 28) < 6 ? 1 : 0;
+    });
+}
+
+/** Advance an automaton one cell at a time. */
+template<ranged_enum Enum>
+grid<std::uint8_t> slow_step(grid<std::uint8_t> const & cells,
+                             life_rule const & rule, bool outside)
+{
+    grid<std::uint8_t> next(cells.width(), cells.height(), 0);
+    for (int y = 0; y < static_cast<int>(cells.height()); ++y) {
+        for (int x = 0; x < static_cast<int>(cells.width()); ++x) {
+            unsigned count = 0;
+            for (std::size_t i = 0; i < enum_size_v<Enum>; ++i) {
+                auto const step =
+                    direction_as<grid_point>(static_cast<Enum>(i));
+                grid_point const neighbour{x + step.x, y + step.y};
+                count += cells.contains(neighbour) ? cells[neighbour] != 0
+                                                   : outside;
+            }
+            auto const rules = cells(x, y) ? rule.survive : rule.birth;
+            next(x, y) = (rules >> count) & 1u;
+        }
+    }
+    return next;
+}
+
+template<adjacent_direction Enum>
+void check_against_slow_step(life_rule const & rule, bool outside)
+{
+    using size = std::pair<std::size_t, std::size_t>;
+    for (auto const & [width, height] : {size{130, 70}, size{64, 3},
+                                         size{1, 1}, size{200, 140},
+                                         size{1100, 4}}) {
+        auto expected = scattered(width, height);
+        bit_grid cells(expected);
+        step_automaton<Enum>(std::execution::par, cells, rule, 3, outside);
+        for (int generation = 0; generation < 3; ++generation) {
+            expected = slow_step<Enum>(expected, rule, outside);
+        }
+        REQUIRE(cells == bit_grid(expected));
+    }
+}
+}
+using namespace test_automata;
+
+TEST_CASE("bit grids pack cells into words", "[bit_grid]")
+{
+    grid<std::uint8_t> cells(70, 2, 0);
+    cells(0, 0) = 1;
+    cells(65, 1) = 3;
+    bit_grid const bits(cells);
+    REQUIRE(bits.words_per_row() == 2);
+    REQUIRE(bits.test(0, 0));
+    REQUIRE(bits.test(grid_point{65, 1}));
+    REQUIRE_FALSE(bits.test(1, 0));
+    REQUIRE(bits.row(1)[1] == 2u);
+    REQUIRE(bits.count() == 2);
+
+    bit_grid full(70, 2, true);
+    REQUIRE(full.count() == 140);
+    full.reset(69, 1);
+    REQUIRE(full.count() == 139);
+    REQUIRE(full.row(0).back() == full.last_word_mask());
+}
+
+TEST_CASE("life rules are read from B/S notation", "[automata]")
+{
+    constexpr auto life = life_like_rule("B3/S23");
+    STATIC_REQUIRE(life.birth == 0b1000);
+    STATIC_REQUIRE(life.survive == 0b1100);
+    STATIC_REQUIRE(life_like_rule("b36/s23") ==
+                   life_rule{0b1001000, 0b1100});
+    // alive when 5 or more of the 9 cells are alive, like a majority vote
+    STATIC_REQUIRE(totalistic_rule(0b1111100000) ==
+                   life_rule{0b111100000, 0b111110000});
+}
+
+TEST_CASE("a blinker oscillates in the game of life", "[automata]")
+{
+    bit_grid cells(5, 5);
+    cells.set(1, 2);
+    cells.set(2, 2);
+    cells.set(3, 2);
+    auto const start = cells;
+    auto const life = life_like_rule("B3/S23");
+
+    step_automaton<octile_direction>(cells, life);
+    REQUIRE(cells.count() == 3);
+    REQUIRE(cells.test(2, 1));
+    REQUIRE(cells.test(2, 2));
+    REQUIRE(cells.test(2, 3));
+
+    step_automaton<octile_direction>(cells, life);
+    REQUIRE(cells == start);
+}
+
+TEST_CASE("automata match a cell by cell step", "[automata]")
+{
+    SECTION("the game of life") {
+        check_against_slow_step<octile_direction>(
+            life_like_rule("B3/S23"), false);
+    }
+    SECTION("cave generation with a solid border") {
+        check_against_slow_step<octile_direction>(
+            life_like_rule("B5678/S45678"), true);
+    }
+    SECTION("fire spread across cardinal neighbours") {
+        check_against_slow_step<cardinal_direction>(
+            life_like_rule("B1234/S"), false);
+    }
+    SECTION("hex life") {
+        check_against_slow_step<pointed_hex_direction>(
+            life_like_rule("B2/S34"), false);
+        check_against_slow_step<pointed_hex_direction>(
+            totalistic_rule(0b1110000), true);
+    }
+    SECTION("rules that fire on zero neighbours") {
+        check_against_slow_step<octile_direction>(
+            life_like_rule("B0/S8"), false);
+    }
+}
@@ -0,0 +1,100 @@
+#include <catch2/catch.hpp>
+#include "spatula/autotiling.hpp"
+#include "grid_fixtures.hpp"
+
+#include <cstdint>
+#include <execution>
+
+using namespace sp;
+using namespace test_grids;
+
+namespace test_autotiling {
+using cardinal_direction = cardinal::direction_name;
+using octile_direction = octile::direction_name;
+using pointed_hex_direction = pointed_hex::direction_name;
+
+/** A random occupancy grid. */
+grid<std::uint8_t> scattered(std::size_t width, std::size_t height)
+{
+    return seeded_grid<std::uint8_t>(width, height, 777,
+                                     [](std::uint32_t state) {
+        return (state >> 28) < 7 ? 1 : 0;
+    });
+}
+
+/** Find a neighbour mask one cell at a time. */
+template<ranged_enum Enum>
+direction_set<Enum> slow_mask(grid<std::uint8_t> const & cells,
+                              int x, int y, bool outside)
+{
+    direction_set<Enum> mask;
+    for (std::size_t i = 0; i < enum_size_v<Enum>; ++i) {
+        auto const dir = static_cast<Enum>(i);
+        auto const step = direction_as<grid_point>(dir);
+        grid_point const next{x + step.x, y + step.y};
+        bool const occupied = cells.contains(next) ? cells[next] != 0
+                                                   : outside;
+        if (occupied) { mask.insert(dir); }
+    }
+    return mask;
+}
+
+template<ranged_enum Enum>
+void check_masks(grid<std::uint8_t> const & cells, bool outside)
+{
+    auto const masks =
+        neighbour_masks<Enum>(std::execution::par, cells, outside);
+    for (int y = 0; y < static_cast<int>(cells.height()); ++y) {
+        for (int x = 0; x < static_cast<int>(cells.width()); ++x) {
+            REQUIRE(masks(x, y) == slow_mask<Enum>(cells, x, y, outside));
+        }
+    }
+}
+}
+using namespace test_autotiling;
+
+TEST_CASE("neighbour_masks", "[autotiling]") {
+    auto const cells = scattered(37, 150);
+    check_masks<cardinal_direction>(cells, false);
+    check_masks<octile_direction>(cells, true);
+    check_masks<pointed_hex_direction>(cells, false);
+    check_masks<flat_hex::direction_name>(cells, true);
+
+    grid<std::uint8_t> single(1, 1, 1);
+    REQUIRE(neighbour_masks<cardinal_direction>(single)(0, 0).empty());
+    REQUIRE(neighbour_masks<cardinal_direction>(single, true)(0, 0) ==
+            direction_set<cardinal_direction>::all());
+}
+
+TEST_CASE("blob_tile_table", "[autotiling]") {
+    STATIC_REQUIRE(blob_tile_masks.back() == 0xff);
+    STATIC_REQUIRE(blob_tile_table[0] == 0);
+    STATIC_REQUIRE(blob_tile_table[0xff] == 46);
+
+    // every tile index is used, and each reduced mask maps to itself
+    for (std::size_t i = 0; i < blob_tile_masks.size(); ++i) {
+        REQUIRE(blob_tile_table[blob_tile_masks[i]] == i);
+        if (i > 0) { REQUIRE(blob_tile_masks[i - 1] < blob_tile_masks[i]); }
+    }
+
+    // a lone diagonal neighbour doesn't change the tile
+    direction_set<octile_direction> const corner{octile::northeast};
+    REQUIRE(blob_tile(corner) == 0);
+    direction_set<octile_direction> const filled{
+        octile::north, octile::east, octile::northeast};
+    direction_set<octile_direction> const open{octile::north, octile::east};
+    REQUIRE(blob_tile(filled) != blob_tile(open));
+}
+
+TEST_CASE("map_tiles", "[autotiling]") {
+    auto const cells = scattered(64, 64);
+    auto const masks =
+        neighbour_masks<octile_direction>(std::execution::par, cells);
+    auto const tiles =
+        map_tiles(std::execution::par_unseq, masks, blob_tile_table);
+    REQUIRE(tiles.width() == 64);
+    for (std::size_t i = 0; i < tiles.size(); ++i) {
+        REQUIRE(tiles[i] == blob_tile(masks[i]));
+        REQUIRE(tiles[i] < 47);
+    }
+}
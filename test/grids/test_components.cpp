@@ -0,0 +1,135 @@
+#include <catch2/catch.hpp>
+#include "spatula/components.hpp"
+#include "grid_fixtures.hpp"
+
+#include <cstdint>
+#include <vector>
+#include <execution>
+
+using namespace sp;
+using namespace test_grids;
+
+namespace test_components {
+using cardinal_direction = cardinal::direction_name;
+using octile_direction = octile::direction_name;
+using pointed_hex_direction = pointed_hex::direction_name;
+
+/** A map of a few kinds of terrain, clumped together into regions. */
+grid<std::uint8_t> patchy_terrain(std::size_t width, std::size_t height,
+                                  std::uint32_t seed, std::uint32_t kinds)
+{
+    return seeded_grid<std::uint8_t>(width, height, seed,
+                                     [=](std::uint32_t state) {
+        return static_cast<std::uint8_t>((state >> 16) % kinds);
+    });
+}
+
+/** Label regions one at a time by searching outwards from each cell. */
+template<adjacent_direction Enum>
+grid_components search_every_region(grid<std::uint8_t> const & cells)
+{
+    constexpr std::uint32_t unlabelled = ~std::uint32_t{0};
+    grid_components components{
+        grid<std::uint32_t>(cells.width(), cells.height(), unlabelled), 0};
+    std::vector<grid_point> open;
+    for (std::size_t i = 0; i < cells.size(); ++i) {
+        if (components.labels[i] != unlabelled) { continue; }
+        auto const label = static_cast<std::uint32_t>(components.count++);
+        components.labels[i] = label;
+        open.push_back(cells.point_of(i));
+        while (not open.empty()) {
+            auto const cell = open.back();
+            open.pop_back();
+            for (auto const & offset : direction_table<Enum>::offsets) {
+                grid_point const next{cell.x + offset[0], cell.y + offset[1]};
+                if (not cells.contains(next) or
+                    components.labels[next] != unlabelled or
+                    cells[next] != cells[cell]) {
+                    continue;
+                }
+                components.labels[next] = label;
+                open.push_back(next);
+            }
+        }
+    }
+    return components;
+}
+
+template<region_direction Enum>
+void require_same_regions(grid<std::uint8_t> const & cells)
+{
+    auto const expected = search_every_region<Enum>(cells);
+    auto const found = label_components<Enum>(std::execution::par, cells);
+    REQUIRE(found.count == expected.count);
+    REQUIRE(found.labels == expected.labels);
+}
+}
+using namespace test_components;
+
+static_assert(region_direction<cardinal_direction>);
+static_assert(region_direction<flat_hex::direction_name>);
+static_assert(not region_direction<triangular::direction_name>);
+
+TEST_CASE("components are labelled in reading order", "[components]")
+{
+    grid<int> cells(5, 3, 0);
+    cells(1, 0) = 1;
+    cells(2, 1) = 1;
+    cells(4, 2) = 2;
+    auto const cardinal = label_components<cardinal_direction>(cells);
+    REQUIRE(cardinal.count == 4);
+    REQUIRE(cardinal.labels(1, 0) == 1);
+    REQUIRE(cardinal.labels(2, 0) == 0);
+    REQUIRE(cardinal.labels(2, 1) == 2);
+    REQUIRE(cardinal.labels(4, 2) == 3);
+    REQUIRE(cardinal.labels(0, 2) == 0);
+    auto const octile = label_components<octile_direction>(cells);
+    REQUIRE(octile.count == 3);
+    REQUIRE(octile.labels(2, 1) == 1);
+    REQUIRE(octile.labels(2, 0) == 0);
+}
+
+TEST_CASE("components match a search from every cell", "[components]")
+{
+    for (std::uint32_t seed = 1; seed <= 3; ++seed) {
+        auto const cells = patchy_terrain(57, 150, seed, 2 + seed);
+        require_same_regions<cardinal_direction>(cells);
+        require_same_regions<octile_direction>(cells);
+        require_same_regions<pointed_hex_direction>(cells);
+        require_same_regions<flat_hex::direction_name>(cells);
+    }
+    REQUIRE(label_components<cardinal_direction>(grid<int>{}).count == 0);
+}
+
+TEST_CASE("flood fills cover the region of the seed", "[components]")
+{
+    auto cells = patchy_terrain(80, 70, 5, 2);
+    auto const regions = search_every_region<octile_direction>(cells);
+    grid_point const seed{40, 35};
+    auto const label = regions.labels[seed];
+    std::size_t expected = 0;
+    for (auto const cell : regions.labels) { expected += cell == label; }
+
+    auto const before = cells;
+    REQUIRE(flood_fill<octile_direction>(cells, seed, 7) == expected);
+    for (std::size_t i = 0; i < cells.size(); ++i) {
+        bool const inside = regions.labels[i] == label;
+        REQUIRE(cells[i] == (inside ? 7 : before[i]));
+    }
+    REQUIRE(flood_fill<octile_direction>(cells, seed, 7) == 0);
+    REQUIRE(flood_fill<octile_direction>(cells, grid_point{-1, 0}, 3) == 0);
+}
+
+TEST_CASE("flood fills don't recurse", "[components]")
+{
+    // a single winding corridor through every other row
+    grid<std::uint8_t> cells(400, 399, 1);
+    for (int y = 0; y < 399; y += 2) {
+        for (int x = 0; x < 400; ++x) { cells(x, y) = 0; }
+        if (y + 1 < 399) { cells(y % 4 == 0 ? 399 : 0, y + 1) = 0; }
+    }
+    REQUIRE(flood_fill<cardinal_direction>(cells, grid_point{0, 0}, 2) ==
+            200 * 400 + 199);
+    auto const regions = label_components<pointed_hex_direction>(cells);
+    REQUIRE(regions.labels(5, 398) == regions.labels(0, 0));
+}
@@ -0,0 +1,203 @@
+#include <catch2/catch.hpp>
+#include "spatula/contours.hpp"
+#include "grid_fixtures.hpp"
+
+#include <cstdint>
+#include <cmath>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+#include <execution>
+
+using namespace sp;
+using namespace test_grids;
+
+namespace test_contours {
+struct point { float x, y; };
+struct position { double x, y, z; };
+
+/** Samples of a ball of radius r, solid inside, in a cube of n samples. */
+std::vector<float> ball(std::size_t n, double r)
+{
+    std::vector<float> samples(n * n * n);
+    auto const c = static_cast<double>(n - 1) / 2.0;
+    for (std::size_t z = 0; z < n; ++z) {
+        for (std::size_t y = 0; y < n; ++y) {
+            for (std::size_t x = 0; x < n; ++x) {
+                samples[(z * n + y) * n + x] = static_cast<float>(
+                    r - std::hypot(x - c, y - c, z - c));
+            }
+        }
+    }
+    return samples;
+}
+
+/** Random even samples in a cube of n samples, 0 along every face. */
+std::vector<int> noise(std::size_t n, std::uint32_t seed)
+{
+    std::vector<int> samples(n * n * n, 0);
+    for (std::size_t z = 1; z + 1 < n; ++z) {
+        for (std::size_t y = 1; y + 1 < n; ++y) {
+            for (std::size_t x = 1; x + 1 < n; ++x) {
+                samples[(z * n + y) * n + x] =
+                    static_cast<int>(next_state(seed) >> 28) * 2;
+            }
+        }
+    }
+    return samples;
+}
+
+/** Determine if every edge of every triangle is met as often running the
+ * other way, so the surface has no boundary. */
+bool is_closed(std::vector<std::array<std::uint32_t, 3>> const & triangles)
+{
+    std::map<std::pair<std::uint32_t, std::uint32_t>, int> edges;
+    for (auto const & t : triangles) {
+        for (std::size_t i = 0; i < 3; ++i) {
+            ++edges[{t[i], t[(i + 1) % 3]}];
+        }
+    }
+    for (auto const & [edge, count] : edges) {
+        auto const back = edges.find({edge.second, edge.first});
+        if (back == edges.end() or back->second != count) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<class Vector>
+std::size_t distinct_positions(std::vector<Vector> const & vertices)
+{
+    std::set<std::array<double, 3>> positions;
+    for (auto const & v : vertices) {
+        if constexpr (requires { v.z; }) {
+            positions.insert({double(v.x), double(v.y), double(v.z)});
+        }
+        else {
+            positions.insert({double(v.x), double(v.y), 0.0});
+        }
+    }
+    return positions.size();
+}
+}
+using namespace test_contours;
+
+static_assert(isoline_vertex<point>);
+static_assert(not isoline_vertex<grid_point>);
+static_assert(isosurface_vertex<position>);
+
+TEST_CASE("isolines trace closed loops around solid regions", "[contours]")
+{
+    // a disk spanning two bands of rows
+    grid<double> samples(48, 70);
+    for (std::size_t y = 0; y < samples.height(); ++y) {
+        for (std::size_t x = 0; x < samples.width(); ++x) {
+            samples(static_cast<int>(x), static_cast<int>(y)) =
+                19.6 - std::hypot(x - 24.0, y - 33.0);
+        }
+    }
+    auto const lines = isolines<point>(std::execution::par, samples, 0.0);
+    REQUIRE(not lines.segments.empty());
+    REQUIRE(distinct_positions(lines.vertices) == lines.vertices.size());
+
+    std::vector<int> starts(lines.vertices.size(), 0);
+    std::vector<int> ends(lines.vertices.size(), 0);
+    double area = 0.0;
+    for (auto const [a, b] : lines.segments) {
+        ++starts[a];
+        ++ends[b];
+        auto const & p = lines.vertices[a];
+        auto const & q = lines.vertices[b];
+        area += double(p.x) * q.y - double(q.x) * p.y;
+    }
+    for (std::size_t i = 0; i < lines.vertices.size(); ++i) {
+        REQUIRE(starts[i] == 1);
+        REQUIRE(ends[i] == 1);
+        auto const & v = lines.vertices[i];
+        REQUIRE(std::hypot(v.x - 24.0, v.y - 33.0) ==
+                Approx(19.6).margin(0.05));
+    }
+    // the solid disk lies to the left, so the loop runs counter-clockwise
+    REQUIRE(area / 2.0 == Approx(3.14159 * 19.6 * 19.6).epsilon(0.01));
+
+    auto const serial = isolines<point>(samples, 0.0);
+    REQUIRE(serial.segments == lines.segments);
+}
+
+TEST_CASE("isolines keep diagonal solid corners apart", "[contours]")
+{
+    grid<int> samples(2, 2, 0);
+    samples(0, 0) = 2;
+    samples(1, 1) = 2;
+    auto const lines = isolines<point>(samples, 1);
+    REQUIRE(lines.vertices.size() == 4);
+    REQUIRE(lines.segments.size() == 2);
+    for (auto const [a, b] : lines.segments) {
+        auto const & p = lines.vertices[a];
+        auto const & q = lines.vertices[b];
+        // each segment cuts off a single corner
+        REQUIRE(std::abs(p.x - q.x) == Approx(0.5f));
+        REQUIRE(std::abs(p.y - q.y) == Approx(0.5f));
+    }
+    REQUIRE(isolines<point>(grid<int>(1, 5, 1), 1).vertices.empty());
+}
+
+TEST_CASE("isosurfaces of a ball face outwards", "[contours]")
+{
+    auto const samples = ball(21, 7.5);
+    auto const mesh = isosurface<position>(std::execution::par, samples,
+                                           voxel_point{21, 21, 21}, 0.0f);
+    REQUIRE(not mesh.triangles.empty());
+    REQUIRE(is_closed(mesh.triangles));
+    REQUIRE(distinct_positions(mesh.vertices) == mesh.vertices.size());
+    for (auto const & v : mesh.vertices) {
+        REQUIRE(std::hypot(v.x - 10.0, v.y - 10.0, v.z - 10.0) ==
+                Approx(7.5).margin(0.05));
+    }
+    for (auto const & [a, b, c] : mesh.triangles) {
+        auto const & p = mesh.vertices[a];
+        auto const & q = mesh.vertices[b];
+        auto const & r = mesh.vertices[c];
+        std::array<double, 3> const u{q.x - p.x, q.y - p.y, q.z - p.z};
+        std::array<double, 3> const w{r.x - p.x, r.y - p.y, r.z - p.z};
+        std::array<double, 3> const normal{u[1] * w[2] - u[2] * w[1],
+                                           u[2] * w[0] - u[0] * w[2],
+                                           u[0] * w[1] - u[1] * w[0]};
+        auto const outwards = normal[0] * (p.x - 10.0) +
+                              normal[1] * (p.y - 10.0) +
+                              normal[2] * (p.z - 10.0);
+        REQUIRE(outwards > 0.0);
+    }
+
+    auto const serial = isosurface<position>(samples,
+                                             voxel_point{21, 21, 21}, 0.0f);
+    REQUIRE(serial.triangles == mesh.triangles);
+}
+
+TEST_CASE("isosurfaces of noise have no cracks", "[contours]")
+{
+    for (std::uint32_t seed = 1; seed <= 4; ++seed) {
+        auto const samples = noise(14, seed);
+        auto const mesh = isosurface<position>(
+            std::execution::par, samples, voxel_point{14, 14, 14}, 15);
+        REQUIRE(not mesh.triangles.empty());
+        REQUIRE(is_closed(mesh.triangles));
+        REQUIRE(distinct_positions(mesh.vertices) == mesh.vertices.size());
+    }
+    std::vector<float> const flat(16, 1.0f);
+    REQUIRE(isosurface<position>(flat, voxel_point{4, 4, 1}, 0.5f)
+                .triangles.empty());
+}
+
+TEST_CASE("isosurfaces ignore extents past the samples", "[contours]")
+{
+    auto const samples = ball(8, 3.0);
+    auto const mesh = isosurface<position>(std::execution::par, samples,
+                                           voxel_point{8, 8, 9}, 0.0f);
+    REQUIRE(mesh.vertices.empty());
+    REQUIRE(mesh.triangles.empty());
+    REQUIRE(isosurface<position>(samples, voxel_point{16, 16, 16}, 0.0f)
+                .triangles.empty());
+}
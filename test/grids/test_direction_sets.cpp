@@ -0,0 +1,95 @@
+#include <catch2/catch.hpp>
+#include "spatula/direction_sets.hpp"
+#include "spatula/grids.hpp"
+
+#include <vector>
+#include <ranges>
+
+using namespace sp;
+
+namespace test_direction_sets {
+using cardinal_set = direction_set<cardinal::direction_name>;
+using octile_set = direction_set<octile::direction_name>;
+using pointed_hex_set = direction_set<pointed_hex::direction_name>;
+using voxel26_set = direction_set<voxel26::direction_name>;
+
+/** Rotate and reverse every direction one at a time, to check the fast paths
+ * against the tables. */
+template<tabled_direction Enum>
+void check_against_tables(direction_set<Enum> set)
+{
+    for (int turns = -3; turns <= 9; ++turns) {
+        direction_set<Enum> expected;
+        for (Enum const direction : set) {
+            expected.insert(rotate_direction(direction, turns));
+        }
+        REQUIRE(set.rotated(turns) == expected);
+    }
+    direction_set<Enum> expected;
+    for (Enum const direction : set) {
+        expected.insert(opposite_direction(direction));
+    }
+    REQUIRE(set.opposite() == expected);
+}
+}
+using namespace test_direction_sets;
+
+TEST_CASE("direction_set:storage", "[directions][direction_set]") {
+    STATIC_REQUIRE(sizeof(cardinal_set) == 1);
+    STATIC_REQUIRE(sizeof(octile_set) == 1);
+    STATIC_REQUIRE(sizeof(pointed_hex_set) == 1);
+    STATIC_REQUIRE(sizeof(direction_set<voxel18::direction_name>) == 4);
+    STATIC_REQUIRE(std::is_trivially_copyable_v<octile_set>);
+    STATIC_REQUIRE(std::forward_iterator<octile_set::iterator>);
+    STATIC_REQUIRE(cardinal_set::all().bits() == 0b1111);
+
+    grid<cardinal_set> walls(16, 16);
+    REQUIRE(walls.size() * sizeof(cardinal_set) == 256);
+}
+
+TEST_CASE("direction_set:operations", "[directions][direction_set]") {
+    octile_set set{octile::north, octile::east, octile::southwest};
+    REQUIRE(set.size() == 3);
+    REQUIRE(set.contains(octile::east));
+    REQUIRE(not set.contains(octile::west));
+
+    set.insert(octile::west);
+    set.erase(octile::north);
+    std::vector<octile::direction_name> members(set.begin(), set.end());
+    REQUIRE(members == std::vector{octile::east, octile::southwest,
+                                   octile::west});
+
+    octile_set const other{octile::east, octile::north};
+    REQUIRE((set & other) == octile_set{octile::east});
+    REQUIRE((set | other).size() == 4);
+    REQUIRE((set ^ other) ==
+            octile_set{octile::north, octile::southwest, octile::west});
+    REQUIRE((~set).size() == 5);
+    REQUIRE((~octile_set::all()).empty());
+    REQUIRE(octile_set::from_bits(0xff) == octile_set::all());
+    REQUIRE(cardinal_set::from_bits(0xff) == cardinal_set::all());
+}
+
+TEST_CASE("direction_set:rotate and opposite", "[directions][direction_set]") {
+    cardinal_set const corner{cardinal::north, cardinal::east};
+    REQUIRE(corner.rotated(1) == cardinal_set{cardinal::east, cardinal::south});
+    REQUIRE(corner.rotated(-1) ==
+            cardinal_set{cardinal::west, cardinal::north});
+    REQUIRE(corner.opposite() ==
+            cardinal_set{cardinal::south, cardinal::west});
+
+    check_against_tables(corner);
+    check_against_tables(octile_set{octile::north, octile::southeast,
+                                    octile::west});
+    check_against_tables(pointed_hex_set{pointed_hex::east,
+                                         pointed_hex::southwest});
+    check_against_tables(direction_set<flat_hex::direction_name>{
+        flat_hex::north, flat_hex::southeast});
+    check_against_tables(direction_set<triangular::direction_name>{
+        triangular::north, triangular::northwest});
+    check_against_tables(voxel26_set{voxel26::up, voxel26::northeast,
+                                     voxel26::down_southwest,
+                                     voxel26::up_northwest});
+    check_against_tables(direction_set<voxel6::direction_name>{
+        voxel6::east, voxel6::down});
+}
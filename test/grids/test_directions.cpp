@@ -0,0 +1,104 @@
+#include <catch2/catch.hpp>
+#include "spatula/directions.hpp"
+
+#include <array>
+#include <cstddef>
+
+using namespace sp;
+
+namespace test_directions {
+struct point2i {
+    int x, y;
+    friend constexpr bool operator==(point2i const &,
+                                     point2i const &) = default;
+};
+struct point3i {
+    int x, y, z;
+    friend constexpr bool operator==(point3i const &,
+                                     point3i const &) = default;
+};
+
+/** Check that opposite directions negate each other, and that a full circle of
+ * clockwise turns comes back around. */
+template<tabled_direction Enum>
+void check_table()
+{
+    using table = direction_table<Enum>;
+    constexpr auto N = enum_size_v<Enum>;
+    constexpr auto D = table::dimensions;
+    STATIC_REQUIRE(table::offsets.size() == N);
+
+    for (std::size_t i = 0; i < N; ++i) {
+        auto const dir = static_cast<Enum>(i);
+        auto const back = opposite_direction(dir);
+        REQUIRE(opposite_direction(back) == dir);
+        for (std::size_t c = 0; c < D; ++c) {
+            REQUIRE(table::offsets[back][c] == -table::offsets[dir][c]);
+        }
+        auto const period = static_cast<int>(table::rotation_period);
+        REQUIRE(rotate_direction(dir, period) == dir);
+        REQUIRE(rotate_direction(rotate_direction(dir, 1), -1) == dir);
+        REQUIRE(rotate_direction(dir, 1) == table::clockwise[dir]);
+
+        // every direction is distinct
+        for (std::size_t j = 0; j < i; ++j) {
+            REQUIRE(table::offsets[j] != table::offsets[i]);
+        }
+    }
+}
+}
+using namespace test_directions;
+
+TEST_CASE("direction_table", "[directions]") {
+    check_table<cardinal::direction_name>();
+    check_table<octile::direction_name>();
+    check_table<flat_hex::direction_name>();
+    check_table<pointed_hex::direction_name>();
+    check_table<triangular::direction_name>();
+    check_table<voxel6::direction_name>();
+    check_table<voxel18::direction_name>();
+    check_table<voxel26::direction_name>();
+}
+
+TEST_CASE("direction_table:constexpr", "[directions]") {
+    STATIC_REQUIRE(opposite_direction(octile::northeast) == octile::southwest);
+    STATIC_REQUIRE(rotate_direction(octile::north, 2) == octile::east);
+    STATIC_REQUIRE(rotate_direction(cardinal::north, -1) == cardinal::west);
+    STATIC_REQUIRE(rotate_direction(voxel26::up_north, 1) == voxel26::up_east);
+    STATIC_REQUIRE(rotate_direction(voxel6::up, 3) == voxel6::up);
+    STATIC_REQUIRE(opposite_direction(triangular::north) == triangular::south);
+    STATIC_REQUIRE(enum_to_vector<octile::direction_name, point2i>{}(
+                       octile::southeast) == point2i{1, -1});
+}
+
+TEST_CASE("direction_as:new direction sets", "[directions]") {
+    REQUIRE(direction_as<point2i>(octile::northwest) == point2i{-1, 1});
+    REQUIRE(direction_as<point3i>(voxel6::down) == point3i{0, 0, -1});
+    REQUIRE(direction_as<point3i>(voxel26::down_northeast) ==
+            point3i{1, 1, -1});
+    REQUIRE(direction_as<point3i>(triangular::southwest) == point3i{0, 0, 1});
+
+    // voxel neighbourhoods nest inside each other
+    auto const faces = directions_as<point3i, voxel6::direction_name>();
+    auto const edges = directions_as<point3i, voxel18::direction_name>();
+    auto const all = directions_as<point3i, voxel26::direction_name>();
+    for (std::size_t i = 0; i < faces.size(); ++i) {
+        REQUIRE(faces[i] == all[i]);
+    }
+    for (std::size_t i = 0; i < edges.size(); ++i) {
+        REQUIRE(edges[i] == all[i]);
+    }
+
+    // each neighbourhood holds the offsets at the matching L1 distances
+    for (auto const & v : all) {
+        int const l1 = (v.x < 0 ? -v.x : v.x) + (v.y < 0 ? -v.y : v.y) +
+                       (v.z < 0 ? -v.z : v.z);
+        auto const index = static_cast<std::size_t>(&v - all.data());
+        REQUIRE(l1 == (index < 6 ? 1 : index < 18 ? 2 : 3));
+    }
+}
+
+TEST_CASE("step_distance:octile", "[directions]") {
+    REQUIRE(step_distance<octile::direction_name>{}(3, -7) == 7);
+    REQUIRE(step_distance<octile::direction_name>{}(-4, 2) == 4);
+}
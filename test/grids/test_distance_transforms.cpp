@@ -0,0 +1,116 @@
+#include <catch2/catch.hpp>
+#include "spatula/distance_transforms.hpp"
+#include "grid_fixtures.hpp"
+
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <execution>
+
+using namespace sp;
+using namespace test_grids;
+
+namespace test_distance_transforms {
+/** A map where roughly one cell in every few dozen is occupied. */
+grid<std::uint8_t> scattered_sites(std::size_t width, std::size_t height,
+                                   std::uint32_t seed, std::uint32_t rarity)
+{
+    return seeded_grid<std::uint8_t>(width, height, seed,
+                                     [=](std::uint32_t state) {
+        return (state >> 16) % rarity == 0;
+    });
+}
+
+std::uint32_t squared_distance(grid_point a, grid_point b)
+{
+    auto const dx = a.x - b.x;
+    auto const dy = a.y - b.y;
+    return static_cast<std::uint32_t>(dx * dx + dy * dy);
+}
+
+/** The squared distance transform found by checking every pair of cells. */
+grid<std::uint32_t> measure_every_pair(grid<std::uint8_t> const & occupied)
+{
+    grid<std::uint32_t> distances(occupied.width(), occupied.height(),
+                                  unreachable_distance);
+    for (std::size_t i = 0; i < occupied.size(); ++i) {
+        for (std::size_t j = 0; j < occupied.size(); ++j) {
+            if (occupied[j] == 0) { continue; }
+            distances[i] = std::min(distances[i], squared_distance(
+                occupied.point_of(i), occupied.point_of(j)));
+        }
+    }
+    return distances;
+}
+}
+using namespace test_distance_transforms;
+
+TEST_CASE("distance transforms are exact", "[distance_transforms]")
+{
+    for (std::uint32_t seed = 1; seed <= 6; ++seed) {
+        auto const occupied = scattered_sites(37, 23, seed, 4 + seed * 9);
+        auto const expected = measure_every_pair(occupied);
+        REQUIRE(distance_transform(occupied) == expected);
+        REQUIRE(distance_transform(std::execution::par, occupied) ==
+                expected);
+    }
+    SECTION("from a single site") {
+        grid<int> occupied(9, 7, 0);
+        occupied(2, 5) = 1;
+        auto const distances = distance_transform(occupied);
+        REQUIRE(distances(2, 5) == 0);
+        REQUIRE(distances(8, 0) == 61);
+        REQUIRE(distances(0, 6) == 5);
+    }
+}
+
+TEST_CASE("distance transforms find the nearest site",
+          "[distance_transforms]")
+{
+    auto const occupied = scattered_sites(50, 41, 9, 60);
+    grid<std::size_t> nearest;
+    auto const distances = distance_transform(std::execution::par, occupied,
+                                              nearest);
+    REQUIRE(nearest.width() == 50);
+    REQUIRE(nearest.height() == 41);
+    for (std::size_t i = 0; i < occupied.size(); ++i) {
+        auto const site = nearest[i];
+        REQUIRE(site < occupied.size());
+        REQUIRE(occupied[site] == 1);
+        REQUIRE(squared_distance(occupied.point_of(i),
+                                 occupied.point_of(site)) == distances[i]);
+    }
+}
+
+TEST_CASE("empty maps are unreachable everywhere", "[distance_transforms]")
+{
+    grid<std::uint8_t> const occupied(12, 5, 0);
+    grid<std::size_t> nearest;
+    auto const distances = distance_transform(occupied, nearest);
+    for (std::size_t i = 0; i < occupied.size(); ++i) {
+        REQUIRE(distances[i] == unreachable_distance);
+        REQUIRE(nearest[i] == no_nearest_site);
+    }
+    REQUIRE(distance_transform(grid<std::uint8_t>{}).empty());
+}
+
+TEST_CASE("signed distance fields are negative inside", "[distance_transforms]")
+{
+    grid<std::uint8_t> occupied(20, 20, 0);
+    for (int y = 5; y < 15; ++y) {
+        for (int x = 5; x < 15; ++x) { occupied(x, y) = 1; }
+    }
+    auto const field = signed_distance_field(std::execution::par, occupied);
+    REQUIRE(field(4, 10) == Approx(0.5f));
+    REQUIRE(field(5, 10) == Approx(-0.5f));
+    REQUIRE(field(9, 9) == Approx(-4.5f));
+    REQUIRE(field(0, 10) == Approx(4.5f));
+    REQUIRE(field(2, 2) == Approx(std::sqrt(18.f) - 0.5f));
+    for (std::size_t i = 0; i < field.size(); ++i) {
+        REQUIRE((field[i] < 0.f) == (occupied[i] == 1));
+    }
+
+    auto const solid = signed_distance_field(grid<int>(4, 4, 1));
+    REQUIRE(solid(2, 2) == -std::numeric_limits<float>::infinity());
+}
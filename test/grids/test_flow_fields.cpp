@@ -0,0 +1,179 @@
+#include <catch2/catch.hpp>
+#include "spatula/flow_fields.hpp"
+
+#include <execution>
+#include <vector>
+#include <cstdint>
+
+using namespace sp;
+
+namespace test_flow_fields {
+struct point2i { int x, y; };
+
+/** Follow a flow field from a cell until it reaches a goal. */
+template<ranged_enum Enum>
+std::size_t walk_to_goal(flow_field<Enum> const & field, point2i cell)
+{
+    std::size_t steps = 0;
+    while (field.distance(cell) != 0) {
+        auto const step = direction_as<point2i>(field.direction(cell));
+        cell = point2i{cell.x + step.x, cell.y + step.y};
+        ++steps;
+    }
+    return steps;
+}
+}
+using namespace test_flow_fields;
+using cardinal_direction = cardinal::direction_name;
+using pointed_hex_direction = pointed_hex::direction_name;
+
+TEST_CASE("enum_bits", "[flow_field][packed]") {
+    REQUIRE(enum_bits_v<cardinal_direction> == 2);
+    REQUIRE(enum_bits_v<pointed_hex_direction> == 3);
+}
+
+TEST_CASE("packed_enum_vector", "[flow_field][packed]") {
+    packed_enum_vector<pointed_hex_direction> directions(50, pointed_hex::east);
+    directions.set(21, pointed_hex::northwest);
+    directions.push_back(pointed_hex::west);
+
+    REQUIRE(directions.size() == 51);
+    REQUIRE(directions.words().size() == 3);
+    REQUIRE(directions[20] == pointed_hex::east);
+    REQUIRE(directions[21] == pointed_hex::northwest);
+    REQUIRE(directions[22] == pointed_hex::east);
+    REQUIRE(directions[50] == pointed_hex::west);
+}
+
+TEST_CASE("flow_field:open grid", "[flow_field][cardinal]") {
+    grid<std::uint8_t> const costs(8, 6, 1);
+    std::vector<point2i> const goals{{2, 3}};
+    auto const field = build_flow_field<cardinal_direction>(costs, goals);
+
+    REQUIRE(field.distance(2, 3) == 0);
+    REQUIRE(field.distance(0, 0) == 5);
+    REQUIRE(field.distance(7, 5) == 7);
+    REQUIRE(field.direction(2, 5) == cardinal::south);
+    REQUIRE(field.direction(0, 3) == cardinal::east);
+    REQUIRE(walk_to_goal(field, point2i{7, 0}) == 8);
+}
+
+TEST_CASE("flow_field:walls and weights", "[flow_field][cardinal]") {
+    // a wall along x = 2 with a gap at the top, and a costly cell in the gap
+    grid<std::uint8_t> costs(5, 5, 1);
+    for (int y = 0; y < 3; ++y) { costs(2, y) = impassable_cost<std::uint8_t>; }
+    costs(4, 0) = impassable_cost<std::uint8_t>;
+    costs(3, 3) = 10;
+
+    std::vector<point2i> const goals{{0, 0}};
+    auto const field = build_flow_field<cardinal_direction>(costs, goals);
+
+    REQUIRE(not field.reachable(4, 0));
+    REQUIRE(not field.reachable(2, 1));
+    REQUIRE(field.distance(2, 3) == 5);
+    REQUIRE(field.distance(4, 4) == 8);
+    REQUIRE(field.distance(3, 3) == 15);
+    REQUIRE(field.distance(3, 2) == 11);
+    REQUIRE(field.direction(3, 3) == cardinal::west);
+    REQUIRE(field.direction(4, 3) == cardinal::north);
+    REQUIRE(field.direction(3, 2) == cardinal::east);
+    REQUIRE(walk_to_goal(field, point2i{3, 0}) == 13);
+}
+
+TEST_CASE("flow_field:wide costs", "[flow_field][cardinal]") {
+    // the top middle cell costs nearly as much as the distance type can hold
+    grid<std::uint32_t> costs(3, 2, 1);
+    costs(1, 0) = impassable_cost<std::uint32_t> - 1;
+    costs(2, 0) = 2;
+
+    std::vector<point2i> const goals{{0, 0}};
+    auto const field = build_flow_field<cardinal_direction>(costs, goals);
+
+    REQUIRE(field.reachable(1, 0));
+    REQUIRE(field.distance(1, 0) == unreachable_distance - 1);
+    REQUIRE(field.distance(2, 0) == 5);
+    REQUIRE(field.direction(2, 0) == cardinal::north);
+
+    grid<std::uint64_t> wide_costs(3, 2, 1);
+    wide_costs(1, 0) = (std::uint64_t{1} << 32) + 1;
+    wide_costs(2, 0) = 2;
+    auto const wide_field =
+        build_flow_field<cardinal_direction>(wide_costs, goals);
+
+    REQUIRE(wide_field.distance(1, 0) == unreachable_distance - 1);
+    REQUIRE(wide_field.distance(2, 0) == 5);
+    REQUIRE(wide_field.direction(2, 0) == cardinal::north);
+}
+
+TEST_CASE("flow_field:multiple goals", "[flow_field][pointed_hex]") {
+    grid<std::uint16_t> const costs(9, 9, 1);
+    std::vector<point2i> const goals{{0, 0}, {8, 8}};
+    auto const field = build_flow_field<pointed_hex_direction>(costs, goals);
+
+    REQUIRE(field.goals().size() == 2);
+    REQUIRE(field.distance(1, 1) == 2);
+    REQUIRE(field.distance(7, 7) == 2);
+    REQUIRE(field.distance(8, 0) == 8);
+    REQUIRE(field.distance(0, 8) == 8);
+    REQUIRE(walk_to_goal(field, point2i{6, 5}) == 5);
+}
+
+TEST_CASE("flow_field:parallel", "[flow_field][execution]") {
+    grid<std::uint8_t> costs(1500, 1000, 1);
+    for (int y = 0; y < 990; ++y) {
+        costs(500, y) = impassable_cost<std::uint8_t>;
+        costs(1000, 999 - y) = impassable_cost<std::uint8_t>;
+    }
+    for (int x = 0; x < 1500; x += 7) { costs(x, 500) = 3; }
+
+    std::vector<point2i> const goals{{0, 0}, {1499, 0}, {750, 999}};
+    auto const serial = build_flow_field<cardinal_direction>(costs, goals);
+    auto const parallel =
+        build_flow_field<cardinal_direction>(std::execution::par, costs, goals);
+
+    REQUIRE(serial.distances() == parallel.distances());
+    REQUIRE(serial.directions() == parallel.directions());
+}
+
+TEST_CASE("flow_field:repair", "[flow_field][repair]") {
+    grid<std::uint8_t> costs(64, 48, 1);
+    for (int y = 0; y < 40; ++y) { costs(20, y) = impassable_cost<std::uint8_t>; }
+    std::vector<point2i> const goals{{2, 2}, {60, 40}};
+    auto field = build_flow_field<cardinal_direction>(costs, goals);
+
+    // place a building across the gap, then remove part of the wall
+    std::vector<point2i> changed;
+    for (int y = 40; y < 48; ++y) {
+        costs(20, y) = impassable_cost<std::uint8_t>;
+        changed.push_back(point2i{20, y});
+    }
+    costs(20, 10) = 1;
+    changed.push_back(point2i{20, 10});
+    costs(30, 30) = 9;
+    changed.push_back(point2i{30, 30});
+    field.repair(costs, changed);
+
+    auto const rebuilt = build_flow_field<cardinal_direction>(costs, goals);
+    REQUIRE(field.distances() == rebuilt.distances());
+    REQUIRE(field.directions() == rebuilt.directions());
+    REQUIRE(walk_to_goal(field, point2i{40, 5}) ==
+            walk_to_goal(rebuilt, point2i{40, 5}));
+
+    // seal the goal at (2, 2) off entirely
+    changed.clear();
+    for (int x = 0; x < 5; ++x) {
+        costs(x, 4) = impassable_cost<std::uint8_t>;
+        changed.push_back(point2i{x, 4});
+    }
+    for (int y = 0; y < 4; ++y) {
+        costs(4, y) = impassable_cost<std::uint8_t>;
+        changed.push_back(point2i{4, y});
+    }
+    field.repair(std::execution::par, costs, changed);
+
+    auto const sealed = build_flow_field<cardinal_direction>(costs, goals);
+    REQUIRE(field.distances() == sealed.distances());
+    REQUIRE(field.directions() == sealed.directions());
+    REQUIRE(field.distance(0, 0) == 4);
+    REQUIRE(walk_to_goal(field, point2i{0, 20}) == field.distance(0, 20));
+}
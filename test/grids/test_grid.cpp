@@ -0,0 +1,41 @@
+#include <catch2/catch.hpp>
+#include "spatula/grids.hpp"
+
+#include <cstdint>
+
+using namespace sp;
+
+namespace test_grid {
+struct point2i { int x, y; };
+struct point2f { float x, y; };
+}
+using namespace test_grid;
+
+TEST_CASE("grid_coordinate", "[grid]") {
+    REQUIRE(grid_coordinate<grid_point>);
+    REQUIRE(grid_coordinate<point2i>);
+    REQUIRE(not grid_coordinate<point2f>);
+}
+
+TEST_CASE("grid:indexing", "[grid]") {
+    grid<std::uint8_t> cells(4, 3, 7);
+    REQUIRE(cells.width() == 4);
+    REQUIRE(cells.height() == 3);
+    REQUIRE(cells.size() == 12);
+    REQUIRE(cells(3, 2) == 7);
+
+    cells(1, 2) = 5;
+    REQUIRE(cells[point2i{1, 2}] == 5);
+    REQUIRE(cells[cells.index_of(1, 2)] == 5);
+    REQUIRE(cells.row(2)[1] == 5);
+    REQUIRE(cells.point_of(cells.index_of(1, 2)) == grid_point{1, 2});
+}
+
+TEST_CASE("grid:contains", "[grid]") {
+    grid<int> const cells(4, 3);
+    REQUIRE(cells.contains(0, 0));
+    REQUIRE(cells.contains(point2i{3, 2}));
+    REQUIRE(not cells.contains(-1, 0));
+    REQUIRE(not cells.contains(4, 0));
+    REQUIRE(not cells.contains(point2i{0, 3}));
+}
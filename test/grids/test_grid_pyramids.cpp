@@ -0,0 +1,112 @@
+#include <catch2/catch.hpp>
+#include "spatula/grid_pyramids.hpp"
+#include "grid_fixtures.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <execution>
+
+using namespace sp;
+using namespace test_grids;
+
+namespace test_grid_pyramids {
+grid<int> scattered_heights(std::size_t width, std::size_t height,
+                            std::uint32_t seed)
+{
+    return seeded_grid<int>(width, height, seed, [](std::uint32_t state) {
+        return static_cast<int>((state >> 12) % 1000);
+    });
+}
+
+/** Reduce a region by visiting every cell in it. */
+template<class Reducer>
+std::optional<int> reduce_every_cell(grid<int> const & cells, rect region,
+                                     Reducer reduce)
+{
+    std::optional<int> result;
+    for_each_cell_in(cells, region, [&](int cell) {
+        result = result ? reduce(*result, cell) : cell;
+    });
+    return result;
+}
+}
+using namespace test_grid_pyramids;
+
+TEST_CASE("grid pyramids halve each level", "[grid_pyramids]")
+{
+    grid<int> cells(5, 3, 1);
+    grid_pyramid<int, std::plus<>> pyramid;
+    pyramid.rebuild(std::execution::par, cells);
+    REQUIRE(pyramid.levels() == 4);
+    REQUIRE(pyramid.level(1).width() == 3);
+    REQUIRE(pyramid.level(1).height() == 2);
+    REQUIRE(pyramid.level(1)(0, 0) == 4);
+    REQUIRE(pyramid.level(1)(2, 0) == 2);
+    REQUIRE(pyramid.level(1)(2, 1) == 1);
+    REQUIRE(pyramid.level(3)(0, 0) == 15);
+
+    grid_pyramid const empty(grid<int>{}, reduce_max{});
+    REQUIRE(empty.levels() == 1);
+    REQUIRE_FALSE(empty.reduce(rect{0, 0, 4, 4}).has_value());
+}
+
+TEST_CASE("grid pyramids reduce any region", "[grid_pyramids]")
+{
+    auto const cells = scattered_heights(71, 45, 2);
+    grid_pyramid const highest(cells, reduce_max{});
+    grid_pyramid const total(cells, std::plus<>{});
+    std::uint32_t seed = 4;
+    for (int i = 0; i < 3000; ++i) {
+        rect const region{next_random(seed, 81) - 5,
+                          next_random(seed, 55) - 5,
+                          next_random(seed, 60), next_random(seed, 50)};
+        REQUIRE(highest.reduce(region) ==
+                reduce_every_cell(cells, region, reduce_max{}));
+        REQUIRE(total.reduce(region) ==
+                reduce_every_cell(cells, region, std::plus<>{}));
+    }
+}
+
+TEST_CASE("grid pyramids update when cells change", "[grid_pyramids]")
+{
+    auto cells = scattered_heights(40, 33, 7);
+    grid_pyramid<int, reduce_min> lowest(cells);
+    std::uint32_t seed = 3;
+    for (int i = 0; i < 50; ++i) {
+        grid_point const cell{next_random(seed, 40), next_random(seed, 33)};
+        cells[cell] = next_random(seed, 2000) - 1000;
+        lowest.set(cell, cells[cell]);
+
+        rect const changed{next_random(seed, 40), next_random(seed, 33),
+                           next_random(seed, 6), next_random(seed, 6)};
+        for (int y = changed.y; y < changed.y + changed.h; ++y) {
+            for (int x = changed.x; x < changed.x + changed.w; ++x) {
+                if (cells.contains(x, y)) { cells(x, y) += 5; }
+            }
+        }
+        lowest.update(cells, changed);
+    }
+    grid_pyramid<int, reduce_min> const rebuilt(cells);
+    for (std::size_t k = 0; k < rebuilt.levels(); ++k) {
+        REQUIRE(lowest.level(k) == rebuilt.level(k));
+    }
+    REQUIRE(lowest.reduce(rect{0, 0, 40, 33}) ==
+            reduce_every_cell(cells, rect{0, 0, 40, 33}, reduce_min{}));
+}
+
+TEST_CASE("grid pyramids find cells coarse to fine", "[grid_pyramids]")
+{
+    grid<int> cells(300, 200, 0);
+    cells(250, 150) = 9;
+    cells(20, 30) = 4;
+    grid_pyramid const highest(cells, reduce_max{});
+    auto const tall = [](int height) { return height > 5; };
+    REQUIRE(highest.find(rect{0, 0, 300, 200}, tall) == grid_point{250, 150});
+    REQUIRE_FALSE(highest.find(rect{0, 0, 250, 200}, tall).has_value());
+    REQUIRE_FALSE(highest.find(rect{251, 0, 49, 200}, tall).has_value());
+    auto const any = [](int height) { return height > 0; };
+    REQUIRE(highest.find(grid_point{0, 0}, grid_point{100, 100}, any) ==
+            grid_point{20, 30});
+    REQUIRE_FALSE(highest.find(rect{21, 0, 200, 100}, any).has_value());
+}
@@ -0,0 +1,97 @@
+#include <catch2/catch.hpp>
+#include "spatula/hex_maps.hpp"
+
+#include <vector>
+#include <cstddef>
+
+using namespace sp;
+
+namespace test_hex_maps {
+struct axial2i { int q, r; };
+
+using flat_hex_direction = flat_hex::direction_name;
+using pointed_hex_direction = pointed_hex::direction_name;
+
+/** Check every in-map neighbour of every hex against its precomputed delta. */
+template<ranged_enum Enum, class Map, class Deltas>
+void check_neighbours(Map const & map, Deltas && deltas_of)
+{
+    auto const steps = directions_as<hex_point, Enum>();
+    for (std::size_t i = 0; i < map.size(); ++i) {
+        auto const hex = map.hex_of(i);
+        auto const & deltas = deltas_of(hex);
+        for (std::size_t d = 0; d < steps.size(); ++d) {
+            hex_point const next{hex.q + steps[d].q, hex.r + steps[d].r};
+            if (not map.contains(next)) { continue; }
+            auto const index = static_cast<std::ptrdiff_t>(i) + deltas[d];
+            REQUIRE(index == static_cast<std::ptrdiff_t>(map.index_of(next)));
+        }
+    }
+}
+}
+using namespace test_hex_maps;
+
+TEST_CASE("hexagon_map:indexing", "[hex][hex_map]") {
+    hexagon_map<int> map(3, 7);
+    REQUIRE(map.radius() == 3);
+    REQUIRE(map.size() == 37);
+    REQUIRE(map.row(-3).size() == 4);
+    REQUIRE(map.row(0).size() == 7);
+    REQUIRE(map.row(2).size() == 5);
+
+    // every hex within the radius has its own index, in row order
+    std::size_t expected = 0;
+    for (int r = -3; r <= 3; ++r) {
+        for (int q = -3; q <= 3; ++q) {
+            if (hex_distance(hex_point{0, 0}, hex_point{q, r}) > 3) {
+                REQUIRE(not map.contains(q, r));
+                continue;
+            }
+            REQUIRE(map.contains(axial2i{q, r}));
+            REQUIRE(map.index_of(q, r) == expected);
+            REQUIRE(map.hex_of(expected) == hex_point{q, r});
+            ++expected;
+        }
+    }
+    REQUIRE(expected == map.size());
+
+    map(2, -3) = 5;
+    REQUIRE(map[axial2i{2, -3}] == 5);
+    REQUIRE(map.row(-3)[2] == 5);
+    REQUIRE(map[map.index_of(2, -3)] == 5);
+    REQUIRE(not map.contains(4, 0));
+    REQUIRE(not map.contains(2, 2));
+}
+
+TEST_CASE("hexagon_map:neighbours", "[hex][hex_map]") {
+    hexagon_map<int, pointed_hex_direction> const pointed(5);
+    check_neighbours<pointed_hex_direction>(
+        pointed,
+        [&](hex_point hex) { return pointed.neighbour_deltas(hex.r); });
+
+    hexagon_map<int, flat_hex_direction> const flat(4);
+    check_neighbours<flat_hex_direction>(
+        flat, [&](hex_point hex) { return flat.neighbour_deltas(hex.r); });
+
+    hexagon_map<int> const single(0);
+    REQUIRE(single.size() == 1);
+    REQUIRE(single.hex_of(0) == hex_point{0, 0});
+}
+
+TEST_CASE("rhombus_map", "[hex][hex_map]") {
+    rhombus_map<float, flat_hex_direction> map(6, 4, 1.0f);
+    REQUIRE(map.size() == 24);
+    REQUIRE(map.contains(5, 3));
+    REQUIRE(not map.contains(6, 0));
+    REQUIRE(not map.contains(axial2i{0, -1}));
+
+    map(4, 2) = 3.0f;
+    REQUIRE(map[axial2i{4, 2}] == 3.0f);
+    REQUIRE(map.row(2)[4] == 3.0f);
+    REQUIRE(map.hex_of(map.index_of(4, 2)) == hex_point{4, 2});
+
+    check_neighbours<flat_hex_direction>(
+        map, [&](hex_point) { return map.neighbour_deltas(); });
+    REQUIRE(map.neighbour_deltas()[flat_hex::south] == 6);
+    REQUIRE(map.neighbour_deltas()[flat_hex::northeast] == -5);
+}
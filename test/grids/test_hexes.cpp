@@ -0,0 +1,208 @@
+#include <catch2/catch.hpp>
+#include "spatula/hexes.hpp"
+
+#include <execution>
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+using namespace sp;
+
+namespace test_hexes {
+struct point2i { int x, y; };
+struct point2d { double x, y; };
+struct axial2l { long q, r; };
+
+using flat_hex_direction = flat_hex::direction_name;
+using pointed_hex_direction = pointed_hex::direction_name;
+}
+using namespace test_hexes;
+
+TEST_CASE("hex_point", "[hex]") {
+    REQUIRE(semivector2<hex_point>);
+    REQUIRE(semivector2<axial2l>);
+    REQUIRE(hex_layout<flat_hex_direction>);
+    REQUIRE(hex_layout<pointed_hex_direction>);
+    REQUIRE(not hex_layout<cardinal::direction_name>);
+}
+
+TEST_CASE("hex_distance", "[hex]") {
+    REQUIRE(hex_distance(hex_point{0, 0}, hex_point{3, -4}) == 4);
+    REQUIRE(hex_distance(hex_point{0, 0}, hex_point{3, 4}) == 7);
+    REQUIRE(hex_distance(axial2l{-2, 1}, axial2l{-2, 1}) == 0);
+
+    // every direction is a single step away, in both orientations
+    for (auto const step : directions_as<hex_point, flat_hex_direction>()) {
+        REQUIRE(hex_distance(hex_point{0, 0}, step) == 1);
+    }
+    for (auto const step : directions_as<hex_point, pointed_hex_direction>()) {
+        REQUIRE(hex_distance(hex_point{0, 0}, step) == 1);
+    }
+}
+
+TEST_CASE("hex_round", "[hex]") {
+    REQUIRE(hex_round<hex_point>(point2d{0.1, -0.2}) == hex_point{0, 0});
+    REQUIRE(hex_round<hex_point>(point2d{1.4, 0.4}) == hex_point{1, 1});
+    REQUIRE(hex_round<hex_point>(point2d{0.9, -0.45}) == hex_point{1, 0});
+    REQUIRE(hex_round<hex_point>(point2d{-2.0, 3.0}) == hex_point{-2, 3});
+}
+
+TEST_CASE("hex_to_pixel:round trip", "[hex][pixel]") {
+    for (int q = -5; q <= 5; ++q) {
+        for (int r = -5; r <= 5; ++r) {
+            hex_point const hex{q, r};
+            auto const flat = hex_to_pixel<flat_hex_direction, point2d>(hex, 8.0);
+            auto const pointed =
+                hex_to_pixel<pointed_hex_direction, point2d>(hex, 8.0);
+            REQUIRE(pixel_to_hex<flat_hex_direction, hex_point>(flat, 8.0) == hex);
+            REQUIRE(pixel_to_hex<pointed_hex_direction, hex_point>(pointed, 8.0)
+                    == hex);
+
+            // a point just inside the hex still lands in it
+            point2d const nudged{flat.x + 3.0, flat.y - 2.0};
+            REQUIRE(pixel_to_hex<flat_hex_direction, hex_point>(nudged, 8.0)
+                    == hex);
+        }
+    }
+}
+
+TEST_CASE("hex_to_pixel:orientation", "[hex][pixel]") {
+    // north is straight up the screen for flat hexes
+    auto const north = hex_to_pixel<flat_hex_direction, point2d>(
+        direction_as<hex_point>(flat_hex::north), 1.0);
+    REQUIRE(north.x == Approx(0.0));
+    REQUIRE(north.y < 0.0);
+
+    // east is straight across the screen for pointed hexes
+    auto const east = hex_to_pixel<pointed_hex_direction, point2d>(
+        direction_as<hex_point>(pointed_hex::east), 1.0);
+    REQUIRE(east.y == Approx(0.0));
+    REQUIRE(east.x > 0.0);
+}
+
+TEST_CASE("hex_rotate", "[hex][symmetry]") {
+    auto const east = direction_as<hex_point>(pointed_hex::east);
+    REQUIRE(hex_rotate(east, 1) ==
+            direction_as<hex_point>(pointed_hex::southeast));
+    REQUIRE(hex_rotate(east, -1) ==
+            direction_as<hex_point>(pointed_hex::northeast));
+    REQUIRE(hex_rotate(east, 3) == direction_as<hex_point>(pointed_hex::west));
+
+    // rotating through each direction visits them in order
+    for (int i = 0; i < 6; ++i) {
+        auto const from = static_cast<pointed_hex_direction>(i);
+        auto const to = static_cast<pointed_hex_direction>((i + 2) % 6);
+        REQUIRE(hex_rotate(direction_as<hex_point>(from), 2) ==
+                direction_as<hex_point>(to));
+    }
+    REQUIRE(hex_rotate(hex_point{2, -1}, 6) == hex_point{2, -1});
+}
+
+TEST_CASE("hex_reflect", "[hex][symmetry]") {
+    hex_point const hex{2, -3};
+    REQUIRE(hex_reflect(hex, hex_axis::q) == hex_point{2, 1});
+    REQUIRE(hex_reflect(hex, hex_axis::r) == hex_point{1, -3});
+    REQUIRE(hex_reflect(hex, hex_axis::s) == hex_point{-3, 2});
+    for (auto const axis : {hex_axis::q, hex_axis::r, hex_axis::s}) {
+        REQUIRE(hex_reflect(hex_reflect(hex, axis), axis) == hex);
+        REQUIRE(hex_distance(hex_point{0, 0}, hex_reflect(hex, axis)) ==
+                hex_distance(hex_point{0, 0}, hex));
+    }
+}
+
+TEST_CASE("hex batches", "[hex][batch]") {
+    std::vector<hex_point> hexes;
+    for (int q = -20; q <= 20; ++q) {
+        for (int r = -20; r <= 20; ++r) { hexes.push_back(hex_point{q, r}); }
+    }
+    std::vector<hex_point> const origin(hexes.size(), hex_point{1, 2});
+
+    std::vector<int> distances(hexes.size());
+    hex_distance(std::execution::par_unseq, hexes, origin, distances.begin());
+
+    std::vector<point2d> pixels(hexes.size());
+    hex_to_pixel<pointed_hex_direction, point2d>(
+        std::execution::unseq, hexes, 5.0, pixels.begin());
+    std::vector<hex_point> rounded(hexes.size());
+    pixel_to_hex<pointed_hex_direction, hex_point>(
+        std::execution::par, pixels, 5.0, rounded.begin());
+
+    std::vector<hex_point> rotated(hexes.size());
+    hex_rotate(std::execution::unseq, hexes, 2, rotated.begin());
+    std::vector<hex_point> reflected(hexes.size());
+    hex_reflect(std::execution::unseq, hexes, hex_axis::r, reflected.begin());
+
+    for (std::size_t i = 0; i < hexes.size(); ++i) {
+        REQUIRE(distances[i] == hex_distance(hexes[i], hex_point{1, 2}));
+        REQUIRE(rounded[i] == hexes[i]);
+        REQUIRE(rotated[i] == hex_rotate(hexes[i], 2));
+        REQUIRE(reflected[i] == hex_reflect(hexes[i], hex_axis::r));
+    }
+}
+
+TEST_CASE("views::hex_ring", "[hex][views]") {
+    hex_point const center{2, -1};
+    auto const ring = views::hex_ring(center, 3);
+    static_assert(ranges::random_access_range<decltype(ring)>);
+    static_assert(ranges::sized_range<decltype(ring)>);
+    static_assert(ranges::view<std::remove_const_t<decltype(ring)>>);
+
+    REQUIRE(ring.size() == 18);
+    REQUIRE(ranges::distance(ring) == 18);
+    REQUIRE(ring[0] == hex_point{-1, -1});
+    for (auto const hex : ring) { REQUIRE(hex_distance(center, hex) == 3); }
+
+    // consecutive hexes are neighbours, and the ring closes on itself
+    for (std::size_t i = 0; i < ring.size(); ++i) {
+        auto const next = ring[(i + 1) % ring.size()];
+        REQUIRE(hex_distance(ring[i], next) == 1);
+    }
+
+    auto const flat = views::hex_ring<flat_hex_direction>(center, 3);
+    std::vector<hex_point> flat_hexes(flat.begin(), flat.end());
+    std::vector<hex_point> pointed_hexes(ring.begin(), ring.end());
+    auto const key = [](hex_point h) { return std::pair{h.q, h.r}; };
+    std::ranges::sort(flat_hexes, {}, key);
+    std::ranges::sort(pointed_hexes, {}, key);
+    REQUIRE(flat_hexes == pointed_hexes);
+
+    REQUIRE(views::hex_ring(center, 0).size() == 1);
+    REQUIRE(views::hex_ring(center, 0)[0] == center);
+    REQUIRE(views::hex_ring(center, -1).empty());
+}
+
+TEST_CASE("views::hex_spiral and views::hex_range", "[hex][views]") {
+    axial2l const center{-3, 4};
+    auto const spiral = views::hex_spiral(center, 4);
+    auto const range = views::hex_range(center, 4);
+    static_assert(ranges::forward_range<decltype(spiral)>);
+    static_assert(ranges::sized_range<decltype(spiral)>);
+    static_assert(ranges::sized_range<decltype(range)>);
+
+    REQUIRE(spiral.size() == 61);
+    REQUIRE(range.size() == 61);
+    REQUIRE(ranges::distance(spiral) == 61);
+    REQUIRE(ranges::distance(range) == 61);
+
+    // the spiral moves outwards one ring at a time
+    long previous = 0;
+    for (auto const hex : spiral) {
+        auto const distance = hex_distance(center, hex);
+        REQUIRE(distance <= 4);
+        REQUIRE(distance >= previous);
+        previous = distance;
+    }
+
+    // both views cover every hex within the radius exactly once
+    auto const key = [](axial2l h) { return std::pair{h.q, h.r}; };
+    std::vector<axial2l> spiral_hexes(spiral.begin(), spiral.end());
+    std::vector<axial2l> range_hexes(range.begin(), range.end());
+    std::ranges::sort(spiral_hexes, {}, key);
+    REQUIRE(std::ranges::is_sorted(range_hexes, {}, key));
+    REQUIRE(std::ranges::adjacent_find(range_hexes, {}, key) ==
+            range_hexes.end());
+    REQUIRE(std::ranges::equal(spiral_hexes, range_hexes, {}, key, key));
+
+    REQUIRE(views::hex_spiral(center, 0).size() == 1);
+    REQUIRE(views::hex_range(center, -2).empty());
+}
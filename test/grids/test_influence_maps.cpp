@@ -0,0 +1,167 @@
+#include <catch2/catch.hpp>
+#include "spatula/influence_maps.hpp"
+#include "grid_fixtures.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <execution>
+
+using namespace sp;
+using namespace test_grids;
+
+namespace test_influence_maps {
+/** Fill a layer with arbitrary values. */
+void scatter(influence_map & map, std::size_t layer)
+{
+    std::uint32_t state = 31337;
+    for (float & cell : map.layer(layer)) {
+        cell = static_cast<float>(next_state(state) >> 24) / 16.0f;
+    }
+}
+
+/** Convolve a layer with the full square kernel, one cell at a time. */
+std::vector<float> slow_propagate(influence_map const & map,
+                                  std::size_t layer,
+                                  std::span<float const> falloff)
+{
+    auto const radius = static_cast<int>(falloff.size()) - 1;
+    auto const width = static_cast<int>(map.width());
+    auto const height = static_cast<int>(map.height());
+    std::vector<float> result;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            double total = 0.0;
+            for (int dy = -radius; dy <= radius; ++dy) {
+                for (int dx = -radius; dx <= radius; ++dx) {
+                    if (not map.contains(x + dx, y + dy)) { continue; }
+                    total += falloff[static_cast<std::size_t>(std::abs(dx))] *
+                             falloff[static_cast<std::size_t>(std::abs(dy))] *
+                             map(layer, x + dx, y + dy);
+                }
+            }
+            result.push_back(static_cast<float>(total));
+        }
+    }
+    return result;
+}
+}
+using namespace test_influence_maps;
+
+TEST_CASE("influence maps hold separate layers", "[influence_map]")
+{
+    influence_map map(8, 6, 3);
+    REQUIRE(map.width() == 8);
+    REQUIRE(map.height() == 6);
+    REQUIRE(map.layers() == 3);
+
+    map(1, 2, 3) = 4.0f;
+    map(2, grid_point{2, 3}) = 5.0f;
+    REQUIRE(map(0, 2, 3) == 0.0f);
+    REQUIRE(map(1, grid_point{2, 3}) == 4.0f);
+    REQUIRE(map.row(2, 3)[2] == 5.0f);
+    REQUIRE(map.layer(1).size() == 48);
+}
+
+TEST_CASE("influence decays by a constant factor", "[influence_map]")
+{
+    influence_map map(5, 5, 1);
+    map.fill(0, 8.0f);
+    map.decay(std::execution::par_unseq, 0, 0.5f);
+    map.decay(0, 0.5f);
+    REQUIRE(std::ranges::all_of(map.layer(0), [](float value) {
+        return value == 2.0f;
+    }));
+}
+
+TEST_CASE("influence spreads with a separable blur", "[influence_map]")
+{
+    std::array<float, 3> const falloff{0.4f, 0.2f, 0.1f};
+    SECTION("a point spreads into the shape of the kernel") {
+        influence_map map(9, 9, 1);
+        map(0, 4, 4) = 1.0f;
+        map.propagate(0, falloff);
+        REQUIRE(map(0, 4, 4) == Approx(0.16f));
+        REQUIRE(map(0, 5, 4) == Approx(0.08f));
+        REQUIRE(map(0, 6, 6) == Approx(0.01f));
+        REQUIRE(map(0, 7, 4) == 0.0f);
+    }
+    SECTION("whole layers match a direct convolution") {
+        using size = std::pair<std::size_t, std::size_t>;
+        for (auto const & [width, height] : {size{70, 45}, size{1, 1},
+                                             size{3, 90}}) {
+            influence_map map(width, height, 2);
+            scatter(map, 1);
+            auto const expected = slow_propagate(map, 1, falloff);
+            map.propagate(std::execution::par, 1, falloff);
+            for (std::size_t i = 0; i < expected.size(); ++i) {
+                REQUIRE(map.layer(1)[i] == Approx(expected[i]));
+            }
+        }
+    }    SECTION("different layers can spread at the same time") {
+        influence_map map(40, 70, 4);
+        std::array<std::size_t, 4> const layers{0, 1, 2, 3};
+        std::vector<std::vector<float>> expected;
+        for (auto const layer : layers) {
+            scatter(map, layer);
+            map.decay(layer, 1.0f + static_cast<float>(layer));
+            expected.push_back(slow_propagate(map, layer, falloff));
+        }
+        std::for_each(std::execution::par, layers.begin(), layers.end(),
+                      [&](std::size_t layer) {
+            map.propagate(layer, falloff);
+        });
+        for (auto const layer : layers) {
+            for (std::size_t i = 0; i < expected[layer].size(); ++i) {
+                REQUIRE(map.layer(layer)[i] == Approx(expected[layer][i]));
+            }
+        }
+    }
+}
+
+TEST_CASE("influence layers blend into a weighted sum", "[influence_map]")
+{
+    influence_map map(40, 40, 3);
+    map.fill(0, 2.0f);
+    map.fill(1, 3.0f);
+    map(1, 10, 10) = 7.0f;
+
+    map.blend(2, {{0, 1.0f}, {1, -0.5f}});
+    REQUIRE(map(2, 0, 0) == Approx(0.5f));
+    REQUIRE(map(2, 10, 10) == Approx(-1.5f));
+
+    // a layer can be blended into itself
+    std::array<layer_weight, 2> const weights{{{0, 2.0f}, {1, 1.0f}}};
+    map.blend(std::execution::par, 0, weights);
+    REQUIRE(map(0, 39, 39) == Approx(7.0f));
+    REQUIRE(map(0, 10, 10) == Approx(11.0f));
+}
+
+TEST_CASE("the strongest influence in a region can be found",
+          "[influence_map]")
+{
+    influence_map map(20, 10, 1);
+    map(0, 3, 2) = 5.0f;
+    map(0, 15, 8) = 9.0f;
+    map(0, 16, 8) = 9.0f;
+
+    auto const whole = map.max_influence(0, grid_point{-5, -5},
+                                         grid_point{100, 100});
+    REQUIRE(whole);
+    REQUIRE(whole->cell == grid_point{15, 8});
+    REQUIRE(whole->value == 9.0f);
+
+    auto const corner = map.max_influence(0, grid_point{0, 0},
+                                          grid_point{9, 9});
+    REQUIRE(corner->cell == grid_point{3, 2});
+
+    auto const empty = map.max_influence(0, grid_point{5, 5},
+                                         grid_point{6, 6});
+    REQUIRE(empty->value == 0.0f);
+    REQUIRE(empty->cell == grid_point{5, 5});
+
+    REQUIRE_FALSE(map.max_influence(0, grid_point{30, 0},
+                                    grid_point{40, 5}));
+}
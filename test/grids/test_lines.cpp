@@ -0,0 +1,192 @@
+#include <catch2/catch.hpp>
+#include "spatula/lines.hpp"
+
+#include <cstdlib>
+#include <vector>
+#include <ranges>
+
+using namespace sp;
+
+namespace test_lines {
+struct point2 { int x, y; };
+struct point3 { int x, y, z; };
+
+bool operator==(point2 const & a, point2 const & b)
+{
+    return a.x == b.x and a.y == b.y;
+}
+bool operator==(point3 const & a, point3 const & b)
+{
+    return a.x == b.x and a.y == b.y and a.z == b.z;
+}
+
+template<class Range>
+auto collect(Range && range)
+{
+    std::vector<std::ranges::range_value_t<Range>> points;
+    for (auto const & point : range) { points.push_back(point); }
+    return points;
+}
+
+/** The supercover of a square line, found by walking from cell to cell and
+ * stepping along x first whenever the line passes through a corner. */
+std::vector<point2> walk_supercover(point2 a, point2 b)
+{
+    int const dx = std::abs(b.x - a.x);
+    int const dy = std::abs(b.y - a.y);
+    int const step_x = b.x < a.x ? -1 : 1;
+    int const step_y = b.y < a.y ? -1 : 1;
+    std::vector<point2> cells{a};
+    auto cell = a;
+    // error compares when the line next crosses a column and a row
+    int error = dx - dy;
+    for (int i = 0; i < dx + dy; ++i) {
+        if (error >= 0 and cell.x != b.x) {
+            cell.x += step_x;
+            error -= 2 * dy;
+        }
+        else {
+            cell.y += step_y;
+            error += 2 * dx;
+        }
+        cells.push_back(cell);
+    }
+    return cells;
+}
+
+int taxicab(point3 const & a, point3 const & b)
+{
+    return std::abs(a.x - b.x) + std::abs(a.y - b.y) + std::abs(a.z - b.z);
+}
+}
+using namespace test_lines;
+
+static_assert(std::ranges::random_access_range<line_view<point2>>);
+static_assert(std::ranges::sized_range<line_view<point3>>);
+static_assert(std::ranges::random_access_range<supercover_line_view<point3>>);
+static_assert(std::ranges::view<supercover_line_view<point2>>);
+
+TEST_CASE("lines visit one point for each step along the longest axis",
+          "[lines]")
+{
+    auto const points = collect(views::line(point2{0, 0}, point2{5, 2}));
+    std::vector<point2> const expected{{0, 0}, {1, 0}, {2, 1}, {3, 1},
+                                       {4, 2}, {5, 2}};
+    REQUIRE(points == expected);
+
+    auto const back = collect(views::line(point2{3, -1}, point2{-1, -3}));
+    std::vector<point2> const expected_back{{3, -1}, {2, -2}, {1, -2},
+                                            {0, -3}, {-1, -3}};
+    REQUIRE(back == expected_back);
+
+    auto const single = views::line(point2{4, 4}, point2{4, 4});
+    REQUIRE(single.size() == 1);
+    REQUIRE(single[0] == point2{4, 4});
+}
+
+TEST_CASE("lines run between their endpoints in any direction", "[lines]")
+{
+    for (int x = -6; x <= 6; ++x) {
+        for (int y = -6; y <= 6; ++y) {
+            point2 const a{1, -2};
+            point2 const b{1 + x, -2 + y};
+            auto const line = views::line(a, b);
+            auto const longest = std::max(std::abs(x), std::abs(y));
+            REQUIRE(line.size() == static_cast<std::size_t>(longest + 1));
+            REQUIRE(line.front() == a);
+            REQUIRE(line.back() == b);
+            for (std::size_t i = 1; i < line.size(); ++i) {
+                auto const step_x = std::abs(line[i].x - line[i - 1].x);
+                auto const step_y = std::abs(line[i].y - line[i - 1].y);
+                REQUIRE(std::max(step_x, step_y) == 1);
+            }
+        }
+    }
+}
+
+TEST_CASE("supercover lines match a walk from cell to cell", "[lines]")
+{
+    for (int x = -7; x <= 7; ++x) {
+        for (int y = -7; y <= 7; ++y) {
+            point2 const a{2, 3};
+            point2 const b{2 + x, 3 + y};
+            REQUIRE(collect(views::supercover_line(a, b)) ==
+                    walk_supercover(a, b));
+        }
+    }
+    auto const corner = collect(views::supercover_line(point2{0, 0},
+                                                       point2{2, 2}));
+    std::vector<point2> const expected{{0, 0}, {1, 0}, {1, 1}, {2, 1},
+                                       {2, 2}};
+    REQUIRE(corner == expected);
+}
+
+TEST_CASE("voxel lines step face to face", "[lines]")
+{
+    point3 const a{-1, 2, 0};
+    for (int x = -4; x <= 4; ++x) {
+        for (int y = -4; y <= 4; ++y) {
+            for (int z = -4; z <= 4; ++z) {
+                point3 const b{a.x + x, a.y + y, a.z + z};
+                auto const cover = views::supercover_line(a, b);
+                REQUIRE(cover.size() ==
+                        static_cast<std::size_t>(taxicab(a, b) + 1));
+                REQUIRE(cover.front() == a);
+                REQUIRE(cover.back() == b);
+                for (std::size_t i = 1; i < cover.size(); ++i) {
+                    REQUIRE(taxicab(cover[i], cover[i - 1]) == 1);
+                    REQUIRE(taxicab(cover[i], b) < taxicab(cover[i - 1], b));
+                }
+
+                auto const line = views::line(a, b);
+                REQUIRE(line.front() == a);
+                REQUIRE(line.back() == b);
+            }
+        }
+    }
+}
+
+TEST_CASE("voxel supercover lines pass through every crossed cell",
+          "[lines]")
+{
+    // the line from (0, 0, 0) to (3, 1, 0) crosses x = 0.5, 1.5, 2.5 and
+    // y = 0.5, and the y crossing ties with x = 1.5
+    auto const cells = collect(views::supercover_line(point3{0, 0, 0},
+                                                      point3{3, 1, 0}));
+    std::vector<point3> const expected{{0, 0, 0}, {1, 0, 0}, {2, 0, 0},
+                                       {2, 1, 0}, {3, 1, 0}};
+    REQUIRE(cells == expected);
+
+    auto const diagonal = collect(views::supercover_line(point3{0, 0, 0},
+                                                         point3{1, 1, 1}));
+    std::vector<point3> const expected_diagonal{{0, 0, 0}, {1, 0, 0},
+                                                {1, 1, 0}, {1, 1, 1}};
+    REQUIRE(diagonal == expected_diagonal);
+
+    for (int x = -5; x <= 5; ++x) {
+        for (int y = -5; y <= 5; ++y) {
+            auto const flat = walk_supercover(point2{0, 0}, point2{x, y});
+            auto const cover = views::supercover_line(point3{0, 0, 4},
+                                                      point3{x, y, 4});
+            REQUIRE(cover.size() == flat.size());
+            for (std::size_t i = 0; i < flat.size(); ++i) {
+                REQUIRE(cover[i] == point3{flat[i].x, flat[i].y, 4});
+            }
+        }
+    }
+}
+
+TEST_CASE("lines can be split by index", "[lines]")
+{
+    auto const line = views::supercover_line(point3{0, 0, 0},
+                                             point3{37, -12, 25});
+    auto const whole = collect(line);
+    auto const half = line.begin() + 37;
+    auto const first = collect(std::ranges::subrange(line.begin(), half));
+    auto const second = collect(std::ranges::subrange(half, line.end()));
+    REQUIRE(first.size() + second.size() == whole.size());
+    REQUIRE(std::equal(first.begin(), first.end(), whole.begin()));
+    REQUIRE(std::equal(second.begin(), second.end(), whole.begin() + 37));
+    REQUIRE(*(line.end() - 1) == point3{37, -12, 25});
+    REQUIRE(line.end() - line.begin() == 75);
+}
@@ -0,0 +1,94 @@
+#include <catch2/catch.hpp>
+#include "spatula/nearest_directions.hpp"
+#include "spatula/packed_enums.hpp"
+
+#include <cmath>
+#include <numbers>
+#include <execution>
+#include <vector>
+
+using namespace sp;
+
+namespace test_nearest_directions {
+struct point2i { int x, y; };
+struct point2f { float x, y; };
+struct point2d { double x, y; };
+struct point3i { int x, y, z; };
+
+/** Every direction survives a round trip through a vector. */
+template<tabled_direction Enum, class Vector>
+void check_round_trip()
+{
+    for (std::size_t i = 0; i < enum_size_v<Enum>; ++i) {
+        auto const dir = static_cast<Enum>(i);
+        REQUIRE(nearest_direction<Enum>(direction_as<Vector>(dir)) == dir);
+    }
+}
+}
+using namespace test_nearest_directions;
+
+TEST_CASE("nearest_direction:round trip", "[directions][nearest]") {
+    check_round_trip<cardinal::direction_name, point2i>();
+    check_round_trip<octile::direction_name, point2i>();
+    check_round_trip<octile::direction_name, point2f>();
+    check_round_trip<flat_hex::direction_name, point2i>();
+    check_round_trip<pointed_hex::direction_name, point2d>();
+    check_round_trip<triangular::direction_name, point3i>();
+    check_round_trip<voxel6::direction_name, point3i>();
+    check_round_trip<voxel18::direction_name, point3i>();
+    check_round_trip<voxel26::direction_name, point3i>();
+}
+
+TEST_CASE("nearest_direction:sectors", "[directions][nearest]") {
+    using octile_direction = octile::direction_name;
+    REQUIRE(nearest_direction<cardinal::direction_name>(point2d{0.9, 0.3}) ==
+            cardinal::east);
+    REQUIRE(nearest_direction<cardinal::direction_name>(point2d{-0.2, -5.0}) ==
+            cardinal::south);
+    REQUIRE(nearest_direction<octile_direction>(point2d{2.0, 1.0}) ==
+            octile::northeast);
+    REQUIRE(nearest_direction<octile_direction>(point2d{3.0, 1.0}) ==
+            octile::east);
+    REQUIRE(nearest_direction<octile_direction>(point2d{0.0, 0.0}) ==
+            octile::north);
+
+    // axial (3, -1) points between east and northeast, but nearer east
+    REQUIRE(nearest_direction<pointed_hex::direction_name>(point2i{3, -1}) ==
+            pointed_hex::east);
+    REQUIRE(nearest_direction<voxel26::direction_name>(point3i{5, 4, -4}) ==
+            voxel26::down_northeast);
+    REQUIRE(nearest_direction<voxel6::direction_name>(point3i{5, 4, -4}) ==
+            voxel6::east);
+
+    // sweep a circle: each octile sector is 45 degrees wide
+    for (int degrees = 0; degrees < 360; ++degrees) {
+        double const angle = (degrees + 0.25) * std::numbers::pi / 180.0;
+        // north is at 90 degrees, and directions run clockwise
+        int const sector = static_cast<int>(
+            std::floor((90.0 - (degrees + 0.25) + 22.5 + 360.0) / 45.0)) % 8;
+        REQUIRE(nearest_direction<octile_direction>(
+                    point2d{std::cos(angle), std::sin(angle)}) ==
+                static_cast<octile_direction>(sector));
+    }
+}
+
+TEST_CASE("nearest_direction:batch", "[directions][nearest][batch]") {
+    std::vector<point2f> velocities;
+    for (int i = 0; i < 5000; ++i) {
+        float const angle = static_cast<float>(i) * 0.37f;
+        float const speed = static_cast<float>(i % 7);
+        velocities.push_back(point2f{std::cos(angle) * speed,
+                                     std::sin(angle) * 3.0f});
+    }
+    std::vector<octile::direction_name> directions(velocities.size());
+    nearest_direction<octile::direction_name>(
+        std::execution::par_unseq, velocities, directions.begin());
+
+    packed_enum_vector<octile::direction_name> packed(velocities.size());
+    for (std::size_t i = 0; i < velocities.size(); ++i) {
+        REQUIRE(directions[i] ==
+                nearest_direction<octile::direction_name>(velocities[i]));
+        packed.set(i, directions[i]);
+    }
+    REQUIRE(packed.words().size() == (velocities.size() + 20) / 21);
+}
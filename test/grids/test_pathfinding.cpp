@@ -0,0 +1,185 @@
+#include <catch2/catch.hpp>
+#include "spatula/pathfinding.hpp"
+#include "grid_fixtures.hpp"
+
+#include <execution>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+
+using namespace sp;
+using namespace test_grids;
+
+namespace test_pathfinding {
+struct point2i { int x, y; };
+
+using cardinal_direction = cardinal::direction_name;
+using pointed_hex_direction = pointed_hex::direction_name;
+
+/** A maze-like cost grid with scattered walls and expensive cells. */
+grid<std::uint8_t> scattered_walls(std::size_t width, std::size_t height)
+{
+    return seeded_grid<std::uint8_t>(width, height, 12345,
+                                     [](std::uint32_t state) {
+        auto const roll = (state >> 24) % 10;
+        if (roll < 3) { return impassable_cost<std::uint8_t>; }
+        return static_cast<std::uint8_t>(roll == 3 ? 4 : 1);
+    });
+}
+
+/** Determine if a path only takes legal steps, and total up its cost. */
+template<ranged_enum Enum>
+std::uint32_t path_cost(grid<std::uint8_t> const & costs,
+                        std::vector<grid_point> const & path)
+{
+    auto const offsets = directions_as<grid_point, Enum>();
+    std::uint32_t total = 0;
+    for (std::size_t i = 1; i < path.size(); ++i) {
+        grid_point const step{path[i].x - path[i - 1].x,
+                              path[i].y - path[i - 1].y};
+        REQUIRE(std::ranges::find(offsets, step) != offsets.end());
+        REQUIRE(costs[path[i]] != impassable_cost<std::uint8_t>);
+        total += costs[path[i]];
+    }
+    return total;
+}
+
+/** The cost of walking from a cell to the goal of a flow field.
+ *
+ * Flow fields count the cost of each cell on the path except for the goal,
+ * while a walk pays for every cell it steps into.
+ */
+std::uint32_t walk_cost(flow_field<cardinal_direction> const & field,
+                        grid<std::uint8_t> const & costs,
+                        point2i cell, point2i goal)
+{
+    return field.distance(cell) - costs[cell] + costs[goal];
+}
+}
+using namespace test_pathfinding;
+
+TEST_CASE("step_distance", "[pathfinding][directions]") {
+    REQUIRE(step_distance<cardinal_direction>{}(3, -4) == 7);
+    REQUIRE(step_distance<pointed_hex_direction>{}(3, -4) == 4);
+    REQUIRE(step_distance<pointed_hex_direction>{}(3, 4) == 7);
+}
+
+TEST_CASE("find_path", "[pathfinding][astar]") {
+    auto const costs = scattered_walls(40, 30);
+    point2i const start{0, 0};
+    point2i const goal{39, 29};
+    auto const field = build_flow_field<cardinal_direction>(
+        costs, std::vector<point2i>{goal});
+
+    for (int y = 0; y < 30; y += 3) {
+        for (int x = 0; x < 40; x += 3) {
+            if (costs(x, y) == impassable_cost<std::uint8_t>) { continue; }
+            auto const path = find_path<cardinal_direction>(
+                costs, point2i{x, y}, goal);
+            if (not field.reachable(x, y)) {
+                REQUIRE(path.empty());
+                continue;
+            }
+            REQUIRE(path.front() == grid_point{x, y});
+            REQUIRE(path.back() == grid_point{goal.x, goal.y});
+            REQUIRE(path_cost<cardinal_direction>(costs, path) ==
+                    walk_cost(field, costs, point2i{x, y}, goal));
+        }
+    }
+    REQUIRE(find_path<cardinal_direction>(costs, start, start).size() == 1);
+}
+
+TEST_CASE("find_path:wide costs", "[pathfinding][astar]") {
+    // the middle cell costs more than the distance type can hold
+    point2i const start{0, 1};
+    point2i const goal{4, 1};
+    auto const check_detour = [&](auto const & costs) {
+        auto const path = find_path<cardinal_direction>(costs, start, goal);
+        REQUIRE(path.size() == 7);
+        REQUIRE(std::ranges::find(path, grid_point{2, 1}) == path.end());
+    };
+
+    grid<std::uint32_t> costs(5, 3, 1);
+    costs(2, 1) = impassable_cost<std::uint32_t> - 1;
+    check_detour(costs);
+
+    grid<std::uint64_t> wide_costs(5, 3, 1);
+    wide_costs(2, 1) = (std::uint64_t{1} << 32) + 1;
+    check_detour(wide_costs);
+
+    hierarchical_pathfinder<cardinal_direction, std::uint64_t> pathfinder(
+        wide_costs, 16);
+    auto const path = pathfinder.find_path(start, goal);
+    REQUIRE(path.size() == 7);
+    REQUIRE(std::ranges::find(path, grid_point{2, 1}) == path.end());
+}
+
+TEST_CASE("hierarchical_pathfinder", "[pathfinding][hpa]") {
+    auto costs = scattered_walls(96, 80);
+    hierarchical_pathfinder<cardinal_direction, std::uint8_t> pathfinder(
+        costs, 16);
+    pathfinder.refresh(std::execution::par);
+
+    REQUIRE(pathfinder.chunks_x() == 6);
+    REQUIRE(pathfinder.chunks_y() == 5);
+    REQUIRE(pathfinder.node_count() > 0);
+
+    point2i const goal{90, 75};
+    auto const check_paths = [&]() {
+        auto const field = build_flow_field<cardinal_direction>(
+            costs, std::vector<point2i>{goal});
+        for (int y = 1; y < 80; y += 11) {
+            for (int x = 2; x < 96; x += 13) {
+                if (costs(x, y) == impassable_cost<std::uint8_t>) { continue; }
+                auto const path = pathfinder.find_path(point2i{x, y}, goal);
+                REQUIRE(path.empty() == not field.reachable(x, y));
+                if (path.empty()) { continue; }
+
+                REQUIRE(path.front() == grid_point{x, y});
+                REQUIRE(path.back() == grid_point{goal.x, goal.y});
+                auto const best = walk_cost(field, costs, point2i{x, y}, goal);
+                auto const cost = path_cost<cardinal_direction>(costs, path);
+                REQUIRE(cost >= best);
+                REQUIRE(cost <= best * 2);
+            }
+        }
+    };
+    check_paths();
+
+    // carve a corridor through the middle of the map
+    for (int x = 0; x < 96; ++x) {
+        costs(x, 40) = 1;
+        pathfinder.invalidate(point2i{x, 40});
+    }
+    for (int y = 0; y < 80; ++y) {
+        costs(48, y) = 1;
+        pathfinder.invalidate(point2i{48, y});
+    }
+    check_paths();
+    auto const across = pathfinder.find_path(point2i{0, 40}, point2i{48, 0});
+    auto const flat = find_path<cardinal_direction>(
+        costs, point2i{0, 40}, point2i{48, 0});
+    auto const flat_cost = path_cost<cardinal_direction>(costs, flat);
+    REQUIRE(flat_cost == 88);
+    REQUIRE(path_cost<cardinal_direction>(costs, across) <= flat_cost * 5 / 4);
+}
+
+TEST_CASE("hierarchical_pathfinder:hex", "[pathfinding][hpa][hex]") {
+    grid<std::uint8_t> costs(64, 64, 1);
+    for (int y = 0; y < 60; ++y) { costs(31, y) = impassable_cost<std::uint8_t>; }
+    hierarchical_pathfinder<pointed_hex_direction, std::uint8_t> pathfinder(
+        costs, 16);
+
+    auto const path = pathfinder.find_path(point2i{0, 0}, point2i{63, 0});
+    REQUIRE(not path.empty());
+    auto const flat = find_path<pointed_hex_direction>(
+        costs, point2i{0, 0}, point2i{63, 0});
+    REQUIRE(path_cost<pointed_hex_direction>(costs, path) >=
+            path_cost<pointed_hex_direction>(costs, flat));
+
+    for (int y = 60; y < 64; ++y) {
+        costs(31, y) = impassable_cost<std::uint8_t>;
+        pathfinder.invalidate(31, y);
+    }
+    REQUIRE(pathfinder.find_path(point2i{0, 0}, point2i{63, 0}).empty());
+}
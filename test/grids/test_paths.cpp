@@ -0,0 +1,109 @@
+#include <catch2/catch.hpp>
+#include "spatula/paths.hpp"
+
+#include <vector>
+
+using namespace sp;
+
+namespace test_paths {
+struct point2i { int x, y; };
+}
+using namespace test_paths;
+
+TEST_CASE("path_cache:insert", "[path_cache]") {
+    path_cache cache;
+    std::vector<point2i> const path{{0, 0}, {1, 0}, {2, 0}};
+    auto const id = cache.insert(path);
+
+    REQUIRE(cache.contains(id));
+    REQUIRE(cache.size() == 1);
+    REQUIRE(cache.path(id).size() == 3);
+    REQUIRE(cache.path(id)[2] == grid_point{2, 0});
+
+    cache.erase(id);
+    REQUIRE(not cache.contains(id));
+    REQUIRE(cache.empty());
+}
+
+TEST_CASE("path_cache:invalidate", "[path_cache]") {
+    path_cache cache;
+    auto const across = cache.insert(
+        std::vector<point2i>{{0, 1}, {1, 1}, {2, 1}, {3, 1}});
+    auto const down = cache.insert(
+        std::vector<point2i>{{2, 0}, {2, 1}, {2, 2}, {2, 1}});
+    auto const elsewhere = cache.insert(
+        std::vector<point2i>{{5, 5}, {5, 6}});
+
+    // only the paths that cross a changed cell are dropped
+    auto const dropped = cache.invalidate(std::vector<point2i>{{2, 1}, {9, 9}});
+    REQUIRE(dropped == std::vector<path_cache::path_id>{across, down});
+    REQUIRE(not cache.contains(across));
+    REQUIRE(not cache.contains(down));
+    REQUIRE(cache.contains(elsewhere));
+
+    REQUIRE(cache.invalidate(std::vector<point2i>{{1, 1}}).empty());
+    REQUIRE(cache.invalidate(std::vector<point2i>{{5, 6}}).size() == 1);
+    REQUIRE(cache.empty());
+}
+
+TEST_CASE("packed_path", "[paths][packed]") {
+    using cardinal_direction = cardinal::direction_name;
+
+    // a spiral long enough to cross several checkpoints
+    std::vector<grid_point> cells{{0, 0}};
+    for (int leg = 1; leg < 30; ++leg) {
+        auto const step = direction_as<grid_point>(
+            static_cast<cardinal_direction>(leg % 4));
+        for (int i = 0; i < leg; ++i) {
+            auto const last = cells.back();
+            cells.push_back(grid_point{last.x + step.x, last.y + step.y});
+        }
+    }
+
+    packed_path<cardinal_direction> const path(cells);
+    REQUIRE(path.size() == cells.size());
+    REQUIRE(path.step_count() == cells.size() - 1);
+    REQUIRE(path.front() == cells.front());
+    REQUIRE(path.back() == cells.back());
+    REQUIRE(path.cells() == cells);
+    REQUIRE(path.steps().words().size() * 8 < cells.size());
+    for (std::size_t i = 0; i < cells.size(); i += 7) {
+        REQUIRE(path[i] == cells[i]);
+    }
+    REQUIRE(path[cells.size() - 1] == cells.back());
+
+    auto copy = path;
+    REQUIRE(copy == path);
+    REQUIRE(copy.push_back(cardinal::north));
+    REQUIRE(copy.back() == grid_point{cells.back().x, cells.back().y + 1});
+    REQUIRE(copy != path);
+}
+
+TEST_CASE("packed_path:encoding", "[paths][packed]") {
+    using pointed_hex_direction = pointed_hex::direction_name;
+    packed_path<pointed_hex_direction> path(point2i{2, 2});
+    REQUIRE(path.size() == 1);
+    REQUIRE(path.extend_to(point2i{3, 1}));
+    REQUIRE(path.extend_to(point2i{3, 2}));
+    REQUIRE(not path.extend_to(point2i{5, 2}));
+    REQUIRE(path.steps()[0] == pointed_hex::northeast);
+    REQUIRE(path.steps()[1] == pointed_hex::southeast);
+    REQUIRE(path.back() == grid_point{3, 2});
+
+    // encoding stops at the first jump
+    std::vector<point2i> const broken{{0, 0}, {1, 0}, {3, 0}, {4, 0}};
+    packed_path<pointed_hex_direction> const prefix(broken);
+    REQUIRE(prefix.size() == 2);
+
+    packed_path<pointed_hex_direction> none;
+    REQUIRE(none.empty());
+    REQUIRE(none.begin() == none.end());
+
+    // an empty path has no start to step from
+    REQUIRE(not none.push_back(pointed_hex::east));
+    REQUIRE(not none.extend_to(point2i{0, 0}));
+    REQUIRE(not none.extend_to(point2i{1, 0}));
+    REQUIRE(none.empty());
+    REQUIRE(none.size() == 0);
+    REQUIRE(none.step_count() == 0);
+}
@@ -0,0 +1,81 @@
+#include <catch2/catch.hpp>
+#include "spatula/range_queries.hpp"
+#include "grid_fixtures.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <execution>
+
+using namespace sp;
+using namespace test_grids;
+
+namespace test_range_queries {
+grid<int> rolling_terrain(std::size_t width, std::size_t height,
+                          std::uint32_t seed)
+{
+    return seeded_grid<int>(width, height, seed, [](std::uint32_t state) {
+        return static_cast<int>((state >> 12) % 10000) - 5000;
+    });
+}
+
+/** Find the least cell of a region by visiting every cell in it. */
+template<class Compare>
+std::optional<int> scan_every_cell(grid<int> const & cells, rect region,
+                                   Compare compare)
+{
+    std::optional<int> least;
+    for_each_cell_in(cells, region, [&](int cell) {
+        if (not least or compare(cell, *least)) { least = cell; }
+    });
+    return least;
+}
+}
+using namespace test_range_queries;
+
+TEST_CASE("extremum tables find the least cell of any rectangle",
+          "[range_queries]")
+{
+    auto const cells = rolling_terrain(45, 37, 4);
+    extremum_table<int> lowest;
+    lowest.rebuild(std::execution::par, cells);
+    extremum_table<int, std::greater<>> const highest(cells);
+    REQUIRE(lowest.width() == 45);
+    REQUIRE(lowest.height() == 37);
+
+    std::uint32_t seed = 1;
+    for (int i = 0; i < 3000; ++i) {
+        rect const region{next_random(seed, 55) - 5,
+                          next_random(seed, 47) - 5,
+                          next_random(seed, 40), next_random(seed, 40)};
+        REQUIRE(lowest.query(region) ==
+                scan_every_cell(cells, region, std::less<>{}));
+        REQUIRE(highest.query(region) ==
+                scan_every_cell(cells, region, std::greater<>{}));
+    }
+    REQUIRE(lowest.query(grid_point{6, 2}, grid_point{6, 2}) == cells(6, 2));
+    REQUIRE_FALSE(lowest.query(rect{50, 0, 4, 4}).has_value());
+    REQUIRE_FALSE(extremum_table<int>(grid<int>{}).query(rect{0, 0, 1, 1}));
+}
+
+TEST_CASE("blocked extremum tables agree with a scan", "[range_queries]")
+{
+    auto const cells = rolling_terrain(130, 97, 8);
+    blocked_extremum_table<int, std::greater<>> highest;
+    highest.rebuild(std::execution::par, cells);
+    blocked_extremum_table<int> const lowest(cells);
+
+    std::uint32_t seed = 6;
+    for (int i = 0; i < 3000; ++i) {
+        rect const region{next_random(seed, 150) - 10,
+                          next_random(seed, 117) - 10,
+                          next_random(seed, 90), next_random(seed, 90)};
+        REQUIRE(highest.query(region) ==
+                scan_every_cell(cells, region, std::greater<>{}));
+        REQUIRE(lowest.query(region) ==
+                scan_every_cell(cells, region, std::less<>{}));
+    }
+    REQUIRE(lowest.query(grid_point{0, 0}, grid_point{129, 96}) ==
+            scan_every_cell(cells, rect{0, 0, 130, 97}, std::less<>{}));
+    REQUIRE_FALSE(lowest.query(rect{3, 3, 0, 5}).has_value());
+}
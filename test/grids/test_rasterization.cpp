@@ -0,0 +1,159 @@
+#include <catch2/catch.hpp>
+#include "spatula/rasterization.hpp"
+#include "grid_fixtures.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+using namespace sp;
+using namespace test_grids;
+
+namespace test_rasterization {
+struct point { double x, y; };
+
+/** Twice the signed area of the triangle a, b, c. */
+long long cross(grid_point a, grid_point b, grid_point c)
+{
+    return static_cast<long long>(b.x - a.x) * (c.y - a.y) -
+           static_cast<long long>(b.y - a.y) * (c.x - a.x);
+}
+
+/** Determine if a point lies inside or on the edge of a convex polygon. */
+bool covers(std::vector<grid_point> const & corners, grid_point cell)
+{
+    bool any_left = false;
+    bool any_right = false;
+    for (std::size_t i = 0; i < corners.size(); ++i) {
+        auto const side = cross(corners[i],
+                                corners[(i + 1) % corners.size()], cell);
+        any_left = any_left or side > 0;
+        any_right = any_right or side < 0;
+    }
+    return not (any_left and any_right);
+}
+
+/** Rasterize a shape by testing the center of every cell. */
+template<class Covers>
+grid<int> test_every_cell(std::size_t width, std::size_t height,
+                          Covers covers)
+{
+    grid<int> cells(width, height, 0);
+    for (std::size_t y = 0; y < height; ++y) {
+        for (std::size_t x = 0; x < width; ++x) {
+            grid_point const cell{static_cast<int>(x), static_cast<int>(y)};
+            if (covers(cell)) { cells[cell] = 1; }
+        }
+    }
+    return cells;
+}
+}
+using namespace test_rasterization;
+
+TEST_CASE("disks cover the cells within their radius", "[rasterization]")
+{
+    for (int radius = 0; radius <= 9; ++radius) {
+        grid_point const center{7, 11};
+        grid<int> cells(20, 20, 0);
+        rasterize(cells, disk<grid_point>{center, radius}, 1);
+        auto const expected = test_every_cell(20, 20, [&](grid_point cell) {
+            auto const dx = cell.x - center.x;
+            auto const dy = cell.y - center.y;
+            return dx * dx + dy * dy <= radius * radius;
+        });
+        REQUIRE(cells == expected);
+    }
+    SECTION("with fractional centers and radii") {
+        point const center{6.25, 9.5};
+        grid<float> cells(16, 16, 0.f);
+        rasterize(cells, disk<point>{center, 4.3}, 2.f);
+        for (std::size_t y = 0; y < 16; ++y) {
+            for (std::size_t x = 0; x < 16; ++x) {
+                auto const dx = static_cast<double>(x) - center.x;
+                auto const dy = static_cast<double>(y) - center.y;
+                bool const inside = dx * dx + dy * dy <= 4.3 * 4.3;
+                REQUIRE(cells(static_cast<int>(x), static_cast<int>(y)) ==
+                        (inside ? 2.f : 0.f));
+            }
+        }
+    }
+}
+
+TEST_CASE("triangles cover the cells whose centers they contain",
+          "[rasterization]")
+{
+    std::uint32_t seed = 5;
+    for (int i = 0; i < 200; ++i) {
+        std::vector<grid_point> corners;
+        for (int k = 0; k < 3; ++k) {
+            corners.push_back({next_random(seed, 30) - 5,
+                               next_random(seed, 30) - 5});
+        }
+        // collinear corners would fool the test below
+        if (cross(corners[0], corners[1], corners[2]) == 0) { continue; }
+        grid<int> cells(20, 20, 0);
+        rasterize(cells, triangle<grid_point>{corners[0], corners[1],
+                                              corners[2]}, 1);
+        auto const expected = test_every_cell(20, 20, [&](grid_point cell) {
+            return covers(corners, cell);
+        });
+        REQUIRE(cells == expected);
+    }
+}
+
+TEST_CASE("convex polygons cover the cells whose centers they contain",
+          "[rasterization]")
+{
+    std::vector<grid_point> const octagon{{4, 0}, {10, 0}, {14, 4},
+                                          {14, 10}, {10, 14}, {4, 14},
+                                          {0, 10}, {0, 4}};
+    grid<int> cells(16, 16, 0);
+    rasterize(cells, convex_polygon{octagon}, 1);
+    auto const expected = test_every_cell(16, 16, [&](grid_point cell) {
+        return covers(octagon, cell);
+    });
+    REQUIRE(cells == expected);
+
+    SECTION("degenerate polygons cover points and segments") {
+        std::vector<grid_point> const segment{{2, 3}, {8, 3}};
+        grid<int> line(10, 10, 0);
+        rasterize(line, convex_polygon{segment}, 1);
+        int total = 0;
+        for (auto const cell : line) { total += cell; }
+        REQUIRE(total == 7);
+        std::vector<grid_point> const none;
+        rasterize(line, convex_polygon{none}, 5);
+        REQUIRE(line(5, 3) == 1);
+    }
+}
+
+TEST_CASE("shapes can be rasterized as spans alone", "[rasterization]")
+{
+    grid<int> const bounds(10, 10);
+    std::vector<grid_span> spans;
+    rasterize_spans(disk<grid_point>{{0, 1}, 2}, bounds,
+                    [&](grid_span span) { spans.push_back(span); });
+    std::vector<grid_span> const expected{{0, 0, 2}, {1, 0, 3}, {2, 0, 2},
+                                          {3, 0, 1}};
+    REQUIRE(spans == expected);
+
+    spans.clear();
+    rasterize_spans(disk<grid_point>{{-5, 20}, 3}, bounds,
+                    [&](grid_span span) { spans.push_back(span); });
+    REQUIRE(spans.empty());
+}
+
+TEST_CASE("bit grids are rasterized a word at a time", "[rasterization]")
+{
+    std::vector<grid_point> const wide{{3, 2}, {150, 8}, {20, 30}};
+    triangle<grid_point> const shape{wide[0], wide[1], wide[2]};
+    grid<int> cells(160, 32, 0);
+    bit_grid bits(160, 32);
+    rasterize(cells, shape, 1);
+    rasterize(bits, shape);
+    REQUIRE(bits == bit_grid(cells));
+
+    rasterize(cells, disk<grid_point>{{64, 15}, 10}, 0);
+    rasterize(bits, disk<grid_point>{{64, 15}, 10}, false);
+    REQUIRE(bits == bit_grid(cells));
+}
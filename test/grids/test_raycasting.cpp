@@ -0,0 +1,194 @@
+#include <catch2/catch.hpp>
+#include "spatula/raycasting.hpp"
+#include "grid_fixtures.hpp"
+
+#include <cstdint>
+#include <cmath>
+#include <array>
+#include <vector>
+#include <ranges>
+
+using namespace sp;
+using namespace test_grids;
+
+namespace test_raycasting {
+struct vec2 { double x, y; };
+struct vec3 { double x, y, z; };
+
+/** Every cell a ray visits, collected into a vector. */
+template<std::ranges::range Cells>
+auto collect(Cells && cells)
+{
+    std::vector<std::ranges::range_value_t<Cells>> visited;
+    for (auto const cell : cells) { visited.push_back(cell); }
+    return visited;
+}
+
+/** Determine if each cell shares a face with the cell before it. */
+bool face_connected(std::vector<grid_point> const & cells)
+{
+    for (std::size_t i = 1; i < cells.size(); ++i) {
+        auto const dx = std::abs(cells[i].x - cells[i - 1].x);
+        auto const dy = std::abs(cells[i].y - cells[i - 1].y);
+        if (dx + dy != 1) { return false; }
+    }
+    return true;
+}
+
+/** An arbitrary ray direction. */
+vec2 scattered_direction(std::uint32_t & state)
+{
+    auto const angle =
+        static_cast<double>(next_state(state) >> 8) / (1 << 24) * 6.283;
+    return vec2{std::cos(angle), std::sin(angle)};
+}
+}
+using namespace test_raycasting;
+
+static_assert(std::ranges::forward_range<cell_traversal_view<2>>);
+static_assert(std::ranges::view<cell_traversal_view<3>>);
+
+TEST_CASE("rays visit the cells they pass through in order", "[raycasting]")
+{
+    SECTION("along an axis") {
+        auto const cells = collect(traverse_cells(vec2{0.5, 0.5},
+                                                  vec2{1.0, 0.0}, 3.0));
+        REQUIRE(cells == std::vector<grid_point>{{0, 0}, {1, 0}, {2, 0},
+                                                 {3, 0}});
+    }
+    SECTION("along a shallow slope") {
+        auto const cells = collect(traverse_cells(vec2{0.5, 0.5},
+                                                  vec2{3.0, 1.0}, 1.0));
+        REQUIRE(cells == std::vector<grid_point>{{0, 0}, {1, 0}, {2, 0},
+                                                 {2, 1}, {3, 1}});
+    }
+    SECTION("backwards") {
+        auto const cells = collect(traverse_cells(vec2{-0.5, 2.5},
+                                                  vec2{-1.0, -1.0}, 1.9));
+        REQUIRE(cells == std::vector<grid_point>{{-1, 2}, {-2, 2}, {-2, 1},
+                                                 {-3, 1}, {-3, 0}});
+    }
+    SECTION("with the distance to each cell") {
+        auto const view = traverse_cells(vec2{0.25, 0.5}, vec2{1.0, 0.0},
+                                         2.0);
+        auto it = view.begin();
+        REQUIRE(it.distance() == 0.0);
+        ++it;
+        REQUIRE(it.distance() == Approx(0.75));
+        ++it;
+        REQUIRE(it.distance() == Approx(1.75));
+        ++it;
+        REQUIRE(it == view.end());
+    }
+    SECTION("rays with no length visit nothing") {
+        REQUIRE(collect(traverse_cells(vec2{0.5, 0.5}, vec2{1.0, 0.0},
+                                       0.0)).empty());
+    }
+}
+
+TEST_CASE("rays can be clipped to a grid", "[raycasting]")
+{
+    grid<int> const cells(6, 4, 0);
+    SECTION("rays starting outside begin at the first cell they enter") {
+        auto const visited = collect(traverse_cells(vec2{-2.5, 1.5},
+                                                    vec2{1.0, 0.0}, cells));
+        REQUIRE(visited.size() == 6);
+        REQUIRE(visited.front() == grid_point{0, 1});
+        REQUIRE(visited.back() == grid_point{5, 1});
+    }
+    SECTION("rays stop at the far edge") {
+        auto const visited = collect(traverse_cells(vec2{0.5, 0.5},
+                                                    vec2{1.0, 1.0}, cells));
+        REQUIRE(visited.back().y == 3);
+        REQUIRE(face_connected(visited));
+    }
+    SECTION("rays that miss visit nothing") {
+        REQUIRE(collect(traverse_cells(vec2{-1.0, 5.0}, vec2{1.0, 0.0},
+                                       cells)).empty());
+        REQUIRE(collect(traverse_cells(vec2{-1.0, -1.0}, vec2{-1.0, 1.0},
+                                       cells)).empty());
+    }
+    SECTION("every cell visited lies within the grid") {
+        std::uint32_t state = 5;
+        for (int i = 0; i < 200; ++i) {
+            auto const direction = scattered_direction(state);
+            auto const visited = collect(traverse_cells(
+                vec2{3.0 - 8.0 * direction.x, 2.0 - 8.0 * direction.y},
+                direction, cells));
+            REQUIRE_FALSE(visited.empty());
+            REQUIRE(face_connected(visited));
+            for (auto const cell : visited) {
+                REQUIRE(cells.contains(cell));
+            }
+        }
+    }
+}
+
+TEST_CASE("rays can pass through voxels", "[raycasting]")
+{
+    auto const voxels = collect(traverse_cells(vec3{0.5, 0.5, 0.5},
+                                               vec3{1.0, 2.0, 4.0},
+                                               voxel_point{8, 8, 8}));
+    REQUIRE(voxels.front() == voxel_point{0, 0, 0});
+    REQUIRE(voxels.back().z == 7);
+    for (std::size_t i = 1; i < voxels.size(); ++i) {
+        auto const dx = std::abs(voxels[i].x - voxels[i - 1].x);
+        auto const dy = std::abs(voxels[i].y - voxels[i - 1].y);
+        auto const dz = std::abs(voxels[i].z - voxels[i - 1].z);
+        REQUIRE(dx + dy + dz == 1);
+    }
+    REQUIRE(voxels.size() == 14);
+}
+
+TEST_CASE("ray packets match rays stepped one at a time", "[raycasting]")
+{
+    grid<int> const cells(40, 30, 0);
+    std::uint32_t state = 17;
+    for (int round = 0; round < 50; ++round) {
+        std::array<vec2, 8> origins, directions;
+        for (std::size_t lane = 0; lane < 8; ++lane) {
+            origins[lane] = vec2{20.3, 15.6};
+            directions[lane] = scattered_direction(state);
+        }
+        // stop the third lane short, so lanes finish at different times
+        ray_packet packet(origins, directions, std::array<int, 2>{40, 30});
+        std::array<std::vector<grid_point>, 8> visited;
+        traverse_packet(packet, [&](std::size_t lane, grid_point cell) {
+            visited[lane].push_back(cell);
+            return lane != 2 or visited[lane].size() < 5;
+        });
+        for (std::size_t lane = 0; lane < 8; ++lane) {
+            auto expected = collect(traverse_cells(origins[lane],
+                                                   directions[lane], cells));
+            if (lane == 2) { expected.resize(5); }
+            REQUIRE(visited[lane] == expected);
+        }
+    }
+}
+
+TEST_CASE("ray packets report where each lane is", "[raycasting]")
+{
+    std::array<vec3, 4> const origins{{{0.5, 0.5, 0.5}, {0.5, 0.5, 0.5},
+                                       {0.5, 0.5, 0.5}, {0.5, 0.5, 0.5}}};
+    std::array<vec3, 4> const directions{{{1.0, 0.0, 0.0}, {0.0, 1.0, 0.0},
+                                          {0.0, 0.0, 1.0}, {0.0, 0.0, -1.0}}};
+    ray_packet packet(origins, directions, 2.0);
+    REQUIRE(packet.any_active());
+    packet.advance();
+    REQUIRE(packet.cell(0) == voxel_point{1, 0, 0});
+    REQUIRE(packet.cell(1) == voxel_point{0, 1, 0});
+    REQUIRE(packet.cell(2) == voxel_point{0, 0, 1});
+    REQUIRE(packet.cell(3) == voxel_point{0, 0, -1});
+    REQUIRE(packet.distance(3) == Approx(0.5));
+    packet.advance();
+    REQUIRE(packet.active(0));
+    packet.advance();
+    REQUIRE_FALSE(packet.any_active());
+
+    // without a maximum distance the rays never stop on their own
+    ray_packet unbounded(origins, directions);
+    static_assert(std::same_as<decltype(unbounded), ray_packet<4, 3>>);
+    for (int step = 0; step < 100; ++step) { unbounded.advance(); }
+    REQUIRE(unbounded.active(0));
+    REQUIRE(unbounded.cell(0) == voxel_point{100, 0, 0});
+}
@@ -0,0 +1,136 @@
+#include <catch2/catch.hpp>
+#include "spatula/stencils.hpp"
+#include "grid_fixtures.hpp"
+
+#include <cstdint>
+#include <array>
+#include <numeric>
+#include <execution>
+
+using namespace sp;
+using namespace test_grids;
+
+namespace test_stencils {
+using cardinal_direction = cardinal::direction_name;
+using octile_direction = octile::direction_name;
+using flat_hex_direction = flat_hex::direction_name;
+
+/** A grid of arbitrary values. */
+grid<int> scattered(std::size_t width, std::size_t height)
+{
+    return seeded_grid<int>(width, height, 99, [](std::uint32_t state) {
+        return static_cast<int>(state >> 22);
+    });
+}
+
+/** Mixes a cell with its neighbours in an order-dependent way. */
+struct mix {
+    template<std::size_t N>
+    int operator()(int center, std::array<int, N> const & around) const
+    {
+        int total = center * 3;
+        for (std::size_t i = 0; i < N; ++i) {
+            total = (total * 7 + around[i]) % 100003;
+        }
+        return total;
+    }
+};
+
+/** Apply a kernel one cell at a time. */
+template<ranged_enum Enum, class Kernel>
+grid<int> slow_apply(grid<int> const & cells, Kernel kernel)
+{
+    grid<int> next(cells.width(), cells.height());
+    for (int y = 0; y < static_cast<int>(cells.height()); ++y) {
+        for (int x = 0; x < static_cast<int>(cells.width()); ++x) {
+            std::array<int, enum_size_v<Enum>> around;
+            for (std::size_t i = 0; i < around.size(); ++i) {
+                auto const step =
+                    direction_as<grid_point>(static_cast<Enum>(i));
+                grid_point const neighbour{x + step.x, y + step.y};
+                around[i] = cells.contains(neighbour) ? cells[neighbour]
+                                                      : cells(x, y);
+            }
+            next(x, y) = kernel(cells(x, y), around);
+        }
+    }
+    return next;
+}
+
+template<adjacent_direction Enum>
+void check_against_slow_apply()
+{
+    using size = std::pair<std::size_t, std::size_t>;
+    for (auto const & [width, height] : {size{150, 90}, size{1, 1},
+                                         size{3, 200}, size{64, 64},
+                                         size{130, 2}, size{300, 40}}) {
+        auto const cells = scattered(width, height);
+        auto const expected = slow_apply<Enum>(cells, mix{});
+
+        grid<int> single;
+        stencil_apply<Enum>(std::execution::par, cells, single, mix{});
+        REQUIRE(single == expected);
+
+        for (std::size_t const iterations : {1, 3, 4, 6, 9}) {
+            auto slow = cells;
+            for (std::size_t i = 0; i < iterations; ++i) {
+                slow = slow_apply<Enum>(slow, mix{});
+            }
+            auto fast = cells;
+            stencil_apply<Enum>(std::execution::par, fast, mix{},
+                                iterations);
+            REQUIRE(fast == slow);
+        }
+    }
+}
+}
+using namespace test_stencils;
+
+TEST_CASE("stencils match a cell by cell sweep", "[stencils]")
+{
+    SECTION("cardinal neighbours") {
+        check_against_slow_apply<cardinal_direction>();
+    }
+    SECTION("octile neighbours") {
+        check_against_slow_apply<octile_direction>();
+    }
+    SECTION("hex neighbours") {
+        check_against_slow_apply<flat_hex_direction>();
+    }
+}
+
+TEST_CASE("stencils can change the type of each cell", "[stencils]")
+{
+    grid<int> heat(5, 5, 0);
+    heat(2, 2) = 40;
+    grid<float> average;
+    stencil_apply<cardinal_direction>(
+        heat, average, [](int center, std::array<int, 4> const & around) {
+            auto const total = std::accumulate(around.begin(), around.end(),
+                                               center);
+            return static_cast<float>(total) / 5.0f;
+        });
+    REQUIRE(average.width() == 5);
+    REQUIRE(average(2, 2) == Approx(8.0f));
+    REQUIRE(average(2, 3) == Approx(8.0f));
+    REQUIRE(average(3, 3) == Approx(0.0f));
+}
+
+TEST_CASE("diffusion conserves heat with no flux at the edges", "[stencils]")
+{
+    grid<double> heat(40, 30, 0.0);
+    heat(0, 0) = 1000.0;
+    heat(39, 29) = 1000.0;
+    auto const diffuse = [](double center,
+                            std::array<double, 4> const & around) {
+        double flow = 0.0;
+        for (double const neighbour : around) { flow += neighbour - center; }
+        return center + flow / 8.0;
+    };
+    stencil_apply<cardinal_direction>(std::execution::par, heat, diffuse, 7);
+    REQUIRE(heat(0, 0) < 1000.0);
+    REQUIRE(heat(1, 0) > 0.0);
+    REQUIRE(heat(20, 15) == 0.0);
+    auto const total = std::accumulate(heat.begin(), heat.end(), 0.0);
+    REQUIRE(total == Approx(2000.0));
+}
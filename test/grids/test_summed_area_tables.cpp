@@ -0,0 +1,95 @@
+#include <catch2/catch.hpp>
+#include "spatula/summed_area_tables.hpp"
+#include "grid_fixtures.hpp"
+
+#include <cstdint>
+#include <execution>
+
+using namespace sp;
+using namespace test_grids;
+
+namespace test_summed_area_tables {
+grid<std::uint8_t> scattered_cells(std::size_t width, std::size_t height,
+                                   std::uint32_t seed)
+{
+    return seeded_grid<std::uint8_t>(width, height, seed,
+                                     [](std::uint32_t state) {
+        return static_cast<std::uint8_t>((state >> 16) % 7);
+    });
+}
+
+/** Sum a region by visiting every cell in it. */
+std::int64_t sum_every_cell(grid<std::uint8_t> const & cells, rect region)
+{
+    std::int64_t total = 0;
+    for_each_cell_in(cells, region, [&](std::uint8_t cell) { total += cell; });
+    return total;
+}
+}
+using namespace test_summed_area_tables;
+
+static_assert(grid_rect<rect>);
+static_assert(not grid_rect<grid_point>);
+
+TEST_CASE("summed area tables sum any rectangle", "[summed_area_tables]")
+{
+    auto const cells = scattered_cells(150, 140, 3);
+    summed_area_table<std::uint8_t> table;
+    table.rebuild(std::execution::par, cells);
+    REQUIRE(table.width() == 150);
+    REQUIRE(table.height() == 140);
+
+    std::uint32_t seed = 8;
+    for (int i = 0; i < 2000; ++i) {
+        rect const region{next_random(seed, 170) - 10,
+                          next_random(seed, 160) - 10,
+                          next_random(seed, 80), next_random(seed, 80)};
+        REQUIRE(table.sum(region) == sum_every_cell(cells, region));
+    }
+    REQUIRE(table.sum(grid_point{0, 0}, grid_point{149, 139}) ==
+            sum_every_cell(cells, rect{0, 0, 150, 140}));
+    REQUIRE(table.sum(grid_point{3, 4}, grid_point{3, 4}) == cells(3, 4));
+    REQUIRE(table.sum(grid_point{5, 5}, grid_point{4, 9}) == 0);
+}
+
+TEST_CASE("summed area tables count and average cells",
+          "[summed_area_tables]")
+{
+    grid<float> cells(10, 10, 0.5f);
+    for (int x = 0; x < 10; ++x) { cells(x, 0) = 2.5f; }
+    summed_area_table const table(cells);
+    REQUIRE(table.sum(rect{0, 0, 10, 10}) == Approx(70.0));
+    REQUIRE(table.count(rect{-5, 8, 10, 10}) == 10);
+    REQUIRE(table.count(rect{20, 0, 3, 3}) == 0);
+    REQUIRE(table.mean(rect{0, 0, 4, 2}).value() == Approx(1.5));
+    REQUIRE_FALSE(table.mean(rect{0, -9, 4, 2}).has_value());
+}
+
+TEST_CASE("summed area tables update only the bands that change",
+          "[summed_area_tables]")
+{
+    auto cells = scattered_cells(90, 300, 12);
+    summed_area_table table(cells);
+    std::uint32_t seed = 2;
+    for (int i = 0; i < 20; ++i) {
+        rect const changed{next_random(seed, 80), next_random(seed, 280),
+                           next_random(seed, 10) + 1,
+                           next_random(seed, 20) + 1};
+        for (int y = changed.y; y < changed.y + changed.h; ++y) {
+            for (int x = changed.x; x < changed.x + changed.w; ++x) {
+                cells(x, y) = static_cast<std::uint8_t>(next_random(seed, 9));
+            }
+        }
+        table.update(cells, changed);
+        REQUIRE(table.sum(rect{0, 0, 90, 300}) ==
+                sum_every_cell(cells, rect{0, 0, 90, 300}));
+        rect const region{next_random(seed, 90), next_random(seed, 300),
+                          next_random(seed, 40), next_random(seed, 200)};
+        REQUIRE(table.sum(region) == sum_every_cell(cells, region));
+    }
+    summed_area_table const rebuilt(cells);
+    for (int y = 0; y < 300; y += 7) {
+        REQUIRE(table.sum(rect{3, y, 50, 13}) ==
+                rebuilt.sum(rect{3, y, 50, 13}));
+    }
+}
@@ -0,0 +1,134 @@
+#include <catch2/catch.hpp>
+#include "spatula/symmetry.hpp"
+
+#include <cstdint>
+#include <set>
+
+using namespace sp;
+
+namespace test_symmetry {
+using cardinal_direction = cardinal::direction_name;
+using octile_direction = octile::direction_name;
+using flat_hex_direction = flat_hex::direction_name;
+using pointed_hex_direction = pointed_hex::direction_name;
+
+/** Check that offsets and directions transform the same way, and that each
+ * symmetry permutes the directions. */
+template<symmetric_direction Enum>
+void check_group()
+{
+    auto const offsets = directions_as<grid_point, Enum>();
+    std::set<std::pair<int, bool>> seen;
+    for (auto const symmetry : symmetries_v<Enum>) {
+        seen.insert({symmetry.turns, symmetry.mirrored});
+        std::set<int> images;
+        for (std::size_t i = 0; i < offsets.size(); ++i) {
+            auto const dir = static_cast<Enum>(i);
+            auto const image = transform_direction(dir, symmetry);
+            images.insert(image);
+            REQUIRE(transform_offset<Enum>(offsets[i], symmetry) ==
+                    offsets[image]);
+        }
+        REQUIRE(images.size() == offsets.size());
+    }
+    REQUIRE(seen.size() == symmetry_order_v<Enum>);
+}
+
+grid<std::uint8_t> l_shape()
+{
+    // ##.
+    // #..
+    // #..
+    grid<std::uint8_t> patch(3, 3, 0);
+    patch(0, 0) = patch(0, 1) = patch(0, 2) = patch(1, 2) = 1;
+    return patch;
+}
+}
+using namespace test_symmetry;
+
+TEST_CASE("dihedral_symmetry:directions", "[symmetry]") {
+    STATIC_REQUIRE(symmetry_order_v<cardinal_direction> == 8);
+    STATIC_REQUIRE(symmetry_order_v<pointed_hex_direction> == 12);
+    STATIC_REQUIRE(transform_direction(cardinal::east,
+                                       lattice_symmetry{0, true}) ==
+                   cardinal::west);
+    STATIC_REQUIRE(transform_direction(octile::northeast,
+                                       lattice_symmetry{1, false}) ==
+                   octile::southeast);
+    STATIC_REQUIRE(transform_direction(pointed_hex::east,
+                                       lattice_symmetry{-1, true}) ==
+                   pointed_hex::southwest);
+
+    check_group<cardinal_direction>();
+    check_group<octile_direction>();
+    check_group<flat_hex_direction>();
+    check_group<pointed_hex_direction>();
+}
+
+TEST_CASE("transform_patch:grid", "[symmetry]") {
+    auto const patch = l_shape();
+    auto const turned = transform_patch<cardinal_direction>(
+        patch, lattice_symmetry{1, false});
+    // a clockwise turn with north along +y takes (0, 2) to (2, 2)
+    REQUIRE(turned(2, 2) == 1);
+    REQUIRE(turned(0, 2) == 1);
+    REQUIRE(turned(1, 2) == 1);
+    REQUIRE(turned(2, 1) == 1);
+
+    auto const mirrored = transform_patch<cardinal_direction>(
+        patch, lattice_symmetry{0, true});
+    REQUIRE(mirrored(2, 0) == 1);
+    REQUIRE(mirrored(1, 2) == 1);
+    REQUIRE(mirrored(0, 0) == 0);
+
+    grid<int> wide(4, 2);
+    for (int i = 0; i < 8; ++i) { wide[static_cast<std::size_t>(i)] = i; }
+    auto const tall = transform_patch<cardinal_direction>(
+        wide, lattice_symmetry{1, false});
+    REQUIRE(tall.width() == 2);
+    REQUIRE(tall.height() == 4);
+    auto const back = transform_patch<cardinal_direction>(
+        tall, lattice_symmetry{-1, false});
+    REQUIRE(back == wide);
+}
+
+TEST_CASE("canonicalize", "[symmetry]") {
+    auto const patch = l_shape();
+    auto const canonical = canonicalize<cardinal_direction>(patch);
+    auto const hash = symmetry_hash<cardinal_direction>(patch);
+
+    for (auto const symmetry : symmetries_v<cardinal_direction>) {
+        auto const image = transform_patch<cardinal_direction>(patch, symmetry);
+        auto const other = canonicalize<cardinal_direction>(image);
+        REQUIRE(other.patch == canonical.patch);
+        REQUIRE(transform_patch<cardinal_direction>(image, other.symmetry) ==
+                canonical.patch);
+        REQUIRE(symmetry_hash<cardinal_direction>(image) == hash);
+    }
+
+    auto different = patch;
+    different(2, 0) = 1;
+    REQUIRE(symmetry_hash<cardinal_direction>(different) != hash);
+}
+
+TEST_CASE("canonicalize:hex", "[symmetry][hex]") {
+    hexagon_map<int, pointed_hex_direction> patch(2, 0);
+    patch(1, 0) = 3;
+    patch(1, -1) = 5;
+    patch(-2, 1) = 7;
+    auto const canonical = canonicalize<pointed_hex_direction>(patch);
+
+    std::set<std::size_t> hashes;
+    for (auto const symmetry : symmetries_v<pointed_hex_direction>) {
+        auto const image = transform_patch(patch, symmetry);
+        REQUIRE(canonicalize<pointed_hex_direction>(image).patch ==
+                canonical.patch);
+        hashes.insert(symmetry_hash<pointed_hex_direction>(image));
+    }
+    REQUIRE(hashes.size() == 1);
+
+    // a turn moves (1, 0) onto the next pointed hex direction
+    auto const turned = transform_patch(patch, lattice_symmetry{1, false});
+    REQUIRE(turned(0, 1) == 3);
+    REQUIRE(turned(1, 0) == 5);
+}
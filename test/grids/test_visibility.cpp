@@ -0,0 +1,184 @@
+#include <catch2/catch.hpp>
+#include "spatula/visibility.hpp"
+#include "grid_fixtures.hpp"
+
+#include <cstdint>
+#include <vector>
+#include <execution>
+
+using namespace sp;
+using namespace test_grids;
+
+namespace test_visibility {
+using cardinal_direction = cardinal::direction_name;
+using octile_direction = octile::direction_name;
+using pointed_hex_direction = pointed_hex::direction_name;
+
+/** A map where roughly one cell in every few is opaque. */
+bit_grid scattered_walls(std::size_t width, std::size_t height,
+                         std::uint32_t seed)
+{
+    auto const cells = seeded_grid<int>(width, height, seed,
+                                        [](std::uint32_t state) {
+        return static_cast<int>(state >> 24) % 4;
+    });
+    return bit_grid(cells, [](int cell) { return cell == 0; });
+}
+
+/** The cells visible from a single viewpoint. */
+template<sight_direction Enum>
+bit_grid view_from(bit_grid const & opaque, grid_point origin, int radius)
+{
+    bit_grid visible(opaque.width(), opaque.height());
+    field_of_view<Enum>(opaque, origin, radius, visible);
+    return visible;
+}
+}
+using namespace test_visibility;
+
+TEST_CASE("open square grids see a circle", "[visibility]")
+{
+    bit_grid const opaque(41, 41);
+    auto const visible = view_from<octile_direction>(opaque, {20, 20}, 6);
+    std::size_t expected = 0;
+    for (int y = 0; y < 41; ++y) {
+        for (int x = 0; x < 41; ++x) {
+            auto const dx = x - 20;
+            auto const dy = y - 20;
+            bool const in_range = dx * dx + dy * dy <= 36;
+            expected += in_range;
+            REQUIRE(visible.test(x, y) == in_range);
+        }
+    }
+    REQUIRE(visible.count() == expected);
+}
+
+TEST_CASE("walls cast shadows but can be seen", "[visibility]")
+{
+    bit_grid opaque(20, 20);
+    for (int y = 0; y < 20; ++y) { opaque.set(10, y); }
+    auto const visible = view_from<cardinal_direction>(opaque, {5, 5}, 30);
+    REQUIRE(visible.test(9, 5));
+    REQUIRE(visible.test(10, 5));
+    REQUIRE(visible.test(10, 0));
+    REQUIRE_FALSE(visible.test(11, 5));
+    REQUIRE_FALSE(visible.test(19, 19));
+    REQUIRE(visible.test(0, 19));
+}
+
+TEST_CASE("clear cells see each other symmetrically", "[visibility]")
+{
+    auto const opaque = scattered_walls(30, 24, 7);
+    std::vector<bit_grid> views;
+    for (int y = 0; y < 24; ++y) {
+        for (int x = 0; x < 30; ++x) {
+            views.push_back(view_from<octile_direction>(opaque, {x, y}, 100));
+        }
+    }
+    for (int a = 0; a < 30 * 24; ++a) {
+        grid_point const from{a % 30, a / 30};
+        if (opaque.test(from)) { continue; }
+        for (int b = 0; b < 30 * 24; ++b) {
+            grid_point const to{b % 30, b / 30};
+            if (opaque.test(to)) { continue; }
+            REQUIRE(views[static_cast<std::size_t>(a)].test(to) ==
+                    views[static_cast<std::size_t>(b)].test(from));
+        }
+    }
+}
+
+TEST_CASE("hex grids see every hex in range", "[visibility]")
+{
+    bit_grid opaque(21, 21);
+    SECTION("with nothing in the way") {
+        auto const visible = view_from<pointed_hex_direction>(opaque,
+                                                              {10, 10}, 4);
+        REQUIRE(visible.count() == 61);
+        REQUIRE(visible.test(14, 10));
+        REQUIRE(visible.test(14, 6));
+        REQUIRE_FALSE(visible.test(15, 10));
+        REQUIRE_FALSE(visible.test(14, 14));
+    }
+    SECTION("from inside a ring of walls") {
+        for (int r = 0; r < 21; ++r) {
+            for (int q = 0; q < 21; ++q) {
+                if (hex_distance(grid_point{q, r}, grid_point{10, 10}) == 3) {
+                    opaque.set(q, r);
+                }
+            }
+        }
+        auto const visible = view_from<flat_hex::direction_name>(
+            opaque, {10, 10}, 10);
+        REQUIRE(visible.count() == 37);
+    }
+}
+
+TEST_CASE("many viewpoints gather into one field of view", "[visibility]")
+{
+    auto const opaque = scattered_walls(70, 50, 3);
+    std::vector<viewpoint> viewpoints;
+    bit_grid expected(70, 50);
+    for (int i = 0; i < 40; ++i) {
+        viewpoint const eye{{(i * 37) % 70, (i * 11) % 50}, 3 + i % 5};
+        viewpoints.push_back(eye);
+        field_of_view<cardinal_direction>(opaque, eye.cell, eye.radius,
+                                          expected);
+    }
+    bit_grid visible(70, 50);
+    field_of_view<cardinal_direction>(std::execution::par, opaque,
+                                      viewpoints, visible);
+    REQUIRE(visible == expected);
+
+    bit_grid serial(70, 50);
+    field_of_view<cardinal_direction>(opaque, viewpoints, serial);
+    REQUIRE(serial == expected);
+
+    // a bitmap of the wrong size is resized to match rather than overrun
+    bit_grid small(10, 10, true);
+    field_of_view<cardinal_direction>(std::execution::par, opaque,
+                                      viewpoints, small);
+    REQUIRE(small.width() == 70);
+    REQUIRE(small.height() == 50);
+    REQUIRE(small == expected);
+}
+
+TEST_CASE("lines of sight are blocked by opaque cells", "[visibility]")
+{
+    bit_grid opaque(10, 10);
+    opaque.set(4, 4);
+    REQUIRE(line_of_sight<octile_direction>(opaque, {0, 0}, {9, 0}));
+    REQUIRE_FALSE(line_of_sight<octile_direction>(opaque, {2, 2}, {6, 6}));
+    REQUIRE_FALSE(line_of_sight<octile_direction>(opaque, {6, 6}, {2, 2}));
+    REQUIRE(line_of_sight<octile_direction>(opaque, {2, 2}, {4, 4}));
+    REQUIRE(line_of_sight<octile_direction>(opaque, {4, 4}, {4, 4}));
+    SECTION("lines through a corner pass between diagonal walls") {
+        opaque.set(6, 5);
+        opaque.set(5, 6);
+        REQUIRE(line_of_sight<octile_direction>(opaque, {5, 5}, {7, 7}));
+    }
+    SECTION("on hex grids") {
+        REQUIRE_FALSE(line_of_sight<pointed_hex_direction>(opaque, {4, 2},
+                                                           {4, 7}));
+        REQUIRE(line_of_sight<pointed_hex_direction>(opaque, {5, 2},
+                                                     {5, 7}));
+    }
+}
+
+TEST_CASE("lines of sight can be checked in batches", "[visibility]")
+{
+    auto const opaque = scattered_walls(40, 40, 11);
+    std::vector<sight_line> lines;
+    for (int i = 0; i < 150; ++i) {
+        lines.push_back(sight_line{{(i * 7) % 40, (i * 13) % 40},
+                                   {(i * 29) % 40, (i * 3) % 40}});
+    }
+    std::vector<bit_grid::word_type> clear(3, ~bit_grid::word_type{0});
+    line_of_sight<octile_direction>(std::execution::par, opaque, lines,
+                                    clear);
+    for (std::size_t i = 0; i < lines.size(); ++i) {
+        bool const expected = line_of_sight<octile_direction>(
+            opaque, lines[i].from, lines[i].to);
+        REQUIRE(((clear[i / 64] >> (i % 64)) & 1u) == expected);
+    }
+    REQUIRE((clear[2] >> 22) == 0);
+}